@@ -0,0 +1,43 @@
+﻿#include "AllocationCounter.h"
+
+#ifndef MASTERINGEQ_COUNT_ALLOCATIONS
+ #define MASTERINGEQ_COUNT_ALLOCATIONS 0
+#endif
+
+#if MASTERINGEQ_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::uint64_t> allocationCount{ 0 };
+
+    void* countedAlloc(std::size_t size)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        if (void* p = std::malloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+bool AllocationCounter::isEnabled() noexcept { return true; }
+std::uint64_t AllocationCounter::getCount() noexcept { return allocationCount.load(std::memory_order_relaxed); }
+
+#else
+
+bool AllocationCounter::isEnabled() noexcept { return false; }
+std::uint64_t AllocationCounter::getCount() noexcept { return 0; }
+
+#endif
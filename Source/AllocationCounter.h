@@ -0,0 +1,18 @@
+﻿#pragma once
+
+#include <cstdint>
+
+//==============================================================================
+// Prozessweiter Zähler für Heap-Allokationen
+//
+// Nur aktiv mit MASTERINGEQ_COUNT_ALLOCATIONS=1 (CMake-Option, Standard aus):
+// dann werden die globalen operator new/delete ersetzt. Im Plugin betrifft
+// das den ganzen Host-Prozess, daher nur für Profiling-Builds gedacht.
+namespace AllocationCounter
+{
+    // true wenn die Zählung einkompiliert ist
+    bool isEnabled() noexcept;
+
+    // Anzahl aller bisherigen Allokationen (alle Threads), 0 wenn deaktiviert
+    std::uint64_t getCount() noexcept;
+}
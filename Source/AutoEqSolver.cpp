@@ -0,0 +1,781 @@
+﻿#include "AutoEqSolver.h"
+#include "CurveMath.h"
+#include "FastMath.h"
+#include "JobSystem.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <complex>
+
+namespace
+{
+    using namespace CurveMath;
+    using AutoEqSolver::computeEQResponseDb;
+
+    // Löser für symmetrisches, positiv definites LGS (Cholesky) – n ist klein (31)
+    static bool solveSPD_Cholesky(std::vector<double>& A, std::vector<double>& b, int n)
+    {
+        // A ist n*n in row-major
+        // Cholesky: A = L*L^T (wir speichern L in A)
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j <= i; ++j)
+            {
+                double sum = A[(size_t)i * n + j];
+
+                for (int k = 0; k < j; ++k)
+                    sum -= A[(size_t)i * n + k] * A[(size_t)j * n + k];
+
+                if (i == j)
+                {
+                    if (sum <= 1.0e-12)
+                        return false;
+
+                    A[(size_t)i * n + j] = std::sqrt(sum);
+                }
+                else
+                {
+                    A[(size_t)i * n + j] = sum / A[(size_t)j * n + j];
+                }
+            }
+
+            // oberen Teil nicht nötig
+            for (int j = i + 1; j < n; ++j)
+                A[(size_t)i * n + j] = 0.0;
+        }
+
+        // Forward solve: L*y = b
+        std::vector<double> y((size_t)n, 0.0);
+        for (int i = 0; i < n; ++i)
+        {
+            double sum = b[(size_t)i];
+            for (int k = 0; k < i; ++k)
+                sum -= A[(size_t)i * n + k] * y[(size_t)k];
+
+            y[(size_t)i] = sum / A[(size_t)i * n + i];
+        }
+
+        // Backward solve: L^T*x = y  (x wird in b zurückgeschrieben)
+        for (int i = n - 1; i >= 0; --i)
+        {
+            double sum = y[(size_t)i];
+            for (int k = i + 1; k < n; ++k)
+                sum -= A[(size_t)k * n + i] * b[(size_t)k];
+
+            b[(size_t)i] = sum / A[(size_t)i * n + i];
+        }
+
+        return true;
+    }
+
+    static double computeLossWithSmoothness(const std::vector<float>& freqs,
+        const std::vector<float>& targetDb,
+        const std::array<float, 31>& gainsDb,
+        const std::array<float, 31>& Qs,
+        float sampleRate,
+        const std::vector<float>& eqFreqs,
+        double lambdaSmooth,
+        double lambdaQ,
+        const std::array<float, 31>& Q0)
+    {
+        std::vector<float> respDb;
+        computeEQResponseDb(freqs, gainsDb, Qs, sampleRate, respDb, eqFreqs);
+
+        // 1) Fit error
+        double fit = 0.0;
+        for (size_t k = 0; k < freqs.size(); ++k)
+        {
+            const double e = (double)respDb[k] - (double)targetDb[k];
+            fit += e * e;
+        }
+
+        // 2) Smoothness (2nd derivative penalty) -> reduziert "Kammfilter/Ripple"
+        double smooth = 0.0;
+        if (respDb.size() >= 3)
+        {
+            for (size_t k = 1; k + 1 < respDb.size(); ++k)
+            {
+                const double d2 = (double)respDb[k + 1] - 2.0 * (double)respDb[k] + (double)respDb[k - 1];
+                smooth += d2 * d2;
+            }
+        }
+
+        // 3) Q regularization (log-domain, damit Multiplikativänderungen sinnvoll sind)
+        double qpen = 0.0;
+        for (int i = 0; i < 31; ++i)
+        {
+            const double q = juce::jmax(0.3, (double)Qs[(size_t)i]);
+            const double q0 = juce::jmax(0.3, (double)Q0[(size_t)i]);
+            const double t = std::log(q / q0);
+            qpen += t * t;
+        }
+
+        return fit + lambdaSmooth * smooth + lambdaQ * qpen;
+    }
+
+    static std::array<float, 31> fitQsStage2_Coordinate(const std::vector<float>& freqs,
+        const std::vector<float>& targetDb,
+        const std::array<float, 31>& gainsDbFixed,
+        std::array<float, 31> Qs,
+        float sampleRate,
+        const std::vector<float>& eqFreqs,
+        const AutoEqSolver::ShouldCancel& shouldCancel)
+    {
+        // Defaults / Gewichte: praxisnah starten
+        const double lambdaSmooth = 0.25;  // höher => glatter, weniger Ripple
+        const double lambdaQ = 0.05;  // höher => Q bleibt näher am Default
+
+        std::array<float, 31> Q0 = Qs;      // "aktueller" Ausgangspunkt als Default (oder 4.32 überall)
+
+        // Kandidatenfaktoren (multiplikativ)
+        const float factors[] = { 0.70f, 0.85f, 1.0f, 1.18f, 1.35f };
+
+        double bestLoss = computeLossWithSmoothness(freqs, targetDb, gainsDbFixed, Qs, sampleRate, eqFreqs,
+            lambdaSmooth, lambdaQ, Q0);
+
+        constexpr int iters = 4; // 3..6 reicht oft
+
+        for (int iter = 0; iter < iters; ++iter)
+        {
+            bool anyImproved = false;
+
+            for (int i = 0; i < 31; ++i)
+            {
+                if (shouldCancel && shouldCancel())
+                    return Qs;
+
+                const float qCur = Qs[(size_t)i];
+
+                float bestQ = qCur;
+                double localBest = bestLoss;
+
+                // Kandidaten unabhängig voneinander bewerten (im Job-System parallel),
+                // Auswahl danach in fester Reihenfolge wie bisher
+                constexpr int numFactors = (int)(sizeof(factors) / sizeof(factors[0]));
+                std::array<double, numFactors> losses{};
+
+                JobSystem::parallelFor(0, numFactors, [&](int f)
+                    {
+                        auto QtryArr = Qs;
+                        QtryArr[(size_t)i] = juce::jlimit(0.3f, 10.0f, qCur * factors[f]);
+
+                        losses[(size_t)f] = computeLossWithSmoothness(freqs, targetDb, gainsDbFixed, QtryArr, sampleRate, eqFreqs,
+                            lambdaSmooth, lambdaQ, Q0);
+                    });
+
+                for (int f = 0; f < numFactors; ++f)
+                {
+                    const float qTry = juce::jlimit(0.3f, 10.0f, qCur * factors[f]);
+                    const double L = losses[(size_t)f];
+
+                    if (L < localBest)
+                    {
+                        localBest = L;
+                        bestQ = qTry;
+                    }
+                }
+
+                if (bestQ != qCur)
+                {
+                    Qs[(size_t)i] = bestQ;
+                    bestLoss = localBest;
+                    anyImproved = true;
+                }
+            }
+
+            if (!anyImproved)
+                break;
+        }
+
+        return Qs;
+    }
+
+    static float computeOffsetFromCopies(
+        const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum,
+        const std::vector<AudioPluginAudioProcessor::ReferenceBand>& reference,
+        const std::array<float, 31>& eqFreqs)
+    {
+        if (spectrum.empty() || reference.empty())
+            return 0.0f;
+
+        std::vector<float> diffs;
+        diffs.reserve(31);
+
+        const float fMin = 50.0f;
+        const float fMax = 10000.0f;
+
+        for (int i = 0; i < 31; ++i)
+        {
+            const float f = eqFreqs[(size_t)i];
+            if (f < fMin || f > fMax) continue;
+
+            const float ref = sampleLogInterpolatedReferenceMedian(reference, f, DisplayScale::minDb);
+            const float meas = sampleLogInterpolatedSpectrum(spectrum, f, DisplayScale::minDb);
+            diffs.push_back(ref - meas);
+        }
+
+        if (diffs.empty())
+            return 0.0f;
+
+        std::nth_element(diffs.begin(), diffs.begin() + diffs.size() / 2, diffs.end());
+        const float median = diffs[diffs.size() / 2];
+        return juce::jlimit(-36.0f, 36.0f, median);
+    }
+
+    static std::vector<float> generateLogFrequenciesLocal(int numPoints, float minFreq, float maxFreq)
+    {
+        std::vector<float> out;
+        out.reserve((size_t)numPoints);
+
+        const float logMin = std::log10(minFreq);
+        const float logMax = std::log10(maxFreq);
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const float t = (numPoints <= 1) ? 0.0f : (float)i / (float)(numPoints - 1);
+            const float lf = logMin + (logMax - logMin) * t;
+            out.push_back(std::pow(10.0f, lf));
+        }
+        return out;
+    }
+}
+
+namespace AutoEqSolver
+{
+    using namespace CurveMath;
+
+    void computeEQResponseDb(const std::vector<float>& freqs,
+        const std::array<float, 31>& gainsDb,
+        const std::array<float, 31>& Qs,
+        float sampleRate,
+        std::vector<float>& outDb,
+        const std::vector<float>& eqFreqs)
+    {
+        outDb.assign(freqs.size(), 0.0f);
+
+        float sr = sampleRate;
+        if (!(sr > 0.0f))
+            sr = 48000.0f;
+
+        const float nyq = 0.5f * sr;
+        const float maxUsableHz = nyq * 0.999f; // Sicherheitsabstand zu Nyquist
+
+        for (size_t k = 0; k < freqs.size(); ++k)
+        {
+            const float fIn = freqs[k];
+            const float f = juce::jlimit(20.0f, maxUsableHz, fIn);
+
+            double sumDb = 0.0;
+
+            for (int i = 0; i < 31; ++i)
+            {
+                const float gRaw = gainsDb[(size_t)i];
+                if (std::abs(gRaw) <= 0.0001f)
+                    continue;
+
+                float f0 = eqFreqs[(size_t)i];
+                f0 = juce::jlimit(20.0f, maxUsableHz, f0);
+
+                float Q = Qs[(size_t)i];
+                Q = juce::jmax(0.001f, Q);
+
+                // Gain clamp + finite
+                const float g = finiteClamp(gRaw, -12.0f, 12.0f, 0.0f);
+
+                const float A = FastMath::dbToGain(0.5f * g);   // 10^(g/40)
+
+                const float w0 = juce::MathConstants<float>::twoPi * f0 / sr;
+                const float w = juce::MathConstants<float>::twoPi * f / sr;
+
+                const float alpha = std::sin(w0) / (2.0f * Q);
+
+                float b0 = 1.0f + alpha * A;
+                float b1 = -2.0f * std::cos(w0);
+                float b2 = 1.0f - alpha * A;
+
+                float a0 = 1.0f + alpha / A;
+                float a1 = -2.0f * std::cos(w0);
+                float a2 = 1.0f - alpha / A;
+
+                // Normieren auf a0
+                b0 /= a0; b1 /= a0; b2 /= a0;
+                a1 /= a0; a2 /= a0;
+
+                // H(e^jw) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2), z^-1 = e^{-jw}
+                const std::complex<float> z1(std::cos(-w), std::sin(-w));
+                const std::complex<float> z2(std::cos(-2.0f * w), std::sin(-2.0f * w));
+
+                const std::complex<float> num = b0 + b1 * z1 + b2 * z2;
+                const std::complex<float> den = 1.0f + a1 * z1 + a2 * z2;
+
+                const float denMag = std::abs(den);
+                if (!std::isfinite(denMag) || denMag < 1.0e-12f)
+                    continue; // Beitrag überspringen statt NaN zu erzeugen
+
+                float mag = std::abs(num / den);
+                if (!std::isfinite(mag)) mag = 1.0f;
+                mag = std::max(1.0e-8f, mag);
+
+                float magDb = FastMath::gainToDb(mag);
+                if (!std::isfinite(magDb)) magDb = 0.0f;
+
+                sumDb += (double)magDb;
+            }
+
+            outDb[k] = (float)sumDb;
+        }
+    }
+
+    // Stufe 1 Fit: Gauss-Newton nur für Gains, Q fix
+    std::array<float, 31> fitGainsStage1(const std::vector<float>& freqs,
+        const std::vector<float>& targetDb,
+        const std::array<float, 31>& Qs,
+        float sampleRate,
+        const std::vector<float>& eqFreqs,
+        const std::array<double, 31>* extraDiagPenalty,
+        const ShouldCancel& shouldCancel)
+    {
+        std::array<float, 31> gains{};
+        gains.fill(0.0f);
+
+        const int N = (int)freqs.size();
+        const int M = 31;
+
+        std::vector<float> curDb;
+        std::vector<double> r((size_t)N, 0.0);
+        std::vector<double> J((size_t)M * N, 0.0);   // Spalte i ab J[i * N]
+
+        constexpr float deltaDb = 0.25f;     // finite difference step
+        constexpr int iters = 8;             // 6–10 ist meist genug
+        constexpr double damping = 1e-2;     // stabilisiert (Tikhonov)
+
+        for (int iter = 0; iter < iters; ++iter)
+        {
+            if (shouldCancel && shouldCancel())
+                break;
+
+            // current response
+            computeEQResponseDb(freqs, gains, Qs, sampleRate, curDb, eqFreqs);
+
+            // residual r = target - current
+            for (int k = 0; k < N; ++k)
+                r[(size_t)k] = (double)targetDb[(size_t)k] - (double)curDb[(size_t)k];
+
+            // Normal equations: (J^T J + λI) * dg = J^T r
+            std::vector<double> AtA((size_t)M * M, 0.0);
+            std::vector<double> Atb((size_t)M, 0.0);
+
+            // Jacobian per finite diff, je Band eine Spalte J[i][k] = d(curDb[k])/d(gain_i).
+            // Jede Spalte kostet zwei Frequenzgänge und wird nur einmal gerechnet;
+            // die Spalten sind unabhängig und laufen im Job-System parallel.
+            const double denom = 1.0 / (2.0 * (double)deltaDb);
+
+            JobSystem::parallelFor(0, M, [&](int i)
+                {
+                    // Abgebrochen: Spalte auslassen, das Ergebnis wird verworfen
+                    if (shouldCancel && shouldCancel())
+                        return;
+
+                    std::vector<float> plusDb, minusDb;
+
+                    auto gPlus = gains;
+                    auto gMinus = gains;
+                    gPlus[(size_t)i] = juce::jlimit(-12.0f, 12.0f, gPlus[(size_t)i] + deltaDb);
+                    gMinus[(size_t)i] = juce::jlimit(-12.0f, 12.0f, gMinus[(size_t)i] - deltaDb);
+
+                    computeEQResponseDb(freqs, gPlus, Qs, sampleRate, plusDb, eqFreqs);
+                    computeEQResponseDb(freqs, gMinus, Qs, sampleRate, minusDb, eqFreqs);
+
+                    auto* Ji = J.data() + (size_t)i * N;
+                    for (int k = 0; k < N; ++k)
+                        Ji[k] = ((double)plusDb[(size_t)k] - (double)minusDb[(size_t)k]) * denom;
+                });
+
+            if (shouldCancel && shouldCancel())
+                break;
+
+            // Atb[i] = Σ Ji[k] * r[k], AtA[i,j] = Σ Ji[k] * Jj[k]
+            for (int i = 0; i < M; ++i)
+            {
+                const auto* Ji = J.data() + (size_t)i * N;
+
+                double sumAtb = 0.0;
+                for (int k = 0; k < N; ++k)
+                    sumAtb += Ji[k] * r[(size_t)k];
+                Atb[(size_t)i] = sumAtb;
+
+                for (int j = 0; j <= i; ++j)
+                {
+                    const auto* Jj = J.data() + (size_t)j * N;
+
+                    double sum = 0.0;
+                    for (int k = 0; k < N; ++k)
+                        sum += Ji[k] * Jj[k];
+
+                    // i == j trifft beide Zeilen: die Diagonale zählt doppelt (wie bisher,
+                    // wirkt als zusätzliche Dämpfung; das Fit-Verhalten bleibt gleich)
+                    AtA[(size_t)i * M + j] += sum;
+                    AtA[(size_t)j * M + i] += sum; // symmetrisch
+                }
+            }
+
+            // Damping auf Diagonale
+            for (int i = 0; i < M; ++i)
+                AtA[(size_t)i * M + i] += damping;
+
+            if (extraDiagPenalty != nullptr)
+            {
+                for (int i = 0; i < M; ++i)
+                    AtA[(size_t)i * M + i] += (*extraDiagPenalty)[(size_t)i];
+            }
+
+            // --- Gain Smoothness Regularization (verhindert Ripple/Kammfilter in der EQ-Kurve) ---
+            // Minimiert Sum (g[i] - g[i-1])^2
+            constexpr double lambdaGainSmooth = 0.35; // 0.15 .. 1.0 (höher = glatter)
+
+            for (int i = 0; i < M; ++i)
+            {
+                double diag = 0.0;
+
+                if (i > 0)
+                {
+                    diag += lambdaGainSmooth;
+                    AtA[(size_t)i * M + (i - 1)] -= lambdaGainSmooth;
+                    AtA[(size_t)(i - 1) * M + i] -= lambdaGainSmooth;
+                }
+
+                if (i < M - 1)
+                {
+                    diag += lambdaGainSmooth;
+                    // (i,i+1) kommt implizit über den i>0-Teil beim nächsten Index rein
+                }
+
+                AtA[(size_t)i * M + i] += diag;
+            }
+
+            // Solve
+            auto Awork = AtA;
+            auto bwork = Atb;
+
+            if (!solveSPD_Cholesky(Awork, bwork, M))
+                break;
+
+            // Update gains
+            float maxStep = 0.0f;
+            for (int i = 0; i < M; ++i)
+            {
+                const float step = (float)bwork[(size_t)i];
+                maxStep = std::max(maxStep, std::abs(step));
+
+                float stepF = finiteOr((float)bwork[(size_t)i], 0.0f);
+
+                // Optional: Step begrenzen (stabilisiert den Solver extrem)
+                stepF = juce::jlimit(-3.0f, 3.0f, stepF);
+
+                const float newG = gains[(size_t)i] + stepF;
+                gains[(size_t)i] = finiteClamp(newG, -12.0f, 12.0f, 0.0f);
+            }
+
+            // Abbruch wenn kaum Änderung
+            if (maxStep < 0.02f)
+                break;
+        }
+
+        return gains;
+    }
+
+    /**
+     * @brief Berechnet Gains, Qs und Makeup für eine Messung gegen eine Referenz.
+     *
+     * Entspricht dem bisherigen Auto-EQ-Job des Editors: Pegel-Offset,
+     * gewichtete Residuals, optionaler Hybrid-Bass-Modus, zweistufiger
+     * Gains/Qs-Fit und Makeup aus der vorhergesagten Post-EQ-Kurve.
+     *
+     * @param spectrum Gemitteltes Pre-EQ-Spektrum der Messung
+     * @param reference Referenzbänder (p10/Median/p90)
+     * @param qFixed Start-Qs (aktuelle Knob-Stellung)
+     * @param eqFreqs Mittenfrequenzen der 31 Bänder
+     * @param sr Abtastrate in Hz
+     * @param shouldCancel Optional: true bricht zwischen Iterationen ab (leeres Result)
+     */
+    Result solve(const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum,
+        const std::vector<AudioPluginAudioProcessor::ReferenceBand>& reference,
+        const std::array<float, 31>& qFixed,
+        const std::array<float, 31>& eqFreqs,
+        float sr,
+        const ShouldCancel& shouldCancel)
+    {
+        const TraceRecorder::Scope traceScope("AutoEqSolver::solve", "autoEq");
+
+        const float offsetDb = computeOffsetFromCopies(spectrum, reference, eqFreqs);
+
+        // Residuals (31)
+        std::vector<float> residuals;
+        residuals.reserve(31);
+
+        for (int i = 0; i < 31; ++i)
+        {
+            const float f = eqFreqs[(size_t)i];
+
+            const float refLevel = sampleLogInterpolatedReferenceMedian(reference, f, DisplayScale::minDb);
+            float measLevel = sampleLogInterpolatedSpectrum(spectrum, f, DisplayScale::minDb);
+
+            const float gateDb = DisplayScale::minDb + 10.0f;
+            if (measLevel < gateDb) measLevel = gateDb;
+
+            measLevel += offsetDb;
+
+            auto bassWeight = [](float f)
+                {
+                    if (f < 40.0f) return 0.20f;
+                    if (f < 80.0f) return 0.35f;
+                    if (f < 120.0f) return 0.55f;
+                    return 1.0f;
+                };
+
+            auto bandMaxCorr = [](float f)
+                {
+                    if (f < 60.0f)  return 4.0f;   // ganz unten nie “wild” korrigieren
+                    if (f < 120.0f) return 6.0f;
+                    return 12.0f;
+                };
+
+            float r = (refLevel - measLevel) * edgeWeight(f) * bassWeight(f);
+            r = juce::jlimit(-bandMaxCorr(f), bandMaxCorr(f), r);
+            residuals.push_back(r);
+        }
+
+        // smoothing + amount
+        residuals = smoothMovingAverage(residuals, 5, 1);
+        for (auto& r : residuals)
+            r *= 1.0f; // kAutoEqAmount
+
+        std::array<float, 31> residualsArr{};
+        for (int i = 0; i < 31; ++i)
+            residualsArr[(size_t)i] = juce::jlimit(-12.0f, 12.0f, residuals[(size_t)i]);
+
+        // ==============================
+        // Hybrid Bass Mode (Peak+Dip breitbandig)
+        // ==============================
+        bool hybridBass = false;
+        int idxMax = -1;
+        int idxMin = -1;
+
+        std::array<double, 31> extraPenalty{};
+        extraPenalty.fill(0.0);
+
+        auto isBass = [&](float f)
+            {
+                return (f >= 40.0f && f <= 400.0f);
+            };
+
+        // 1) Bass-Schwankung messen (Peak-to-Peak)
+        float bassMax = -1.0e9f;
+        float bassMin = 1.0e9f;
+
+        for (int i = 0; i < 31; ++i)
+        {
+            const float f = eqFreqs[(size_t)i];
+            if (!isBass(f)) continue;
+
+            bassMax = std::max(bassMax, residuals[(size_t)i]);
+            bassMin = std::min(bassMin, residuals[(size_t)i]);
+        }
+
+        const float bassP2P = bassMax - bassMin;
+
+        // Schwelle: ab hier "große" Schwankung -> Hybrid-Modus
+        // (Tipp: 5..8 dB je nach Material)
+        if (bassP2P > 6.0f)
+        {
+            hybridBass = true;
+
+            // 2) stärkstes Maximum + Minimum finden
+            float bestPos = -1.0e9f;
+            float bestNeg = 1.0e9f;
+
+            for (int i = 0; i < 31; ++i)
+            {
+                const float f = eqFreqs[(size_t)i];
+                if (!isBass(f)) continue;
+
+                const float r = residuals[(size_t)i];
+
+                if (r > bestPos) { bestPos = r; idxMax = i; }
+                if (r < bestNeg) { bestNeg = r; idxMin = i; }
+            }
+
+            // 3) coarse bass target aus 2 breiten Gaussians bauen
+            std::vector<float> coarse = residuals;
+
+            // Bassbereich "leer machen"
+            for (int i = 0; i < 31; ++i)
+                if (isBass(eqFreqs[(size_t)i]))
+                    coarse[(size_t)i] = 0.0f;
+
+            const float sigmaOct = 0.55f; // Breite in Oktaven (größer = breiter)
+
+            auto g = [&](float f, float fc)
+                {
+                    const float x = std::log2(f);
+                    const float xc = std::log2(fc);
+                    const float d = (x - xc) / sigmaOct;
+                    return std::exp(-0.5f * d * d);
+                };
+
+            if (idxMax >= 0)
+            {
+                const float fc = eqFreqs[(size_t)idxMax];
+                const float A = residuals[(size_t)idxMax];
+                for (int i = 0; i < 31; ++i)
+                {
+                    const float f = eqFreqs[(size_t)i];
+                    if (!isBass(f)) continue;
+                    coarse[(size_t)i] += A * g(f, fc);
+                }
+            }
+
+            if (idxMin >= 0)
+            {
+                const float fc = eqFreqs[(size_t)idxMin];
+                const float A = residuals[(size_t)idxMin];
+                for (int i = 0; i < 31; ++i)
+                {
+                    const float f = eqFreqs[(size_t)i];
+                    if (!isBass(f)) continue;
+                    coarse[(size_t)i] += A * g(f, fc);
+                }
+            }
+
+            // 4) Bass-Residuals ersetzen (Mix, damit’s nicht "zu hart" wird)
+            const float mix = 0.85f; // 0.7..0.95
+            for (int i = 0; i < 31; ++i)
+            {
+                const float f = eqFreqs[(size_t)i];
+                if (!isBass(f)) continue;
+
+                residuals[(size_t)i] = (1.0f - mix) * residuals[(size_t)i] + mix * coarse[(size_t)i];
+            }
+
+            // 5) Solver zwingen: nur die 2 Extrem-Bänder im Bass sollen "frei" sein
+            // Alle anderen Bass-Bänder bekommen Zusatz-Penalty -> bleiben näher an 0 dB Gain.
+            for (int i = 0; i < 31; ++i)
+            {
+                const float f = eqFreqs[(size_t)i];
+                if (!isBass(f)) continue;
+
+                if (i == idxMax || i == idxMin)
+                    extraPenalty[(size_t)i] = 0.05;  // fast frei
+                else
+                    extraPenalty[(size_t)i] = 2.5;   // stärker "zu 0 drücken" (1.0..6.0)
+            }
+        }
+
+        // Fit (etwas kleiner -> weniger Freeze/CPU)
+        const int fitPoints = 350; // 250..400 ist sehr praxisnah
+        auto fitFreqs = generateLogFrequenciesLocal(fitPoints, 20.0f, 20000.0f);
+
+        std::vector<float> bandFreqs;
+        bandFreqs.reserve(31);
+        for (int i = 0; i < 31; ++i)
+            bandFreqs.push_back(eqFreqs[(size_t)i]);
+
+        std::vector<float> targetDb;
+        targetDb.reserve(fitFreqs.size());
+        for (auto f : fitFreqs)
+            targetDb.push_back(interpLogCurveDb(bandFreqs, residuals, f));
+
+        // Stufe 1: Gains fitten (Q fix)
+        const std::array<double, 31>* penaltyPtr = hybridBass ? &extraPenalty : nullptr;
+
+        std::array<float, 31> gainsStage1 = fitGainsStage1(fitFreqs, targetDb, qFixed, sr, bandFreqs, penaltyPtr,
+            shouldCancel);
+
+        // Stufe 2: Qs optimieren (gegen Ripple)
+        std::array<float, 31> qStage2 = fitQsStage2_Coordinate(fitFreqs, targetDb, gainsStage1, qFixed, sr, bandFreqs,
+            shouldCancel);
+
+        if (shouldCancel && shouldCancel())
+            return {};
+
+        if (hybridBass)
+        {
+            // Nur die 2 aktiven Bassbänder wirklich breit (kleines Q)
+            if (idxMax >= 0) qStage2[(size_t)idxMax] = juce::jlimit(0.6f, 1.4f, qStage2[(size_t)idxMax]);
+            if (idxMin >= 0) qStage2[(size_t)idxMin] = juce::jlimit(0.6f, 1.4f, qStage2[(size_t)idxMin]);
+
+            // Restliche Bassbänder notfalls auch nicht zu schmal werden lassen
+            for (int i = 0; i < 31; ++i)
+                if (eqFreqs[(size_t)i] >= 40.0f && eqFreqs[(size_t)i] <= 400.0f)
+                    qStage2[(size_t)i] = juce::jmin(qStage2[(size_t)i], 2.0f);
+        }
+
+        // Q hard limits (Basis)
+        for (auto& q : qStage2)
+            q = juce::jlimit(0.6f, 6.0f, q);
+
+        // Danach: Gains nochmal fitten mit neuen Qs
+        std::array<float, 31> finalGains = fitGainsStage1(fitFreqs, targetDb, qStage2, sr, bandFreqs, penaltyPtr,
+            shouldCancel);
+
+        // Optional: Q abhängig von Gain begrenzen
+        for (int i = 0; i < 31; ++i)
+        {
+            const float gAbs = std::abs(finalGains[(size_t)i]);
+            float q = qStage2[(size_t)i];
+
+            const float qMax = (gAbs > 8.0f) ? 1.4f
+                : (gAbs > 5.0f) ? 2.2f
+                : 4.0f;
+
+            qStage2[(size_t)i] = juce::jlimit(0.6f, qMax, q);
+        }
+
+        // WICHTIG: Nach Q-Begrenzung Gains nochmal refitten, sonst passt’s nicht mehr!
+        finalGains = fitGainsStage1(fitFreqs, targetDb, qStage2, sr, bandFreqs, penaltyPtr, shouldCancel);
+
+        if (shouldCancel && shouldCancel())
+            return {};
+
+        // === Makeup Gain so berechnen, dass (Meas + offset + EQResponse) wieder zur Referenz passt ===
+        // 1) EQ-Response in dB auf fitFreqs berechnen
+        std::vector<float> respDb;
+        computeEQResponseDb(fitFreqs, finalGains, qStage2, sr, respDb, bandFreqs);
+
+        // 2) Median-Differenz im stabilen Bereich bilden
+        std::vector<float> diffs;
+        diffs.reserve(fitFreqs.size());
+
+        for (size_t k = 0; k < fitFreqs.size(); ++k)
+        {
+            const float f = fitFreqs[k];
+            if (f < 50.0f || f > 10000.0f) // ggf. 60..10k wenn du Bass noch mehr rausnehmen willst
+                continue;
+
+            const float ref = sampleLogInterpolatedReferenceMedian(reference, f, DisplayScale::minDb);
+            float meas = sampleLogInterpolatedSpectrum(spectrum, f, DisplayScale::minDb);
+
+            // Gate wie bei Residuals (verhindert "Noise floor" Einfluss)
+            const float gateDb = DisplayScale::minDb + 10.0f;
+            if (meas < gateDb) meas = gateDb;
+
+            const float predictedPost = meas + offsetDb + respDb[k];
+            diffs.push_back(ref - predictedPost);
+        }
+
+        float makeupDeltaDb = 0.0f;
+        if (!diffs.empty())
+        {
+            std::nth_element(diffs.begin(), diffs.begin() + diffs.size() / 2, diffs.end());
+            makeupDeltaDb = diffs[diffs.size() / 2];
+        }
+
+        makeupDeltaDb = juce::jlimit(-12.0f, 12.0f, makeupDeltaDb);
+
+        Result result;
+        result.gainsDb = finalGains;
+        result.qs = qStage2;
+        result.residualsDb = residualsArr;
+        result.makeupDb = makeupDeltaDb;
+        return result;
+    }
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include "PluginProcessor.h"
+#include <array>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+// Auto-EQ-Löser: Messung + Referenz -> 31 Gains/Qs
+//
+// Reine Berechnung ohne UI- oder Processor-Zugriff; läuft im Editor als
+// JobSystem-Job (Jacobi-Spalten und Q-Kandidaten per parallelFor) und in
+// den Offline-Tools direkt.
+namespace AutoEqSolver
+{
+    struct Result
+    {
+        std::array<float, 31> gainsDb{};     // Slider-Gains
+        std::array<float, 31> qs{};          // optimierte Bandbreiten
+        std::array<float, 31> residualsDb{}; // Zielkurve (31 Punkte) für die Anzeige
+        float makeupDb = 0.0f;               // Pegelkorrektur relativ zum Input-Gain
+    };
+
+    // Abbruch-Abfrage für Hintergrund-Jobs, wird zwischen den Iterationen aufgerufen
+    using ShouldCancel = std::function<bool()>;
+
+    // Vollständiger Lauf: Offset, Residuals, Hybrid-Bass, Gains/Qs-Fit, Makeup.
+    // Bei Abbruch ein leeres Result (alle Gains 0).
+    Result solve(const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum,
+        const std::vector<AudioPluginAudioProcessor::ReferenceBand>& reference,
+        const std::array<float, 31>& qFixed,
+        const std::array<float, 31>& eqFreqs,
+        float sr,
+        const ShouldCancel& shouldCancel = {});
+
+    // Berechnet EQ-Response in dB (Summe der log-Magnitudes) für gegebene Gains+Qs
+    void computeEQResponseDb(const std::vector<float>& freqs,
+        const std::array<float, 31>& gainsDb,
+        const std::array<float, 31>& Qs,
+        float sampleRate,
+        std::vector<float>& outDb,
+        const std::vector<float>& eqFreqs);
+
+    // Gains bei festen Qs fitten (Gauss-Newton mit Dämpfung)
+    std::array<float, 31> fitGainsStage1(const std::vector<float>& freqs,
+        const std::vector<float>& targetDb,
+        const std::array<float, 31>& Qs,
+        float sampleRate,
+        const std::vector<float>& eqFreqs,
+        const std::array<double, 31>* extraDiagPenalty = nullptr,
+        const ShouldCancel& shouldCancel = {});
+}
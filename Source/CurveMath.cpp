@@ -0,0 +1,144 @@
+﻿#include "CurveMath.h"
+
+namespace CurveMath
+{
+    float edgeWeight(float f)
+    {
+        // Fade-in 20..40 Hz
+        if (f < 40.0f)
+            return juce::jlimit(0.0f, 1.0f, juce::jmap(f, 20.0f, 40.0f, 0.0f, 1.0f));
+
+        // Fade-out 16k..20k
+        if (f > 16000.0f)
+            return juce::jlimit(0.0f, 1.0f, juce::jmap(f, 16000.0f, 20000.0f, 1.0f, 0.0f));
+
+        return 1.0f;
+    }
+
+    std::vector<float> smoothMovingAverage(const std::vector<float>& in, int windowSize, int passes)
+    {
+        if ((int)in.size() < 3 || windowSize < 3)
+            return in;
+
+        std::vector<float> cur = in;
+        std::vector<float> out(in.size());
+        const int half = windowSize / 2;
+
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            for (int i = 0; i < (int)cur.size(); ++i)
+            {
+                double sum = 0.0;
+                int count = 0;
+
+                for (int j = -half; j <= half; ++j)
+                {
+                    const int idx = i + j;
+                    if (idx >= 0 && idx < (int)cur.size())
+                    {
+                        sum += cur[(size_t)idx];
+                        ++count;
+                    }
+                }
+
+                out[(size_t)i] = (count > 0) ? (float)(sum / (double)count) : cur[(size_t)i];
+            }
+            cur.swap(out);
+        }
+
+        return cur;
+    }
+
+    float sampleLogInterpolatedSpectrum(
+        const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& pts,
+        float fHz,
+        float fallbackDb)
+    {
+        if (pts.empty())
+            return fallbackDb;
+
+        if (fHz <= pts.front().frequency) return pts.front().level;
+        if (fHz >= pts.back().frequency)  return pts.back().level;
+
+        const float lf = std::log10(fHz);
+
+        for (size_t i = 1; i < pts.size(); ++i)
+        {
+            const float f1 = pts[i].frequency;
+            if (f1 >= fHz)
+            {
+                const float f0 = pts[i - 1].frequency;
+
+                const float l0 = std::log10(f0);
+                const float l1 = std::log10(f1);
+
+                const float t = (lf - l0) / (l1 - l0);
+
+                return pts[i - 1].level + t * (pts[i].level - pts[i - 1].level);
+            }
+        }
+
+        return pts.back().level;
+    }
+
+    float sampleLogInterpolatedReferenceMedian(
+        const std::vector<AudioPluginAudioProcessor::ReferenceBand>& ref,
+        float fHz,
+        float fallbackDb)
+    {
+        if (ref.empty())
+            return fallbackDb;
+
+        if (fHz <= ref.front().freq) return ref.front().median;
+        if (fHz >= ref.back().freq)  return ref.back().median;
+
+        const float lf = std::log10(fHz);
+
+        for (size_t i = 1; i < ref.size(); ++i)
+        {
+            const float f1 = ref[i].freq;
+            if (f1 >= fHz)
+            {
+                const float f0 = ref[i - 1].freq;
+
+                const float l0 = std::log10(f0);
+                const float l1 = std::log10(f1);
+
+                const float t = (lf - l0) / (l1 - l0);
+
+                return ref[i - 1].median + t * (ref[i].median - ref[i - 1].median);
+            }
+        }
+
+        return ref.back().median;
+    }
+
+    float interpLogCurveDb(const std::vector<float>& bandFreqs,
+        const std::vector<float>& bandDb,
+        float fHz)
+    {
+        jassert(bandFreqs.size() == bandDb.size());
+        if (bandFreqs.empty()) return 0.0f;
+
+        if (fHz <= bandFreqs.front()) return bandDb.front();
+        if (fHz >= bandFreqs.back())  return bandDb.back();
+
+        const float lf = std::log10(fHz);
+
+        for (size_t i = 1; i < bandFreqs.size(); ++i)
+        {
+            if (bandFreqs[i] >= fHz)
+            {
+                const float f0 = bandFreqs[i - 1];
+                const float f1 = bandFreqs[i];
+                const float l0 = std::log10(f0);
+                const float l1 = std::log10(f1);
+
+                const float t = (lf - l0) / (l1 - l0);
+                return bandDb[i - 1] + t * (bandDb[i] - bandDb[i - 1]);
+            }
+        }
+
+        return bandDb.back();
+    }
+}
@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include "PluginProcessor.h"
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+// Kurven-Hilfsfunktionen für Anzeige, Referenzanalyse und Auto-EQ
+// (Log-Interpolation, Glättung, Gewichtung)
+namespace CurveMath
+{
+    // Rand-Fade: Bass & Air entschärfen (0..1)
+    float edgeWeight(float f);
+
+    inline float finiteOr(float x, float fallback) noexcept
+    {
+        return std::isfinite(x) ? x : fallback;
+    }
+
+    inline float finiteClamp(float x, float lo, float hi, float fallback = 0.0f) noexcept
+    {
+        if (!std::isfinite(x)) return fallback;
+        return juce::jlimit(lo, hi, x);
+    }
+
+    // Breitband-Smoothing (Moving Average)
+    std::vector<float> smoothMovingAverage(const std::vector<float>& in, int windowSize, int passes);
+
+    // Spektrum an einer Frequenz (log-interpoliert)
+    float sampleLogInterpolatedSpectrum(
+        const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& pts,
+        float fHz,
+        float fallbackDb);
+
+    // Interpoliert Median der Referenzbänder
+    float sampleLogInterpolatedReferenceMedian(
+        const std::vector<AudioPluginAudioProcessor::ReferenceBand>& ref,
+        float fHz,
+        float fallbackDb);
+
+    // Log-Interpolation: 31 Bandpunkte -> Zielkurve auf beliebigen Frequenzen
+    float interpLogCurveDb(const std::vector<float>& bandFreqs,
+        const std::vector<float>& bandDb,
+        float fHz);
+}
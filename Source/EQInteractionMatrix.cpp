@@ -0,0 +1,170 @@
+﻿/**
+ * @file EQInteractionMatrix.cpp
+ * @brief Interaktionsmatrix und Gain-Solver für den 31-Band-EQ.
+ */
+
+#include "EQInteractionMatrix.h"
+#include "EQResponseCache.h"
+#include <cmath>
+
+namespace
+{
+    // Referenz-Gain für die Matrix (Peaking-Bänder sind in dB nahezu linear im Gain)
+    constexpr float kProbeGainDb = 6.0f;
+
+    // Tikhonov-Regularisierung: hält die Lösung ruhig, wenn Ziele benachbarter
+    // Bänder stark auseinanderliegen
+    constexpr double kRegularisation = 1.0e-3;
+}
+
+//==============================================================================
+/**
+ * @brief Baut Matrix und Solver neu, falls sich Eingaben geändert haben.
+ *
+ * @param bandFrequencies Mittenfrequenzen der 31 Bänder in Hz
+ * @param bandQs Q-Werte der 31 Bänder
+ * @param sampleRate Abtastrate in Hz
+ */
+void EQInteractionMatrix::update(const BandArray& bandFrequencies, const BandArray& bandQs, double sampleRate)
+{
+    if (valid && sampleRate == cachedSampleRate && bandQs == cachedQs && bandFrequencies == cachedFrequencies)
+        return;
+
+    cachedFrequencies = bandFrequencies;
+    cachedQs = bandQs;
+    cachedSampleRate = sampleRate;
+
+    // M[i][j]: dB an Mitte i pro dB Gain von Band j
+    for (int i = 0; i < numBands; ++i)
+        for (int j = 0; j < numBands; ++j)
+            interaction[i][j] = EQResponseCache::computePeakDb(bandFrequencies[i], bandFrequencies[j],
+                kProbeGainDb, bandQs[j], sampleRate) / kProbeGainDb;
+
+    // Normalgleichung: N = MᵀM + λI
+    Matrix normal{};
+    for (int r = 0; r < numBands; ++r)
+    {
+        for (int c = 0; c < numBands; ++c)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < numBands; ++k)
+                sum += interaction[k][r] * interaction[k][c];
+
+            normal[r][c] = sum + (r == c ? kRegularisation : 0.0);
+        }
+    }
+
+    valid = invert(normal);
+
+    if (!valid)
+        return;
+
+    // solver = N^-1 Mᵀ
+    for (int r = 0; r < numBands; ++r)
+    {
+        for (int c = 0; c < numBands; ++c)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < numBands; ++k)
+                sum += normal[r][k] * interaction[c][k];
+
+            solver[r][c] = sum;
+        }
+    }
+}
+
+/**
+ * @brief Antwort an den Bandmitten für gegebene Gains (M * g).
+ */
+EQInteractionMatrix::BandArray EQInteractionMatrix::responseAtCentres(const BandArray& gainsDb) const noexcept
+{
+    BandArray out{};
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        double sum = 0.0;
+        for (int j = 0; j < numBands; ++j)
+            sum += interaction[i][j] * gainsDb[j];
+
+        out[i] = (float)sum;
+    }
+
+    return out;
+}
+
+/**
+ * @brief Gains für Zielwerte an den Bandmitten (ungeklemmt).
+ *
+ * Ohne gültige Matrix werden die Zielwerte direkt als Gains geliefert.
+ */
+EQInteractionMatrix::BandArray EQInteractionMatrix::solveGains(const BandArray& targetDb) const noexcept
+{
+    if (!valid)
+        return targetDb;
+
+    BandArray out{};
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        double sum = 0.0;
+        for (int j = 0; j < numBands; ++j)
+            sum += solver[i][j] * targetDb[j];
+
+        out[i] = (float)sum;
+    }
+
+    return out;
+}
+
+/**
+ * @brief Invertiert eine Matrix in-place (Gauss-Jordan mit Pivotsuche).
+ *
+ * @return false wenn die Matrix singulär ist
+ */
+bool EQInteractionMatrix::invert(Matrix& m)
+{
+    Matrix inv{};
+    for (int i = 0; i < numBands; ++i)
+        inv[i][i] = 1.0;
+
+    for (int col = 0; col < numBands; ++col)
+    {
+        // Pivot: größter Betrag in der Spalte
+        int pivot = col;
+        for (int r = col + 1; r < numBands; ++r)
+            if (std::abs(m[r][col]) > std::abs(m[pivot][col]))
+                pivot = r;
+
+        if (std::abs(m[pivot][col]) < 1.0e-12)
+            return false;
+
+        std::swap(m[col], m[pivot]);
+        std::swap(inv[col], inv[pivot]);
+
+        const double scale = 1.0 / m[col][col];
+        for (int c = 0; c < numBands; ++c)
+        {
+            m[col][c] *= scale;
+            inv[col][c] *= scale;
+        }
+
+        for (int r = 0; r < numBands; ++r)
+        {
+            if (r == col)
+                continue;
+
+            const double factor = m[r][col];
+            if (factor == 0.0)
+                continue;
+
+            for (int c = 0; c < numBands; ++c)
+            {
+                m[r][c] -= factor * m[col][c];
+                inv[r][c] -= factor * inv[col][c];
+            }
+        }
+    }
+
+    m = inv;
+    return true;
+}
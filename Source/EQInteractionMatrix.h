@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+// Interaktionsmatrix des 31-Band-EQs
+//
+// M[i][j] = Antwort (dB) an der Mitte von Band i pro dB Gain von Band j.
+// Benachbarte Bänder überlappen, daher erreicht "Fader = Zielwert" das Ziel
+// nicht. Mit der (regularisierten) Inversen werden die Gains bestimmt, die
+// an allen 31 Bandmitten gleichzeitig die Zielwerte treffen.
+// Neu aufgebaut nur wenn sich Q-Werte oder Samplerate ändern (31x31, <1 ms).
+class EQInteractionMatrix
+{
+public:
+    static constexpr int numBands = 31;
+    using BandArray = std::array<float, numBands>;
+
+    // Matrix bei Bedarf neu aufbauen (Qs/Samplerate/Frequenzen geändert)
+    void update(const BandArray& bandFrequencies, const BandArray& bandQs, double sampleRate);
+
+    // Antwort an den Bandmitten für gegebene Gains (lineare Näherung: M * g)
+    BandArray responseAtCentres(const BandArray& gainsDb) const noexcept;
+
+    // Gains, die an den Bandmitten die Zielwerte erreichen: (MᵀM + λI)^-1 Mᵀ t
+    BandArray solveGains(const BandArray& targetDb) const noexcept;
+
+private:
+    using Matrix = std::array<std::array<double, numBands>, numBands>;
+
+    static bool invert(Matrix& m);
+
+    Matrix interaction{};   // M
+    Matrix solver{};        // (MᵀM + λI)^-1 Mᵀ
+
+    BandArray cachedFrequencies{};
+    BandArray cachedQs{};
+    double cachedSampleRate = 0.0;
+    bool valid = false;
+};
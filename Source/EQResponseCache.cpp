@@ -0,0 +1,220 @@
+﻿#include "EQResponseCache.h"
+#include "FastMath.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>
+
+namespace
+{
+    // Bänder unterhalb dieser Schwelle tragen nichts bei (wie bisher in der Anzeige)
+    constexpr float kActiveThresholdDb = 0.01f;
+
+    // Nach so vielen inkrementellen Updates wird die Summe exakt neu gebildet,
+    // damit sich keine Rundungsfehler aufaddieren
+    constexpr int kResumInterval = 256;
+}
+
+//==============================================================================
+/**
+ * @brief Legt das Frequenzraster an und setzt alle Bänder auf 0 dB.
+ *
+ * cos(w) und cos(2w) werden einmalig pro Punkt vorberechnet, damit die
+ * Auswertung eines Bands ohne Trigonometrie pro Punkt auskommt.
+ *
+ * @param bandFrequencies Mittenfrequenzen der 31 Bänder in Hz
+ * @param sampleRate Abtastrate in Hz
+ * @param minFreq Untere Frequenz des Rasters in Hz
+ * @param maxFreq Obere Frequenz des Rasters in Hz
+ */
+void EQResponseCache::prepare(const std::array<float, numBands>& bandFrequencies, double sampleRate,
+    float minFreq, float maxFreq)
+{
+    currentSampleRate = sampleRate;
+    minFrequency = minFreq;
+    maxFrequency = maxFreq;
+
+    frequencies.resize(numPoints);
+    cosW.resize(numPoints);
+    cos2W.resize(numPoints);
+    totalDb.assign(numPoints, 0.0f);
+
+    const float logMin = std::log10(minFreq);
+    const float logMax = std::log10(maxFreq);
+    const float sr = (float)sampleRate;
+
+    // Gleichmäßig im logarithmischen Raum verteilen
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const float logFreq = logMin + (logMax - logMin) * (float)i / (float)(numPoints - 1);
+        frequencies[i] = std::pow(10.0f, logFreq);
+
+        const float w = juce::MathConstants<float>::twoPi * frequencies[i] / sr;
+        cosW[i] = std::cos(w);
+        cos2W[i] = std::cos(2.0f * w);
+    }
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        auto& band = bands[b];
+        band.f0 = bandFrequencies[b];
+        band.gainDb = 0.0f;
+        band.Q = 4.32f;
+        band.active = false;
+        band.db.assign(numPoints, 0.0f);
+    }
+
+    incrementalUpdates = 0;
+    prepared = true;
+    ++version;
+}
+
+/**
+ * @brief Aktualisiert ein Band inkrementell.
+ *
+ * Zieht den alten Beitrag des Bands von der Summe ab, berechnet den
+ * neuen und addiert ihn. Unveränderte Werte kosten nur einen Vergleich.
+ *
+ * @param index Bandindex (0-30)
+ * @param gainDb Verstärkung in dB
+ * @param Q Güte des Bands
+ * @return true wenn sich der Gesamtfrequenzgang geändert hat
+ */
+bool EQResponseCache::setBand(int index, float gainDb, float Q)
+{
+    jassert(prepared);
+    jassert(juce::isPositiveAndBelow(index, numBands));
+
+    auto& band = bands[index];
+    const bool nowActive = std::abs(gainDb) > kActiveThresholdDb;
+
+    if (gainDb == band.gainDb && Q == band.Q)
+        return false;
+
+    // Inaktiv -> inaktiv: Beitrag bleibt 0, nur Werte merken
+    if (!band.active && !nowActive)
+    {
+        band.gainDb = gainDb;
+        band.Q = Q;
+        return false;
+    }
+
+    // Alten Beitrag entfernen
+    if (band.active)
+        juce::FloatVectorOperations::subtract(totalDb.data(), band.db.data(), numPoints);
+
+    band.gainDb = gainDb;
+    band.Q = Q;
+    band.active = nowActive;
+
+    if (band.active)
+    {
+        computeBandDb(index);
+        juce::FloatVectorOperations::add(totalDb.data(), band.db.data(), numPoints);
+    }
+    else
+    {
+        juce::FloatVectorOperations::clear(band.db.data(), numPoints);
+    }
+
+    if (++incrementalUpdates >= kResumInterval)
+        resumTotal();
+
+    ++version;
+    return true;
+}
+
+/**
+ * @brief Berechnet den Betragsgang eines Peaking-Bands in dB.
+ *
+ * Koeffizienten nach dem "Audio EQ Cookbook" (R. Bristow-Johnson),
+ * ausgewertet über |H|^2 mit den vorberechneten cos(w)/cos(2w):
+ * |b0 + b1 z^-1 + b2 z^-2|^2 = b0²+b1²+b2² + 2(b0b1+b1b2)cos(w) + 2b0b2 cos(2w)
+ *
+ * @param index Bandindex (0-30)
+ */
+void EQResponseCache::computeBandDb(int index)
+{
+    auto& band = bands[index];
+
+    const float A = FastMath::dbToGain(0.5f * band.gainDb);   // 10^(gain/40)
+    const float w0 = juce::MathConstants<float>::twoPi * band.f0 / (float)currentSampleRate;
+    const float alpha = std::sin(w0) / (2.0f * band.Q);
+    const float c = -2.0f * std::cos(w0);
+
+    const float a0 = 1.0f + alpha / A;
+    const float b0 = (1.0f + alpha * A) / a0;
+    const float b1 = c / a0;
+    const float b2 = (1.0f - alpha * A) / a0;
+    const float a1 = c / a0;
+    const float a2 = (1.0f - alpha / A) / a0;
+
+    const float numC0 = b0 * b0 + b1 * b1 + b2 * b2;
+    const float numC1 = 2.0f * (b0 * b1 + b1 * b2);
+    const float numC2 = 2.0f * b0 * b2;
+
+    const float denC0 = 1.0f + a1 * a1 + a2 * a2;
+    const float denC1 = 2.0f * (a1 + a1 * a2);
+    const float denC2 = 2.0f * a2;
+
+    // Erst |H|^2 für alle Punkte, dann in einem Durchgang (vektorisiert) in dB:
+    // 10*log10(|H|^2) = 20*log10(|H|)
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const float num = numC0 + numC1 * cosW[i] + numC2 * cos2W[i];
+        const float den = denC0 + denC1 * cosW[i] + denC2 * cos2W[i];
+
+        band.db[i] = juce::jmax(num, 1.0e-20f) / juce::jmax(den, 1.0e-20f);
+    }
+
+    FastMath::powerToDb(band.db.data(), band.db.data(), numPoints, -400.0f);
+}
+
+/**
+ * @brief Bildet die Summe aller Bandbeiträge exakt neu.
+ */
+void EQResponseCache::resumTotal()
+{
+    juce::FloatVectorOperations::clear(totalDb.data(), numPoints);
+
+    for (const auto& band : bands)
+        if (band.active)
+            juce::FloatVectorOperations::add(totalDb.data(), band.db.data(), numPoints);
+
+    incrementalUpdates = 0;
+}
+
+/**
+ * @brief Betragsgang eines einzelnen Peaking-Bands an einer Frequenz.
+ *
+ * Gleiche Formel wie computeBandDb(), aber für einen Einzelpunkt
+ * (z.B. für die Interaktionsmatrix).
+ *
+ * @param freq Auswertefrequenz in Hz
+ * @param f0 Mittenfrequenz in Hz
+ * @param gainDb Verstärkung in dB
+ * @param Q Güte des Bands
+ * @param sampleRate Abtastrate in Hz
+ * @return Betrag in dB
+ */
+float EQResponseCache::computePeakDb(float freq, float f0, float gainDb, float Q, double sampleRate)
+{
+    const float A = FastMath::dbToGain(0.5f * gainDb);
+    const float w0 = juce::MathConstants<float>::twoPi * f0 / (float)sampleRate;
+    const float w = juce::MathConstants<float>::twoPi * freq / (float)sampleRate;
+    const float alpha = std::sin(w0) / (2.0f * Q);
+    const float c = -2.0f * std::cos(w0);
+
+    const float a0 = 1.0f + alpha / A;
+    const float b0 = (1.0f + alpha * A) / a0;
+    const float b1 = c / a0;
+    const float b2 = (1.0f - alpha * A) / a0;
+    const float a1 = c / a0;
+    const float a2 = (1.0f - alpha / A) / a0;
+
+    const float cosW = std::cos(w);
+    const float cos2W = std::cos(2.0f * w);
+
+    const float num = b0 * b0 + b1 * b1 + b2 * b2 + 2.0f * (b0 * b1 + b1 * b2) * cosW + 2.0f * b0 * b2 * cos2W;
+    const float den = 1.0f + a1 * a1 + a2 * a2 + 2.0f * (a1 + a1 * a2) * cosW + 2.0f * a2 * cos2W;
+
+    return FastMath::powerToDb(juce::jmax(num, 1.0e-20f) / juce::jmax(den, 1.0e-20f), -400.0f);
+}
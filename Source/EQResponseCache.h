@@ -0,0 +1,70 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+// Gecachter Frequenzgang des 31-Band-EQs für die Anzeige
+//
+// Hält pro Band den Betragsgang in dB auf einem festen log. Frequenzraster
+// und summiert diese zum Gesamtfrequenzgang. Ändert sich nur ein Band,
+// wird nur dessen Beitrag neu berechnet (alten abziehen, neuen addieren).
+// Jede Änderung erhöht die Version, damit Pfade nur bei Bedarf neu gebaut werden.
+class EQResponseCache
+{
+public:
+    static constexpr int numBands = 31;
+    static constexpr int numPoints = 2000;
+
+    //==============================================================================
+    // Frequenzraster und Bandmitten setzen; verwirft alle Bänder
+    void prepare(const std::array<float, numBands>& bandFrequencies, double sampleRate,
+        float minFreq, float maxFreq);
+
+    bool isPreparedFor(double sampleRate) const noexcept { return prepared && sampleRate == currentSampleRate; }
+
+    // Band aktualisieren; rechnet nur neu wenn sich Gain/Q geändert haben
+    // Gibt true zurück wenn sich der Gesamtfrequenzgang geändert hat
+    bool setBand(int index, float gainDb, float Q);
+
+    //==============================================================================
+    juce::uint32 getVersion() const noexcept { return version; }
+
+    float getMinFrequency() const noexcept { return minFrequency; }
+    float getMaxFrequency() const noexcept { return maxFrequency; }
+
+    const std::vector<float>& getFrequencies() const noexcept { return frequencies; }
+    const std::vector<float>& getTotalDb() const noexcept { return totalDb; }
+
+    // Betragsgang (dB) eines einzelnen Peaking-Bands an einer Frequenz
+    static float computePeakDb(float freq, float f0, float gainDb, float Q, double sampleRate);
+
+private:
+    void computeBandDb(int index);
+    void resumTotal();
+
+    struct Band
+    {
+        float f0 = 1000.0f;
+        float gainDb = 0.0f;
+        float Q = 4.32f;
+        bool active = false;            // |Gain| > 0.01 dB, sonst Beitrag 0
+        std::vector<float> db;          // Beitrag dieses Bands je Frequenzpunkt
+    };
+
+    std::array<Band, numBands> bands;
+
+    std::vector<float> frequencies;     // log. verteilt, minFreq..maxFreq
+    std::vector<float> cosW;            // cos(w) je Punkt (für |H|^2 ohne complex)
+    std::vector<float> cos2W;           // cos(2w) je Punkt
+    std::vector<float> totalDb;         // Summe aller Bänder in dB
+
+    double currentSampleRate = 0.0;
+    float minFrequency = 20.0f;
+    float maxFrequency = 20000.0f;
+
+    juce::uint32 version = 0;
+    int incrementalUpdates = 0;         // nach vielen +/- Updates exakt neu summieren
+    bool prepared = false;
+};
@@ -0,0 +1,61 @@
+﻿/**
+ * @file FaderLookAndFeel.cpp
+ * @brief Günstiges Zeichnen der EQ-Fader und Q-Knobs.
+ */
+
+#include "FaderLookAndFeel.h"
+
+/**
+ * @brief Zeichnet einen vertikalen Fader als Linie + Rechteck-Thumb.
+ *
+ * Andere Slider-Stile fallen auf LookAndFeel_V4 zurück.
+ */
+void FaderLookAndFeel::drawLinearSlider(juce::Graphics& g, int x, int y, int width, int height,
+    float sliderPos, float minSliderPos, float maxSliderPos,
+    juce::Slider::SliderStyle style, juce::Slider& slider)
+{
+    if (style != juce::Slider::LinearVertical)
+    {
+        LookAndFeel_V4::drawLinearSlider(g, x, y, width, height, sliderPos, minSliderPos, maxSliderPos, style, slider);
+        return;
+    }
+
+    const float centreX = (float)x + (float)width * 0.5f;
+
+    // Spur
+    g.setColour(slider.findColour(juce::Slider::trackColourId));
+    g.fillRect(centreX - 1.0f, (float)y, 2.0f, (float)height);
+
+    // Thumb
+    const float thumbWidth = juce::jmin(14.0f, (float)width);
+    const float thumbHeight = 6.0f;
+
+    g.setColour(slider.findColour(juce::Slider::thumbColourId));
+    g.fillRect(centreX - thumbWidth * 0.5f, sliderPos - thumbHeight * 0.5f, thumbWidth, thumbHeight);
+}
+
+/**
+ * @brief Zeichnet einen Q-Knob als gefüllten Kreis mit Zeigerlinie.
+ */
+void FaderLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+    float sliderPosProportional, float rotaryStartAngle, float rotaryEndAngle,
+    juce::Slider& slider)
+{
+    const auto bounds = juce::Rectangle<int>(x, y, width, height).toFloat().reduced(2.0f);
+    const float radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) * 0.5f;
+    const auto centre = bounds.getCentre();
+
+    g.setColour(slider.findColour(juce::Slider::rotarySliderFillColourId));
+    g.fillEllipse(centre.x - radius, centre.y - radius, radius * 2.0f, radius * 2.0f);
+
+    g.setColour(slider.findColour(juce::Slider::rotarySliderOutlineColourId));
+    g.drawEllipse(centre.x - radius, centre.y - radius, radius * 2.0f, radius * 2.0f, 1.0f);
+
+    // Zeiger (Winkel 0 = oben, im Uhrzeigersinn)
+    const float angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
+    const juce::Point<float> tip(centre.x + radius * 0.8f * std::sin(angle),
+        centre.y - radius * 0.8f * std::cos(angle));
+
+    g.setColour(slider.findColour(juce::Slider::thumbColourId));
+    g.drawLine(centre.x, centre.y, tip.x, tip.y, 1.5f);
+}
@@ -0,0 +1,21 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Schlanke LookAndFeel für die 31 EQ-Fader und Q-Knobs
+//
+// Zeichnet nur gerade Linien, Rechtecke und einen Kreis (keine Pfade mit
+// Bögen, keine Verläufe/Schatten wie LookAndFeel_V4). Farben kommen weiter
+// aus den Slider-ColourIds (thumb/track/rotaryFill/rotaryOutline).
+class FaderLookAndFeel : public juce::LookAndFeel_V4
+{
+public:
+    void drawLinearSlider(juce::Graphics& g, int x, int y, int width, int height,
+        float sliderPos, float minSliderPos, float maxSliderPos,
+        juce::Slider::SliderStyle style, juce::Slider& slider) override;
+
+    void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+        float sliderPosProportional, float rotaryStartAngle, float rotaryEndAngle,
+        juce::Slider& slider) override;
+};
@@ -0,0 +1,104 @@
+﻿#include "FastMath.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <limits>
+
+namespace
+{
+    constexpr float minNormal = std::numeric_limits<float>::min();
+    constexpr float maxFloat = std::numeric_limits<float>::max();
+
+    // x -> scale * log2(x), danach auf floorDb begrenzen
+    void logKernel(float* dest, const float* source, int num, float scale, float floorDb) noexcept
+    {
+        // Begrenzen vorab: mit Verzweigung im Schleifenrumpf würde nicht vektorisiert
+        juce::FloatVectorOperations::clip(dest, source, minNormal, maxFloat, num);
+
+        for (int i = 0; i < num; ++i)
+            dest[i] = scale * FastMath::log2Unchecked(dest[i]);
+
+        juce::FloatVectorOperations::max(dest, dest, floorDb, num);
+    }
+
+    // x -> 2^(scale * x)
+    void expKernel(float* dest, const float* source, int num, float scale) noexcept
+    {
+        juce::FloatVectorOperations::multiply(dest, source, scale, num);
+        juce::FloatVectorOperations::clip(dest, dest, -126.0f, 127.0f, num);
+
+        for (int i = 0; i < num; ++i)
+            dest[i] = FastMath::exp2Unchecked(dest[i]);
+    }
+}
+
+namespace FastMath
+{
+    //==============================================================================
+    /**
+     * @brief Leistung -> dB für ein ganzes Array.
+     *
+     * @param dest Ziel (darf source sein)
+     * @param source Leistungswerte, <= 0 ergibt floorDb
+     * @param num Anzahl Werte
+     * @param floorDb Untergrenze in dB
+     */
+    void powerToDb(float* dest, const float* source, int num, float floorDb) noexcept
+    {
+        if (isExact())
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i] = powerToDb(source[i], floorDb);
+
+            return;
+        }
+
+        logKernel(dest, source, num, dbPerLog2Power, floorDb);
+    }
+
+    /**
+     * @brief Amplitude -> dB für ein ganzes Array (wie gainToDb()).
+     */
+    void gainToDb(float* dest, const float* source, int num, float floorDb) noexcept
+    {
+        if (isExact())
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i] = gainToDb(source[i], floorDb);
+
+            return;
+        }
+
+        logKernel(dest, source, num, dbPerLog2Gain, floorDb);
+    }
+
+    /**
+     * @brief dB -> Leistung für ein ganzes Array.
+     */
+    void dbToPower(float* dest, const float* source, int num) noexcept
+    {
+        if (isExact())
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i] = dbToPower(source[i]);
+
+            return;
+        }
+
+        expKernel(dest, source, num, log2PowerPerDb);
+    }
+
+    /**
+     * @brief dB -> Amplitude für ein ganzes Array.
+     */
+    void dbToGain(float* dest, const float* source, int num) noexcept
+    {
+        if (isExact())
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i] = dbToGain(source[i]);
+
+            return;
+        }
+
+        expKernel(dest, source, num, log2GainPerDb);
+    }
+}
@@ -0,0 +1,138 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifndef MASTERINGEQ_EXACT_MATH
+ #define MASTERINGEQ_EXACT_MATH 0
+#endif
+
+//==============================================================================
+// Schnelle dB/Leistungs-Umrechnung für Analyzer, Messung, Anzeige und Solver
+//
+// log2 und exp2 als Polynome auf der zerlegten float-Darstellung, ohne
+// Tabellen und ohne Verzweigungen im Kern, damit die Array-Varianten vom
+// Compiler vektorisiert werden. Fehlerschranken (gegen double gemessen,
+// siehe MasteringEQMathBench):
+//
+//   log2Fast    absolut < 4e-6 (dominiert von der float-Rundung des Ergebnisses)
+//   exp2Fast    relativ < 3e-7 für -126 <= x <= 127
+//   powerToDb   < 1.1e-5 dB für Ergebnisse in +-100 dB, sonst < 4e-5 dB
+//   gainToDb    < 1.1e-5 dB für Ergebnisse in +-100 dB, sonst < 8e-5 dB
+//   dbToPower   relativ < 2e-6 für +-100 dB (< 1e-5 dB), dbToGain ebenso
+//
+// Das liegt in der Größenordnung von std::log10/std::pow in float und weit
+// unter der Anzeige- und Messauflösung (0.01 dB). Mit setExact(true) oder
+// -DMASTERINGEQ_EXACT_MATH=ON laufen alle Funktionen über std::log10 und
+// std::pow, z.B. um Ergebnisse gegenzuprüfen.
+namespace FastMath
+{
+    inline std::atomic<bool> exactMath{ MASTERINGEQ_EXACT_MATH != 0 };
+
+    inline void setExact(bool shouldBeExact) noexcept { exactMath.store(shouldBeExact, std::memory_order_relaxed); }
+    inline bool isExact() noexcept { return exactMath.load(std::memory_order_relaxed); }
+
+    // Umrechnungsfaktoren zwischen Zehner- und Zweierlogarithmus
+    constexpr float dbPerLog2Power = 3.0102999566398120f;     // 10 * log10(2)
+    constexpr float dbPerLog2Gain = 6.0205999132796239f;      // 20 * log10(2)
+    constexpr float log2PowerPerDb = 0.33219280948873623f;    // log2(10) / 10
+    constexpr float log2GainPerDb = 0.16609640474436812f;     // log2(10) / 20
+
+    //==============================================================================
+    // Kerne ohne Bereichsprüfung: x muss positiv und normal sein (log2) bzw.
+    // in [-126, 127] liegen (exp2). Die Array-Funktionen begrenzen vorher
+    // blockweise, in der Schleife selbst bleibt so keine Verzweigung.
+    inline float log2Unchecked(float x) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        // Mantisse nach [sqrt(0.5), sqrt(2)) legen, Exponent entsprechend
+        const std::uint32_t offset = bits - 0x3f3504f3u;
+        const auto exponent = (float)((std::int32_t)offset >> 23);
+        const std::uint32_t mantissaBits = (offset & 0x007fffffu) + 0x3f3504f3u;
+
+        float m;
+        std::memcpy(&m, &mantissaBits, sizeof(m));
+
+        // log2(m) = 2/ln2 * atanh(t), t = (m-1)/(m+1), |t| < 0.172
+        const float t = (m - 1.0f) / (m + 1.0f);
+        const float t2 = t * t;
+
+        return exponent + t * (2.8853900817779268f + t2 * (0.96179669392597560f
+            + t2 * (0.57707801635558536f + t2 * 0.41219858311113240f)));
+    }
+
+    inline float exp2Unchecked(float x) noexcept
+    {
+        // x + 127 > 0, die Konvertierung rundet also ab
+        const std::int32_t n = (std::int32_t)(x + 127.0f) - 127;
+        const float f = x - (float)n - 0.5f;    // -0.5 <= f < 0.5
+
+        // 2^(f + 0.5) als Taylor-Reihe um 0.5, Grad 6
+        const float p = 1.4142135623730951f + f * (0.98025814346854723f + f * (0.33973158418307492f
+            + f * (0.078494663241220702f + f * (0.013602088628663626f + f * (0.0018856498765369369f
+            + f * 0.00021783881590746446f)))));
+
+        const auto scaleBits = (std::uint32_t)(n + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &scaleBits, sizeof(scale));
+
+        return p * scale;
+    }
+
+    //==============================================================================
+    // Mit Bereichsprüfung: x <= 0 liefert log2 der kleinsten normalen Zahl (-126)
+    inline float log2Fast(float x) noexcept
+    {
+        return log2Unchecked(x >= 1.17549435e-38f ? x : 1.17549435e-38f);
+    }
+
+    inline float exp2Fast(float x) noexcept
+    {
+        return exp2Unchecked(juce::jlimit(-126.0f, 127.0f, x));
+    }
+
+    //==============================================================================
+    // Leistung -> dB (10 * log10), Werte <= 0 ergeben floorDb
+    inline float powerToDb(float power, float floorDb = -160.0f) noexcept
+    {
+        if (!(power > 0.0f))
+            return floorDb;
+
+        const float db = isExact() ? 10.0f * std::log10(power) : dbPerLog2Power * log2Fast(power);
+        return juce::jmax(floorDb, db);
+    }
+
+    // Amplitude -> dB (20 * log10), wie juce::Decibels::gainToDecibels
+    inline float gainToDb(float gain, float floorDb = -160.0f) noexcept
+    {
+        if (!(gain > 0.0f))
+            return floorDb;
+
+        const float db = isExact() ? 20.0f * std::log10(gain) : dbPerLog2Gain * log2Fast(gain);
+        return juce::jmax(floorDb, db);
+    }
+
+    // dB -> Leistung (10^(dB/10))
+    inline float dbToPower(float db) noexcept
+    {
+        return isExact() ? std::pow(10.0f, db * 0.1f) : exp2Fast(db * log2PowerPerDb);
+    }
+
+    // dB -> Amplitude (10^(dB/20)); ohne -100-dB-Schwelle von juce::Decibels
+    inline float dbToGain(float db) noexcept
+    {
+        return isExact() ? std::pow(10.0f, db * 0.05f) : exp2Fast(db * log2GainPerDb);
+    }
+
+    //==============================================================================
+    // Array-Varianten (vektorisiert); dest == source ist erlaubt
+    void powerToDb(float* dest, const float* source, int num, float floorDb = -160.0f) noexcept;
+    void gainToDb(float* dest, const float* source, int num, float floorDb = -160.0f) noexcept;
+    void dbToPower(float* dest, const float* source, int num) noexcept;
+    void dbToGain(float* dest, const float* source, int num) noexcept;
+}
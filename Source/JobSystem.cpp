@@ -0,0 +1,530 @@
+﻿#include "JobSystem.h"
+#include <atomic>
+#include <utility>
+
+//==============================================================================
+struct JobSystem::JobHandle::State
+{
+    std::atomic<bool> cancelled{ false };
+    std::atomic<bool> finished{ false };
+    juce::WaitableEvent done{ true };   // manuelles Reset: alle Wartenden wecken
+
+    void finish() noexcept
+    {
+        finished.store(true, std::memory_order_release);
+        done.signal();
+    }
+};
+
+void JobSystem::JobHandle::cancel() noexcept
+{
+    if (state != nullptr)
+        state->cancelled.store(true, std::memory_order_relaxed);
+}
+
+bool JobSystem::JobHandle::isCancelled() const noexcept
+{
+    return state != nullptr && state->cancelled.load(std::memory_order_relaxed);
+}
+
+bool JobSystem::JobHandle::isFinished() const noexcept
+{
+    return state == nullptr || state->finished.load(std::memory_order_acquire);
+}
+
+bool JobSystem::JobHandle::waitForCompletion(int timeoutMs) const
+{
+    return state == nullptr || state->done.wait((double)timeoutMs);
+}
+
+//==============================================================================
+namespace
+{
+    // Gesetzt auf Worker-Threads, damit parallelFor() den eigenen Scheduler findet
+    thread_local JobSystem* currentSystem = nullptr;
+    thread_local int currentWorkerIndex = -1;
+
+    // Nach dieser Zeit meldet der Destruktor (Debug) einen Job, der isCancelled()
+    // zu selten abfragt; gewartet wird trotzdem weiter, Worker werden nie hart beendet
+    constexpr int kSlowStopWarningMs = 2000;
+
+    // "0-3,6" -> Bits 0..3 und 6; ungültige Einträge und Kerne >= 32 werden ignoriert
+    juce::uint32 parseCpuList(const juce::String& text)
+    {
+        juce::uint32 mask = 0;
+
+        for (auto item : juce::StringArray::fromTokens(text, ",", ""))
+        {
+            item = item.trim();
+            if (!item.containsOnly("0123456789-") || item.isEmpty())
+                continue;
+
+            const int first = item.upToFirstOccurrenceOf("-", false, false).getIntValue();
+            const int last = item.contains("-") ? item.fromFirstOccurrenceOf("-", false, false).getIntValue() : first;
+
+            for (int cpu = juce::jmax(0, first); cpu <= juce::jmin(31, last); ++cpu)
+                mask |= (juce::uint32)1 << cpu;
+        }
+
+        return mask;
+    }
+
+    JobSystem::Options readOptionsFromEnvironment()
+    {
+        JobSystem::Options options;
+
+        auto env = [](const char* name)
+            {
+                return juce::SystemStats::getEnvironmentVariable(name, {}).trim();
+            };
+
+        options.numWorkers = juce::jmax(0, env("MASTERINGEQ_WORKERS").getIntValue());
+        options.maxConcurrency = juce::jmax(0, env("MASTERINGEQ_WORKER_CONCURRENCY").getIntValue());
+        options.affinityMask = parseCpuList(env("MASTERINGEQ_WORKER_CPUS"));
+
+        const auto priority = env("MASTERINGEQ_WORKER_PRIORITY").toLowerCase();
+        if (priority == "background")
+            options.threadPriority = juce::Thread::Priority::background;
+        else if (priority == "normal")
+            options.threadPriority = juce::Thread::Priority::normal;
+
+        return options;
+    }
+
+    std::mutex defaultOptionsMutex;
+    std::unique_ptr<JobSystem::Options> defaultOptions;   // erst beim ersten Zugriff gelesen
+}
+
+class JobSystem::Worker : public juce::Thread
+{
+public:
+    Worker(JobSystem& systemToUse, int indexToUse)
+        : juce::Thread("MasteringEQ Worker " + juce::String(indexToUse + 1)),
+          system(systemToUse), index(indexToUse)
+    {
+    }
+
+    void run() override
+    {
+        currentSystem = &system;
+        currentWorkerIndex = index;
+
+        Task task;
+        while (system.waitForTask(index, task))
+        {
+            setRunningJob(task.state);
+            task.run();
+            setRunningJob(nullptr);
+            task = {};
+        }
+    }
+
+    // Beim Herunterfahren: laufenden Job abbrechen, wartende Teilaufgaben herausgeben
+    std::deque<Task> cancelAndTakeQueue()
+    {
+        const std::lock_guard<std::mutex> lock(localMutex);
+
+        if (runningJob != nullptr)
+            runningJob->cancelled.store(true, std::memory_order_relaxed);
+
+        return std::exchange(localQueue, {});
+    }
+
+    std::mutex localMutex;
+    std::deque<Task> localQueue;    // Besitzer: hinten (LIFO), Diebe: vorne (FIFO)
+
+private:
+    void setRunningJob(std::shared_ptr<JobHandle::State> state)
+    {
+        const std::lock_guard<std::mutex> lock(localMutex);
+        runningJob = std::move(state);
+
+        // Nach cancelRunningJob() geholt: gleich als abgebrochen starten
+        if (runningJob != nullptr && system.shuttingDown.load())
+            runningJob->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    JobSystem& system;
+    const int index;
+    std::shared_ptr<JobHandle::State> runningJob;   // geschützt durch localMutex
+};
+
+//==============================================================================
+JobSystem::Options JobSystem::getDefaultOptions()
+{
+    const std::lock_guard<std::mutex> lock(defaultOptionsMutex);
+
+    if (defaultOptions == nullptr)
+        defaultOptions = std::make_unique<Options>(readOptionsFromEnvironment());
+
+    return *defaultOptions;
+}
+
+void JobSystem::setDefaultOptions(const Options& newOptions)
+{
+    const std::lock_guard<std::mutex> lock(defaultOptionsMutex);
+    defaultOptions = std::make_unique<Options>(newOptions);
+}
+
+//==============================================================================
+JobSystem::JobSystem()
+    : JobSystem(getDefaultOptions())
+{
+}
+
+/**
+ * @brief Startet die Worker-Threads.
+ *
+ * Ohne feste Anzahl bleibt ein Kern für Host und Audio-Thread frei; mit
+ * Affinitätsmaske gibt es einen Worker je erlaubtem Kern. Priorität und
+ * Maske gelten für alle Worker ab dem Start.
+ *
+ * @param optionsToUse Thread-Einstellungen
+ */
+JobSystem::JobSystem(const Options& optionsToUse)
+    : options(optionsToUse)
+{
+    int numWorkers = options.numWorkers;
+
+    if (numWorkers <= 0)
+    {
+        numWorkers = options.affinityMask != 0 ? juce::countNumberOfBits(options.affinityMask)
+                                               : juce::SystemStats::getNumCpus() - 1;
+        numWorkers = juce::jmax(1, numWorkers);
+    }
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back(std::make_unique<Worker>(*this, i));
+
+    setMaxConcurrency(options.maxConcurrency);
+
+    for (auto& worker : workers)
+    {
+        if (options.affinityMask != 0)
+            worker->setAffinityMask(options.affinityMask);
+
+        worker->startThread(options.threadPriority);
+    }
+}
+
+/**
+ * @brief Beendet alle Worker.
+ *
+ * Noch wartende Jobs werden sofort aus den Queues genommen und als
+ * abgebrochen abgeschlossen (sie laufen nicht mehr an, waitForCompletion
+ * kehrt für sie zurück). Laufende Jobs werden abgebrochen (isCancelled()
+ * wird true); der Destruktor wartet, bis sie enden. Jobs müssen
+ * isCancelled() deshalb regelmäßig abfragen (Analyse je Hop, Solver je
+ * Iteration bzw. Band), ein hart beendeter Thread könnte Locks halten.
+ */
+JobSystem::~JobSystem()
+{
+    std::deque<Task> abandoned;
+
+    auto takeAll = [&abandoned](std::deque<Task>& queue)
+        {
+            for (auto& task : queue)
+                abandoned.push_back(std::move(task));
+
+            queue.clear();
+        };
+
+    {
+        const std::lock_guard<std::mutex> lock(queueMutex);
+        shuttingDown.store(true);
+
+        for (auto& queue : globalQueues)
+            takeAll(queue);
+
+        numQueuedTasks = 0;
+    }
+
+    for (auto& worker : workers)
+    {
+        auto local = worker->cancelAndTakeQueue();
+        takeAll(local);
+    }
+
+    for (auto& task : abandoned)
+    {
+        if (task.state != nullptr)
+        {
+            task.state->cancelled.store(true, std::memory_order_relaxed);
+            task.state->finish();
+        }
+    }
+
+    wakeUp.notify_all();
+
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto& worker : workers)
+    {
+        if (!worker->waitForThreadToExit(kSlowStopWarningMs))
+        {
+            // Ein Job reagiert zu langsam auf den Abbruch
+            jassertfalse;
+            worker->waitForThreadToExit(-1);
+        }
+    }
+}
+
+//==============================================================================
+/**
+ * @brief Reiht einen Job in die Warteschlange seiner Priorität ein.
+ *
+ * @param job Arbeit; bekommt das eigene Handle zum Abfragen von isCancelled()
+ * @param priority Höhere Prioritäten werden zuerst gestartet
+ * @return Handle zum Abbrechen und Warten
+ */
+JobSystem::JobHandle JobSystem::submit(JobFunction job, Priority priority)
+{
+    auto state = std::make_shared<JobHandle::State>();
+
+    JobHandle handle;
+    handle.state = state;
+
+    Task task;
+    task.state = state;
+    task.run = [state, job = std::move(job)]
+        {
+            if (!state->cancelled.load(std::memory_order_relaxed))
+            {
+                JobHandle self;
+                self.state = state;
+                job(self);
+            }
+
+            state->finish();
+        };
+
+    {
+        const std::lock_guard<std::mutex> lock(queueMutex);
+
+        if (shuttingDown)
+        {
+            state->cancelled.store(true, std::memory_order_relaxed);
+            state->finish();
+            return handle;
+        }
+
+        globalQueues[(size_t)priority].push_back(std::move(task));
+        ++numQueuedTasks;
+    }
+
+    notifyWorkers();
+    return handle;
+}
+
+//==============================================================================
+/**
+ * @brief Begrenzt, wie viele Worker gleichzeitig Jobs ausführen.
+ *
+ * Senken wirkt, sobald die betroffenen Worker ihren aktuellen Job beendet
+ * haben; Anheben weckt schlafende Worker sofort.
+ *
+ * @param maxConcurrency Anzahl, 0 oder mehr als vorhanden = alle Worker
+ */
+void JobSystem::setMaxConcurrency(int maxConcurrency)
+{
+    const int numWorkers = getNumWorkers();
+    const int limit = maxConcurrency <= 0 ? numWorkers : juce::jmin(maxConcurrency, numWorkers);
+
+    {
+        const std::lock_guard<std::mutex> lock(queueMutex);
+        maxActiveWorkers.store(juce::jmax(1, limit), std::memory_order_relaxed);
+    }
+
+    wakeUp.notify_all();
+}
+
+/**
+ * @brief Weckt einen Worker für eine neue Aufgabe.
+ *
+ * Mit Begrenzung könnte notify_one einen schlafenden, gesperrten Worker
+ * treffen, der die Aufgabe liegen lässt; dann werden alle geweckt.
+ */
+void JobSystem::notifyWorkers()
+{
+    if (getMaxConcurrency() < getNumWorkers())
+        wakeUp.notify_all();
+    else
+        wakeUp.notify_one();
+}
+
+//==============================================================================
+void JobSystem::pushLocal(int workerIndex, Task task)
+{
+    auto& worker = *workers[(size_t)workerIndex];
+
+    {
+        const std::lock_guard<std::mutex> lock(worker.localMutex);
+        worker.localQueue.push_back(std::move(task));
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(queueMutex);
+        ++numQueuedTasks;
+    }
+
+    notifyWorkers();
+}
+
+bool JobSystem::popLocal(int workerIndex, Task& task)
+{
+    auto& worker = *workers[(size_t)workerIndex];
+
+    {
+        const std::lock_guard<std::mutex> lock(worker.localMutex);
+        if (worker.localQueue.empty())
+            return false;
+
+        task = std::move(worker.localQueue.back());
+        worker.localQueue.pop_back();
+    }
+
+    const std::lock_guard<std::mutex> lock(queueMutex);
+    --numQueuedTasks;
+    return true;
+}
+
+bool JobSystem::popGlobal(Task& task)
+{
+    const std::lock_guard<std::mutex> lock(queueMutex);
+
+    for (auto& queue : globalQueues)
+    {
+        if (!queue.empty())
+        {
+            task = std::move(queue.front());
+            queue.pop_front();
+            --numQueuedTasks;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::steal(int thiefIndex, Task& task)
+{
+    const int numWorkers = getNumWorkers();
+
+    for (int offset = 1; offset < numWorkers; ++offset)
+    {
+        auto& victim = *workers[(size_t)((thiefIndex + offset) % numWorkers)];
+
+        {
+            const std::lock_guard<std::mutex> lock(victim.localMutex);
+            if (victim.localQueue.empty())
+                continue;
+
+            task = std::move(victim.localQueue.front());
+            victim.localQueue.pop_front();
+        }
+
+        const std::lock_guard<std::mutex> lock(queueMutex);
+        --numQueuedTasks;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Holt die nächste Aufgabe für einen Worker oder schläft.
+ *
+ * Reihenfolge: eigene Teilaufgaben (laufende Arbeit zuerst fertig machen),
+ * globale Jobs nach Priorität, dann Teilaufgaben anderer Worker stehlen.
+ * Worker oberhalb der Gleichzeitigkeitsgrenze nehmen nichts an.
+ *
+ * @return false beim Herunterfahren
+ */
+bool JobSystem::waitForTask(int workerIndex, Task& task)
+{
+    for (;;)
+    {
+        // Vor dem Holen prüfen: nach dem Herunterfahren startet nichts mehr
+        if (shuttingDown.load())
+            return false;
+
+        const bool active = workerIndex < getMaxConcurrency();
+
+        if (active && (popLocal(workerIndex, task) || popGlobal(task) || steal(workerIndex, task)))
+            return true;
+
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        if (shuttingDown)
+            return false;
+
+        if (numQueuedTasks == 0 || workerIndex >= getMaxConcurrency())
+            wakeUp.wait(lock);
+    }
+}
+
+//==============================================================================
+/**
+ * @brief Verteilt eine Schleife auf die Worker.
+ *
+ * Die Indizes werden über einen gemeinsamen Zähler vergeben, ungleich
+ * teure Iterationen gleichen sich so aus. Helfer, die erst starten wenn
+ * alles vergeben ist, kehren sofort zurück; der Zustand gehört ihnen
+ * gemeinsam (shared_ptr), body wird danach nicht mehr angefasst.
+ *
+ * @param begin Erster Index
+ * @param end Index hinter dem letzten
+ * @param body Schleifenrumpf, muss für verschiedene i parallel laufen dürfen
+ */
+void JobSystem::parallelFor(int begin, int end, const std::function<void(int)>& body)
+{
+    const int count = end - begin;
+    if (count <= 0)
+        return;
+
+    auto* system = currentSystem;
+
+    if (system == nullptr || count == 1 || system->getMaxConcurrency() < 2)
+    {
+        for (int i = begin; i < end; ++i)
+            body(i);
+
+        return;
+    }
+
+    struct LoopState
+    {
+        std::atomic<int> next{ 0 };
+        std::atomic<int> completed{ 0 };
+        int end = 0;
+        int count = 0;
+        const std::function<void(int)>* body = nullptr;
+        juce::WaitableEvent done;
+    };
+
+    auto loop = std::make_shared<LoopState>();
+    loop->next.store(begin);
+    loop->end = end;
+    loop->count = count;
+    loop->body = &body;
+
+    auto work = [loop]
+        {
+            for (int i = loop->next.fetch_add(1); i < loop->end; i = loop->next.fetch_add(1))
+            {
+                (*loop->body)(i);
+
+                if (loop->completed.fetch_add(1) + 1 == loop->count)
+                    loop->done.signal();
+            }
+        };
+
+    const int numHelpers = juce::jmin(count, system->getMaxConcurrency()) - 1;
+
+    for (int h = 0; h < numHelpers; ++h)
+        system->pushLocal(currentWorkerIndex, Task{ work, nullptr });
+
+    work();
+    loop->done.wait(-1.0);
+}
@@ -0,0 +1,128 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+//==============================================================================
+// Prozessweiter Work-Stealing-Scheduler für Hintergrundarbeit
+//
+// Alle Plugin-Instanzen teilen sich eine Instanz über
+//   juce::SharedResourcePointer<JobSystem>
+// Sie lebt, solange mindestens ein Editor sie hält; die Threadzahl ist durch
+// die Kernzahl begrenzt statt durch die Zahl offener Editoren.
+//
+// Jobs (submit) landen je Priorität in einer globalen Warteschlange.
+// Innerhalb eines Jobs verteilt parallelFor() Teilaufgaben in die lokale
+// Deque des Workers, freie Worker stehlen von dort. Abbrechen: noch nicht
+// gestartete Jobs laufen gar nicht, laufende fragen isCancelled() ab.
+//
+// Die Worker laufen standardmäßig mit niedriger Thread-Priorität, damit
+// Analyse und Solver auch auf ausgelasteten Rechnern nicht mit den
+// Audio-Threads des Hosts konkurrieren (siehe Options).
+class JobSystem
+{
+public:
+    enum class Priority
+    {
+        high,       // Nutzer wartet (Auto-EQ)
+        normal,     // Analyse im Hintergrund (Referenz)
+        low         // Caches, Vorberechnungen
+    };
+
+    static constexpr int numPriorities = 3;
+
+    //==============================================================================
+    // Handle auf einen eingereichten Job (kopierbar, leeres Handle = kein Job)
+    class JobHandle
+    {
+    public:
+        JobHandle() = default;
+
+        void cancel() noexcept;
+        bool isCancelled() const noexcept;
+        bool isFinished() const noexcept;   // auch true für ein leeres Handle
+
+        // false bei Timeout; timeoutMs < 0 = unbegrenzt
+        bool waitForCompletion(int timeoutMs = -1) const;
+
+    private:
+        friend class JobSystem;
+        struct State;
+        std::shared_ptr<State> state;
+    };
+
+    using JobFunction = std::function<void(const JobHandle&)>;
+
+    //==============================================================================
+    // Thread-Einstellungen der Worker
+    struct Options
+    {
+        int numWorkers = 0;             // 0 = Kerne - 1 bzw. Kerne der Maske (mindestens 1)
+        int maxConcurrency = 0;         // gleichzeitig arbeitende Worker, 0 = alle
+        juce::Thread::Priority threadPriority = juce::Thread::Priority::low;
+        juce::uint32 affinityMask = 0;  // Bit n = Kern n, 0 = keine Einschränkung
+    };
+
+    // Einstellungen für die geteilte Instanz (SharedResourcePointer).
+    // Vorbelegt aus den Umgebungsvariablen
+    //   MASTERINGEQ_WORKERS=<n>, MASTERINGEQ_WORKER_CONCURRENCY=<n>,
+    //   MASTERINGEQ_WORKER_PRIORITY=background|low|normal,
+    //   MASTERINGEQ_WORKER_CPUS=<Liste, z.B. "2-5,7">
+    // setDefaultOptions() wirkt erst für die nächste erzeugte Instanz.
+    static Options getDefaultOptions();
+    static void setDefaultOptions(const Options& options);
+
+    JobSystem();
+    explicit JobSystem(const Options& options);
+    ~JobSystem();
+
+    JobHandle submit(JobFunction job, Priority priority = Priority::normal);
+
+    int getNumWorkers() const noexcept { return (int)workers.size(); }
+
+    // Zur Laufzeit änderbar; überzählige Worker schlafen nach ihrem
+    // aktuellen Job ein. 0 = alle Worker.
+    void setMaxConcurrency(int maxConcurrency);
+    int getMaxConcurrency() const noexcept { return maxActiveWorkers.load(std::memory_order_relaxed); }
+
+    const Options& getOptions() const noexcept { return options; }
+
+    // body(i) für alle i in [begin, end). Auf einem Worker-Thread helfen freie
+    // Worker mit, sonst (Message-Thread, Tools) läuft die Schleife seriell.
+    // Kehrt erst zurück, wenn alle Indizes fertig sind.
+    static void parallelFor(int begin, int end, const std::function<void(int)>& body);
+
+private:
+    class Worker;
+
+    struct Task
+    {
+        std::function<void()> run;
+        std::shared_ptr<JobHandle::State> state;   // nullptr = Teilaufgabe von parallelFor
+    };
+
+    void pushLocal(int workerIndex, Task task);
+    bool popLocal(int workerIndex, Task& task);
+    bool popGlobal(Task& task);
+    bool steal(int thiefIndex, Task& task);
+    bool waitForTask(int workerIndex, Task& task);
+    void notifyWorkers();
+
+    const Options options;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<int> maxActiveWorkers{ 1 };        // Worker mit Index >= Grenze schlafen
+
+    std::mutex queueMutex;                         // globale Queues + Aufwecken
+    std::condition_variable wakeUp;
+    std::array<std::deque<Task>, numPriorities> globalQueues;
+    int numQueuedTasks = 0;                        // global + lokal, geschützt durch queueMutex
+    std::atomic<bool> shuttingDown{ false };       // gesetzt unter queueMutex
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JobSystem)
+};
@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstring>
+
+//==============================================================================
+// Zeiten je draw*-Funktion (für den GUI-Benchmark)
+//
+// Der Editor hält nur einen Zeiger; ist er nullptr, kostet ein Scope einen
+// Vergleich und liest keinen Timer. Namen müssen String-Literale sein,
+// Zeiten sind inklusive verschachtelter Aufrufe (drawSpectrumArea enthält
+// z.B. drawFrame). Nur Message-Thread, keine Allokationen.
+class PaintProfiler
+{
+public:
+    struct Entry
+    {
+        const char* name = nullptr;
+        double totalMs = 0.0;
+        int calls = 0;
+    };
+
+    static constexpr int maxEntries = 48;
+
+    void add(const char* name, double ms) noexcept
+    {
+        for (int i = 0; i < numEntries; ++i)
+        {
+            auto& e = entries[(size_t)i];
+            if (e.name == name || std::strcmp(e.name, name) == 0)
+            {
+                e.totalMs += ms;
+                ++e.calls;
+                return;
+            }
+        }
+
+        if (numEntries < maxEntries)
+            entries[(size_t)numEntries++] = { name, ms, 1 };
+    }
+
+    void reset() noexcept { numEntries = 0; }
+
+    int getNumEntries() const noexcept { return numEntries; }
+    const Entry& getEntry(int index) const noexcept { return entries[(size_t)index]; }
+
+    //==============================================================================
+    class Scope
+    {
+    public:
+        Scope(PaintProfiler* profilerToUse, const char* nameToUse) noexcept
+            : profiler(profilerToUse), name(nameToUse),
+              startTicks(profilerToUse != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (profiler != nullptr)
+                profiler->add(name, 1000.0 * juce::Time::highResolutionTicksToSeconds(
+                    juce::Time::getHighResolutionTicks() - startTicks));
+        }
+
+    private:
+        PaintProfiler* profiler;
+        const char* name;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+private:
+    std::array<Entry, maxEntries> entries{};
+    int numEntries = 0;
+};
@@ -0,0 +1,93 @@
+﻿#include "PerformanceCounters.h"
+
+//==============================================================================
+/**
+ * @brief Anzahl aller erfassten processBlock-Aufrufe (Summe des Histogramms).
+ */
+std::uint64_t PerformanceCounters::getNumBlocks() const noexcept
+{
+    std::uint64_t total = 0;
+
+    for (const auto& bucket : loadHistogram)
+        total += bucket.load(std::memory_order_relaxed);
+
+    return total;
+}
+
+/**
+ * @brief Sekunden seit Beginn der Health-Zählung (Konstruktion oder resetAll).
+ */
+double PerformanceCounters::getHealthSeconds() const noexcept
+{
+    return 0.001 * (juce::Time::getMillisecondCounterHiRes() - healthStartMs.load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief Setzt alle Zähler zurück.
+ *
+ * Läuft der Audio-Thread parallel, kann ein gleichzeitiges Inkrement
+ * verloren gehen; für Statistik ist das unerheblich.
+ */
+void PerformanceCounters::resetAll() noexcept
+{
+    audioLoad.store(0.0f, std::memory_order_relaxed);
+    resetWorstCase();
+
+    for (auto& bucket : loadHistogram)
+        bucket.store(0, std::memory_order_relaxed);
+
+    analyzerFramesProduced.store(0, std::memory_order_relaxed);
+    analyzerFramesDropped.store(0, std::memory_order_relaxed);
+    coefficientRebuilds.store(0, std::memory_order_relaxed);
+    measurementFramesExpected.store(0, std::memory_order_relaxed);
+    measurementFramesCaptured.store(0, std::memory_order_relaxed);
+
+    healthStartMs.store(juce::Time::getMillisecondCounterHiRes(), std::memory_order_relaxed);
+}
+
+//==============================================================================
+/**
+ * @brief Alle Kennzahlen als CSV.
+ *
+ * Raten beziehen sich auf die Zeit seit Beginn der Zählung. Die
+ * Histogramm-Zeilen tragen die untere Bucket-Grenze relativ zur
+ * Deadline im Namen (1 = Block so lang wie seine Echtzeitdauer).
+ *
+ * @return CSV-Text mit Kopfzeile
+ */
+juce::String PerformanceCounters::toCsv() const
+{
+    const double seconds = getHealthSeconds();
+    const auto rebuilds = coefficientRebuilds.load(std::memory_order_relaxed);
+
+    juce::String csv;
+    csv << "metric,value\n";
+
+    auto add = [&csv](const char* name, const juce::String& value)
+        {
+            csv << name << "," << value << "\n";
+        };
+
+    add("seconds", juce::String(seconds, 3));
+    add("blocks", juce::String((juce::int64)getNumBlocks()));
+    add("blockOverruns", juce::String((juce::int64)blockOverruns.load(std::memory_order_relaxed)));
+    add("worstBlockMs", juce::String(worstBlockMs.load(std::memory_order_relaxed), 4));
+    add("worstBlockDeadlineMs", juce::String(worstBlockDeadlineMs.load(std::memory_order_relaxed), 4));
+    add("analyzerFramesProduced", juce::String((juce::int64)analyzerFramesProduced.load(std::memory_order_relaxed)));
+    add("analyzerFramesDropped", juce::String((juce::int64)analyzerFramesDropped.load(std::memory_order_relaxed)));
+    add("coefficientRebuilds", juce::String((juce::int64)rebuilds));
+    add("coefficientRebuildsPerSecond", juce::String(seconds > 0.0 ? (double)rebuilds / seconds : 0.0, 1));
+    add("measurementFramesExpected", juce::String((juce::int64)measurementFramesExpected.load(std::memory_order_relaxed)));
+    add("measurementFramesCaptured", juce::String((juce::int64)measurementFramesCaptured.load(std::memory_order_relaxed)));
+
+    for (int b = 0; b < loadHistogramBuckets; ++b)
+        csv << "blockLoad." << juce::String(getLoadBucketLowerEdge(b), 4) << ","
+            << juce::String((juce::int64)loadHistogram[(size_t)b].load(std::memory_order_relaxed)) << "\n";
+
+    return csv;
+}
+
+bool PerformanceCounters::writeCsv(const juce::File& file) const
+{
+    return file.replaceWithText(toCsv(), false, false, "\n");
+}
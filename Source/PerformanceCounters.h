@@ -0,0 +1,126 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+//==============================================================================
+// Lock-freie Laufzeitzähler für das Performance-HUD
+//
+// Schreiber: Audio-Thread (processBlock, FIFOs), Message-Thread (FFT, paint)
+// und Auto-EQ-Job. Leser: HUD im Message-Thread. Alles relaxed atomics,
+// keine Locks, keine Allokationen -> der Audio-Thread wird nicht gestört.
+//
+// Die Health-Zähler (Histogramm, Koeffizienten, Messung) laufen immer mit
+// und lassen sich als CSV sichern, z.B. nach einem nächtlichen Render oder
+// einer Live-Show.
+struct PerformanceCounters
+{
+    // Blockdauer/Deadline in Halboktav-Buckets: Bucket 0 = unter 1/64,
+    // Bucket b ab 2^((b - 13) / 2), der letzte ab 16-facher Deadline
+    static constexpr int loadHistogramBuckets = 22;
+
+    //==============================================================================
+    // Audio-Thread
+    std::atomic<float> audioLoad{ 0.0f };               // geglättet: Blockdauer / Deadline
+    std::atomic<float> worstBlockMs{ 0.0f };            // längster processBlock seit Reset
+    std::atomic<float> worstBlockDeadlineMs{ 0.0f };    // Deadline des längsten Blocks
+    std::atomic<std::uint64_t> blockOverruns{ 0 };      // Blöcke länger als ihre Deadline
+    std::array<std::atomic<std::uint64_t>, loadHistogramBuckets> loadHistogram{};
+
+    // Neu berechnete Koeffizientensätze (je Band: Parameter, adaptive Rampe, Morph)
+    std::atomic<std::uint64_t> coefficientRebuilds{ 0 };
+
+    // Messung: Pre-EQ-Frames, die der Audio-Thread geliefert hat / die übernommen wurden
+    std::atomic<std::uint64_t> measurementFramesExpected{ 0 };
+    std::atomic<std::uint64_t> measurementFramesCaptured{ 0 };
+
+    // Analyzer (Post-EQ FIFO): an GUI übergeben / verworfen weil GUI noch nicht abgeholt hat
+    std::atomic<std::uint64_t> analyzerFramesProduced{ 0 };
+    std::atomic<std::uint64_t> analyzerFramesDropped{ 0 };
+
+    //==============================================================================
+    // Message-Thread
+    std::atomic<float> fftMs{ 0.0f };                   // letzte updateSpectrumArray-Dauer
+    std::atomic<float> paintMs{ 0.0f };                 // letzte paint()-Dauer
+    std::atomic<std::int64_t> allocationsPerFrame{ -1 };// -1 = Zählung nicht einkompiliert
+
+    //==============================================================================
+    // Auto-EQ-Job
+    std::atomic<float> lastAutoEqSolveMs{ -1.0f };      // -1 = noch kein Solve
+    std::atomic<juce::uint32> lastAutoEqSolveTime{ 0 }; // Millisecond-Counter beim Ende
+
+    // Beginn der Health-Zählung (für Raten pro Sekunde)
+    std::atomic<double> healthStartMs{ juce::Time::getMillisecondCounterHiRes() };
+
+    //==============================================================================
+    // Audio-Thread: Dauer eines processBlock eintragen
+    void recordBlock(double durationMs, double deadlineMs) noexcept
+    {
+        if (deadlineMs <= 0.0)
+            return;
+
+        const float load = (float)(durationMs / deadlineMs);
+        const float smoothed = audioLoad.load(std::memory_order_relaxed);
+        audioLoad.store(smoothed + 0.05f * (load - smoothed), std::memory_order_relaxed);
+
+        if (load > 1.0f)
+            blockOverruns.fetch_add(1, std::memory_order_relaxed);
+
+        loadHistogram[(size_t)getLoadBucket(load)].fetch_add(1, std::memory_order_relaxed);
+
+        // Nur der Audio-Thread schreibt worstBlock*, daher reicht load/store
+        if ((float)durationMs > worstBlockMs.load(std::memory_order_relaxed))
+        {
+            worstBlockMs.store((float)durationMs, std::memory_order_relaxed);
+            worstBlockDeadlineMs.store((float)deadlineMs, std::memory_order_relaxed);
+        }
+    }
+
+    // Message-Thread: Worst-Case zurücksetzen (z.B. per Klick im HUD)
+    void resetWorstCase() noexcept
+    {
+        worstBlockMs.store(0.0f, std::memory_order_relaxed);
+        worstBlockDeadlineMs.store(0.0f, std::memory_order_relaxed);
+        blockOverruns.store(0, std::memory_order_relaxed);
+    }
+
+    void recordAutoEqSolve(double durationMs) noexcept
+    {
+        lastAutoEqSolveMs.store((float)durationMs, std::memory_order_relaxed);
+        lastAutoEqSolveTime.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    // Health-Zähler
+    // Bucket ohne log2: frexp liefert Mantisse in [0.5, 1) und Exponent
+    static int getLoadBucket(float load) noexcept
+    {
+        if (!(load > 0.0f))
+            return 0;
+
+        int exponent = 0;
+        const float mantissa = std::frexp(load, &exponent);
+        const int halfOctave = 2 * exponent - (mantissa < 0.70710678f ? 2 : 1); // floor(2 * log2(load))
+
+        return juce::jlimit(0, loadHistogramBuckets - 1, halfOctave + 13);
+    }
+
+    // Untere Grenze eines Buckets als Vielfaches der Deadline (Bucket 0: 0)
+    static double getLoadBucketLowerEdge(int bucket) noexcept
+    {
+        return bucket <= 0 ? 0.0 : std::exp2(0.5 * (double)(bucket - 13));
+    }
+
+    std::uint64_t getNumBlocks() const noexcept;
+    double getHealthSeconds() const noexcept;
+
+    // Alle Zähler auf 0 (z.B. vor einer neuen Datei im Batch-Render)
+    void resetAll() noexcept;
+
+    // Eine Zeile je Kennzahl: "metric,value"; Histogramm als "blockLoad.<untere Grenze>"
+    juce::String toCsv() const;
+    bool writeCsv(const juce::File& file) const;
+};
@@ -0,0 +1,216 @@
+﻿/**
+ * @file PerformanceHud.cpp
+ * @brief Performance-Overlay des Editors.
+ */
+
+#include "PerformanceHud.h"
+
+/**
+ * @brief Konstruktor des HUDs.
+ *
+ * Das HUD fängt keine Klicks der darunterliegenden Elemente ab,
+ * außer direkt auf seiner eigenen Fläche (Reset der Worst-Case-Werte)
+ * und auf den Trace-/CSV-Buttons.
+ *
+ * @param countersToShow Zähler des Processors
+ */
+PerformanceHud::PerformanceHud(PerformanceCounters& countersToShow)
+    : counters(countersToShow)
+{
+    setOpaque(false);
+    setInterceptsMouseClicks(true, true);
+
+    traceButton.setButtonText(TraceRecorder::isRecording() ? "Stop" : "Trace");
+    traceButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff22262d));
+    traceButton.onClick = [this] { toggleTrace(); };
+    addAndMakeVisible(traceButton);
+
+    csvButton.setButtonText("CSV");
+    csvButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff22262d));
+    csvButton.onClick = [this] { saveHealthCsv(); };
+    addAndMakeVisible(csvButton);
+}
+
+PerformanceHud::~PerformanceHud()
+{
+    stopTimer();
+}
+
+/**
+ * @brief Timer nur laufen lassen, solange das HUD sichtbar ist.
+ */
+void PerformanceHud::visibilityChanged()
+{
+    if (isVisible())
+    {
+        lastFramesProduced = counters.analyzerFramesProduced.load(std::memory_order_relaxed);
+        lastFramesDropped = counters.analyzerFramesDropped.load(std::memory_order_relaxed);
+        lastCoefficientRebuilds = counters.coefficientRebuilds.load(std::memory_order_relaxed);
+        lastRateTimeMs = juce::Time::getMillisecondCounterHiRes();
+        producedPerSecond = droppedPerSecond = rebuildsPerSecond = 0.0f;
+
+        startTimerHz(refreshRateHz);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void PerformanceHud::resized()
+{
+    traceButton.setBounds(getWidth() - 56, getHeight() - 22, 50, 18);
+    csvButton.setBounds(traceButton.getX() - 46, traceButton.getY(), 40, 18);
+}
+
+/**
+ * @brief Sichert die Health-Zähler dieser Instanz als CSV auf dem Schreibtisch.
+ */
+void PerformanceHud::saveHealthCsv()
+{
+    const auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+        .getChildFile("MasteringEQ-Health-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".csv")
+        .getNonexistentSibling();
+
+    if (counters.writeCsv(file))
+        file.revealToUser();
+}
+
+/**
+ * @brief Startet oder beendet die Trace-Aufnahme.
+ *
+ * Die Aufnahme gilt für den ganzen Prozess, ein zweites HUD sieht also
+ * denselben Zustand. Beim Beenden wird die Datei geschrieben und im
+ * Dateimanager angezeigt.
+ */
+void PerformanceHud::toggleTrace()
+{
+    if (!TraceRecorder::isRecording())
+    {
+        TraceRecorder::start();
+        lastTraceFileName.clear();
+    }
+    else
+    {
+        TraceRecorder::stop();
+
+        const auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+            .getChildFile("MasteringEQ-Trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+
+        if (TraceRecorder::writeChromeTrace(file))
+        {
+            lastTraceFileName = file.getFileName();
+            file.revealToUser();
+        }
+        else
+        {
+            lastTraceFileName = "Schreiben fehlgeschlagen";
+        }
+    }
+
+    traceButton.setButtonText(TraceRecorder::isRecording() ? "Stop" : "Trace");
+    repaint();
+}
+
+/**
+ * @brief Berechnet die Analyzer-Raten und zeichnet neu.
+ */
+void PerformanceHud::timerCallback()
+{
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const double elapsedSec = 0.001 * (now - lastRateTimeMs);
+
+    if (elapsedSec > 0.0)
+    {
+        const auto produced = counters.analyzerFramesProduced.load(std::memory_order_relaxed);
+        const auto dropped = counters.analyzerFramesDropped.load(std::memory_order_relaxed);
+        const auto rebuilds = counters.coefficientRebuilds.load(std::memory_order_relaxed);
+
+        producedPerSecond = (float)((double)(produced - lastFramesProduced) / elapsedSec);
+        droppedPerSecond = (float)((double)(dropped - lastFramesDropped) / elapsedSec);
+        rebuildsPerSecond = (float)((double)(rebuilds - lastCoefficientRebuilds) / elapsedSec);
+
+        lastFramesProduced = produced;
+        lastFramesDropped = dropped;
+        lastCoefficientRebuilds = rebuilds;
+        lastRateTimeMs = now;
+    }
+
+    // Aufnahme kann auch aus einer anderen Instanz gestartet worden sein
+    traceButton.setButtonText(TraceRecorder::isRecording() ? "Stop" : "Trace");
+
+    repaint();
+}
+
+/**
+ * @brief Klick auf das HUD setzt die Worst-Case-Werte zurück.
+ */
+void PerformanceHud::mouseDown(const juce::MouseEvent&)
+{
+    counters.resetWorstCase();
+    repaint();
+}
+
+/**
+ * @brief Zeichnet die aktuellen Werte als Textblock.
+ *
+ * @param g Der Graphics-Kontext zum Zeichnen
+ */
+void PerformanceHud::paint(juce::Graphics& g)
+{
+    auto area = getLocalBounds().toFloat();
+
+    g.setColour(juce::Colours::black.withAlpha(0.7f));
+    g.fillRoundedRectangle(area, 4.0f);
+
+    const float load = counters.audioLoad.load(std::memory_order_relaxed);
+    const float worstMs = counters.worstBlockMs.load(std::memory_order_relaxed);
+    const float worstDeadlineMs = counters.worstBlockDeadlineMs.load(std::memory_order_relaxed);
+    const auto overruns = counters.blockOverruns.load(std::memory_order_relaxed);
+    const auto allocations = counters.allocationsPerFrame.load(std::memory_order_relaxed);
+    const float solveMs = counters.lastAutoEqSolveMs.load(std::memory_order_relaxed);
+
+    juce::StringArray lines;
+    lines.add("Audio-Last: " + juce::String(load * 100.0f, 1) + " %");
+    lines.add("processBlock max: " + juce::String(worstMs, 3) + " / " + juce::String(worstDeadlineMs, 2)
+        + " ms (" + juce::String((juce::int64)overruns) + " Overruns)");
+    lines.add("Analyzer: " + juce::String(producedPerSecond, 1) + " Frames/s, "
+        + juce::String(droppedPerSecond, 1) + " verworfen/s");
+    lines.add("FFT: " + juce::String(counters.fftMs.load(std::memory_order_relaxed), 3) + " ms   paint: "
+        + juce::String(counters.paintMs.load(std::memory_order_relaxed), 3) + " ms");
+    lines.add("Allokationen/Frame: " + (allocations < 0 ? juce::String("n/a") : juce::String(allocations)));
+    lines.add("Koeffizienten: " + juce::String(rebuildsPerSecond, 0) + "/s   Messung: "
+        + juce::String((juce::int64)counters.measurementFramesCaptured.load(std::memory_order_relaxed)) + " / "
+        + juce::String((juce::int64)counters.measurementFramesExpected.load(std::memory_order_relaxed)) + " Frames");
+
+    if (solveMs < 0.0f)
+    {
+        lines.add("Auto-EQ: noch kein Solve");
+    }
+    else
+    {
+        const auto agoSec = (juce::Time::getMillisecondCounter()
+            - counters.lastAutoEqSolveTime.load(std::memory_order_relaxed)) / 1000u;
+        lines.add("Auto-EQ: " + juce::String(solveMs, 1) + " ms (vor " + juce::String(agoSec) + " s)");
+    }
+
+    if (TraceRecorder::isRecording())
+    {
+        const auto dropped = TraceRecorder::getNumDroppedEvents();
+        lines.add("Trace: aktiv" + (dropped > 0 ? " (" + juce::String((juce::int64)dropped) + " verworfen)" : juce::String()));
+    }
+    else
+    {
+        lines.add("Trace: " + (lastTraceFileName.isNotEmpty() ? lastTraceFileName : juce::String("aus")));
+    }
+
+    // Überlast rot markieren
+    g.setColour(load > 0.8f || overruns > 0 ? juce::Colour(0xffe74c3c) : juce::Colours::white.withAlpha(0.85f));
+    g.setFont(12.0f);
+
+    const int lineHeight = 15;
+    auto textArea = getLocalBounds().reduced(6, 4);
+
+    for (const auto& line : lines)
+        g.drawText(line, textArea.removeFromTop(lineHeight), juce::Justification::centredLeft, false);
+}
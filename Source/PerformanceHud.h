@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+#include "PerformanceCounters.h"
+#include "TraceRecorder.h"
+
+//==============================================================================
+// Einblendbares Overlay mit Laufzeitwerten aus den PerformanceCounters
+//
+// Liest nur (relaxed atomics) und aktualisiert sich mit eigenem langsamen
+// Timer, solange es sichtbar ist. Klick setzt die Worst-Case-Werte zurück.
+// Der Trace-Button startet/stoppt die prozessweite Aufnahme (alle Instanzen)
+// und legt die Chrome-Trace-Datei auf dem Schreibtisch ab, der CSV-Button
+// sichert die Health-Zähler dieser Instanz dort.
+class PerformanceHud : public juce::Component,
+    private juce::Timer
+{
+public:
+    explicit PerformanceHud(PerformanceCounters& countersToShow);
+    ~PerformanceHud() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void mouseDown(const juce::MouseEvent&) override;
+    void visibilityChanged() override;
+
+private:
+    void timerCallback() override;
+    void toggleTrace();
+    void saveHealthCsv();
+
+    PerformanceCounters& counters;
+
+    // Für Frames/s aus den Zählerständen
+    std::uint64_t lastFramesProduced = 0;
+    std::uint64_t lastFramesDropped = 0;
+    double lastRateTimeMs = 0.0;
+    float producedPerSecond = 0.0f;
+    float droppedPerSecond = 0.0f;
+    std::uint64_t lastCoefficientRebuilds = 0;
+    float rebuildsPerSecond = 0.0f;
+
+    juce::TextButton traceButton;
+    juce::TextButton csvButton;
+    juce::String lastTraceFileName;
+
+    static constexpr int refreshRateHz = 4;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceHud)
+};
@@ -12,6 +12,10 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "AllocationCounter.h"
+#include "AutoEqSolver.h"
+#include "CurveMath.h"
+#include "ReferenceAnalysis.h"
 #include <algorithm>
 #include <limits>
 #include <complex>
@@ -59,122 +63,22 @@ namespace
     constexpr float kRefViewMinDb = -100.0f;  // unten
     constexpr float kRefViewMaxDb = -35.0f;  // oben
 
-    // Rand-Fade: Bass & Air entschärfen
-    static float edgeWeight(float f)
-    {
-        // Fade-in 20..40 Hz
-        if (f < 40.0f)
-            return juce::jlimit(0.0f, 1.0f, juce::jmap(f, 20.0f, 40.0f, 0.0f, 1.0f));
-
-        // Fade-out 16k..20k
-        if (f > 16000.0f)
-            return juce::jlimit(0.0f, 1.0f, juce::jmap(f, 16000.0f, 20000.0f, 1.0f, 0.0f));
-
-        return 1.0f;
-    }
+    // Frame-Scheduling (VBlank-getaktet)
+    constexpr int kMeasurementTimerHz = 30;     // Pre-EQ Snapshots während der Messung
+    constexpr double kMaxFrameRateHz = 60.0;    // Obergrenze, auch bei 120/144 Hz Displays
+    constexpr double kMinFrameRateHz = 15.0;    // Untergrenze bei teurem paint()
+    constexpr double kPaintBudgetShare = 0.5;   // paint() darf max. diesen Anteil eines Frames kosten
 
     static inline bool isFinite(float x) noexcept
     {
         return std::isfinite(x);
     }
 
-    static inline float finiteOr(float x, float fallback) noexcept
-    {
-        return std::isfinite(x) ? x : fallback;
-    }
-
-    static inline float finiteClamp(float x, float lo, float hi, float fallback = 0.0f) noexcept
-    {
-        if (!std::isfinite(x)) return fallback;
-        return juce::jlimit(lo, hi, x);
-    }
-
-    // Breitband-Smoothing (Moving Average)
-    static std::vector<float> smoothMovingAverage(const std::vector<float>& in, int windowSize, int passes)
-    {
-        if ((int)in.size() < 3 || windowSize < 3)
-            return in;
-
-        std::vector<float> cur = in;
-        std::vector<float> out(in.size());
-        const int half = windowSize / 2;
-
-        for (int pass = 0; pass < passes; ++pass)
-        {
-            for (int i = 0; i < (int)cur.size(); ++i)
-            {
-                double sum = 0.0;
-                int count = 0;
-
-                for (int j = -half; j <= half; ++j)
-                {
-                    const int idx = i + j;
-                    if (idx >= 0 && idx < (int)cur.size())
-                    {
-                        sum += cur[(size_t)idx];
-                        ++count;
-                    }
-                }
-
-                out[(size_t)i] = (count > 0) ? (float)(sum / (double)count) : cur[(size_t)i];
-            }
-            cur.swap(out);
-        }
-
-        return cur;
-    }
-
-    static void postProcessReferenceBands(std::vector<AudioPluginAudioProcessor::ReferenceBand>& bands)
-    {
-        if (bands.size() < 3) return;
-
-        std::vector<float> p10, med, p90;
-        p10.reserve(bands.size());
-        med.reserve(bands.size());
-        p90.reserve(bands.size());
-
-        for (auto& b : bands)
-        {
-            p10.push_back(b.p10);
-            med.push_back(b.median);
-            p90.push_back(b.p90);
-        }
-
-        p10 = smoothMovingAverage(p10, 5, 2);
-        med = smoothMovingAverage(med, 5, 2);
-        p90 = smoothMovingAverage(p90, 5, 2);
-
-        constexpr float kSpreadShrink = 0.55f;
-        constexpr float kMaxBandWidthDb = 6.0f;
-        constexpr float kMinBandWidthDb = 1.0f;
-
-        for (size_t i = 0; i < bands.size(); ++i)
-        {
-            const float m = med[i];
-
-            float lo = m - kSpreadShrink * (m - p10[i]);
-            float hi = m + kSpreadShrink * (p90[i] - m);
-
-            float w = hi - lo;
-            if (w > kMaxBandWidthDb)
-            {
-                lo = m - 0.5f * kMaxBandWidthDb;
-                hi = m + 0.5f * kMaxBandWidthDb;
-            }
-            else if (w < kMinBandWidthDb)
-            {
-                lo = m - 0.5f * kMinBandWidthDb;
-                hi = m + 0.5f * kMinBandWidthDb;
-            }
-
-            if (lo > m) lo = m;
-            if (hi < m) hi = m;
-
-            bands[i].p10 = lo;
-            bands[i].median = m;
-            bands[i].p90 = hi;
-        }
-    }
+    // Gemeinsame Kurven-Helfer (auch von Auto-EQ und Offline-Tools genutzt)
+    using CurveMath::edgeWeight;
+    using CurveMath::finiteClamp;
+    using CurveMath::smoothMovingAverage;
+    using ReferenceAnalysis::postProcessReferenceBands;
 }
 
 //==============================================================================
@@ -183,70 +87,8 @@ namespace
 
 namespace
 {
-    static float sampleLogInterpolatedSpectrum(
-        const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& pts,
-        float fHz,
-        float fallbackDb)
-    {
-        if (pts.empty())
-            return fallbackDb;
-
-        if (fHz <= pts.front().frequency) return pts.front().level;
-        if (fHz >= pts.back().frequency)  return pts.back().level;
-
-        const float lf = std::log10(fHz);
-
-        for (size_t i = 1; i < pts.size(); ++i)
-        {
-            const float f1 = pts[i].frequency;
-            if (f1 >= fHz)
-            {
-                const float f0 = pts[i - 1].frequency;
-
-                const float l0 = std::log10(f0);
-                const float l1 = std::log10(f1);
-
-                const float t = (lf - l0) / (l1 - l0);
-
-                return pts[i - 1].level + t * (pts[i].level - pts[i - 1].level);
-            }
-        }
-
-        return pts.back().level;
-    }
-
-    // Interpoliert Median der Referenzbänder
-    static float sampleLogInterpolatedReferenceMedian(
-        const std::vector<AudioPluginAudioProcessor::ReferenceBand>& ref,
-        float fHz,
-        float fallbackDb)
-    {
-        if (ref.empty())
-            return fallbackDb;
-
-        if (fHz <= ref.front().freq) return ref.front().median;
-        if (fHz >= ref.back().freq)  return ref.back().median;
-
-        const float lf = std::log10(fHz);
-
-        for (size_t i = 1; i < ref.size(); ++i)
-        {
-            const float f1 = ref[i].freq;
-            if (f1 >= fHz)
-            {
-                const float f0 = ref[i - 1].freq;
-
-                const float l0 = std::log10(f0);
-                const float l1 = std::log10(f1);
-
-                const float t = (lf - l0) / (l1 - l0);
-
-                return ref[i - 1].median + t * (ref[i].median - ref[i - 1].median);
-            }
-        }
-
-        return ref.back().median;
-    }
+    using CurveMath::sampleLogInterpolatedSpectrum;
+    using CurveMath::sampleLogInterpolatedReferenceMedian;
 }
 
 //==============================================================================
@@ -283,23 +125,47 @@ namespace
  * @param p Referenz auf den Audio-Processor
  */
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(AudioPluginAudioProcessor& p)
-    : AudioProcessorEditor(&p), processorRef(p)
+    : AudioProcessorEditor(&p), processorRef(p), performanceHud(p.getPerformanceCounters())
 {
     // Initialzustand: EQ-Kurvenansicht deaktiviert
     showEQCurve = false;
 
-    // Timer für FFT-Display-Updates (30 Frames pro Sekunde)
-    startTimerHz(30);
-
     // Alle UI-Komponenten initialisieren
     initializeWindow();
     setupGenreDropdown();
     setupMeasurementButton();
     setupResetButton();
     setupEQCurveToggle();
+    setupAdaptiveToggle();
+    setupPerformanceHud();
+    setupSnapshotControls();
     setupEQSliders();
-    setupQKnobs();
     setupLoadReferenceButton();
+
+    // Parameterwerte für den gecachten EQ-Frequenzgang direkt aus dem State lesen
+    for (int i = 0; i < 31; ++i)
+    {
+        eqGainValues[i] = processorRef.apvts.getRawParameterValue("band" + juce::String(i));
+        eqQValues[i] = processorRef.apvts.getRawParameterValue("bandQ" + juce::String(i));
+    }
+
+    // UI wurde gerade aus dem aktuellen Processor-State aufgebaut
+    processorStateVersion = processorRef.getStateVersion();
+
+    // Display-Updates im Bildschirmtakt; ohne sichtbares Fenster kommen keine VBlanks
+    vBlankAttachment = juce::VBlankAttachment(this, [this](double timestampSec) { onVBlank(timestampSec); });
+
+    // Läuft beim Öffnen schon eine Messung, Snapshots weiter sammeln
+    if (processorRef.isMeasuring())
+        startTimerHz(kMeasurementTimerHz);
+
+    // Q-Knob-Reihe erst nach dem Öffnen erzeugen (31 Slider + Attachments),
+    // damit der Host das Fenster sofort zeigen kann
+    juce::MessageManager::callAsync([safe = juce::Component::SafePointer<AudioPluginAudioProcessorEditor>(this)]
+        {
+            if (safe != nullptr)
+                safe->setupQKnobs();
+        });
 }
 
 /**
@@ -310,8 +176,33 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(AudioPluginAudi
  */
 AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
 {
-    referenceAnalysisPool.removeAllJobs(true, 2000);
-    autoEqPool.removeAllJobs(true, 2000);
+    // Eigene Jobs abbrechen; die Worker gehören allen Instanzen
+    referenceAnalysisJob.cancel();
+    autoEqJob.cancel();
+
+    referenceAnalysisJob.waitForCompletion(2000);
+    autoEqJob.waitForCompletion(2000);
+
+    for (auto& slider : eqSlider)
+        slider.setLookAndFeel(nullptr);
+
+    for (auto& knob : eqKnob)
+        if (knob != nullptr)
+            knob->setLookAndFeel(nullptr);
+}
+
+/**
+ * @brief Liefert den prozessweiten Job-Scheduler (beim ersten Aufruf geholt).
+ *
+ * Alle Editoren teilen sich eine Instanz; sie wird mit dem letzten
+ * Editor, der sie benutzt hat, beendet.
+ */
+JobSystem& AudioPluginAudioProcessorEditor::getJobSystem()
+{
+    if (!jobSystem.has_value())
+        jobSystem.emplace();
+
+    return **jobSystem;
 }
 
 //==============================================================================
@@ -381,13 +272,18 @@ void AudioPluginAudioProcessorEditor::updateMeasurementButtonEnabledState()
 /**
  * @brief Initialisiert die Fenstereinstellungen.
  *
- * Setzt die Fenstergröße auf 1000x690 Pixel und deaktiviert
- * die Größenänderung durch den Benutzer.
+ * Startet mit 1000x680 Pixeln und erlaubt Größenänderungen
+ * (80 % bis 300 %) bei festem Seitenverhältnis.
  */
 void AudioPluginAudioProcessorEditor::initializeWindow()
 {
-    setSize(1000, 680);
-    setResizable(false, false);
+    // Frei skalierbar mit festem Seitenverhältnis; das Layout wird aus
+    // der Basisgröße (1000x680) mit uiScale hochgerechnet
+    setResizable(true, true);
+    setResizeLimits(baseWidth * 4 / 5, baseHeight * 4 / 5, baseWidth * 3, baseHeight * 3);
+    getConstrainer()->setFixedAspectRatio((double)baseWidth / (double)baseHeight);
+
+    setSize(baseWidth, baseHeight);
 }
 
 void AudioPluginAudioProcessorEditor::setupLoadReferenceButton()
@@ -426,17 +322,23 @@ void AudioPluginAudioProcessorEditor::setupLoadReferenceButton()
                     // SafePointer schützt vor Crashes wenn Editor geschlossen wird
                     juce::Component::SafePointer<AudioPluginAudioProcessorEditor> safeThis(this);
 
-                    struct Job : public juce::ThreadPoolJob
+                    struct Job
                     {
                         Job(juce::Component::SafePointer<AudioPluginAudioProcessorEditor> s,
-                            AudioPluginAudioProcessor& p,
+                            int traceIdToUse,
                             juce::File f)
-                            : juce::ThreadPoolJob("ReferenceAnalysisJob"), safeEditor(s), processor(p), file(std::move(f)) {}
+                            : safeEditor(s), traceId(traceIdToUse), file(std::move(f)) {}
 
-                        JobStatus runJob() override
+                        void operator()(const JobSystem::JobHandle& handle) const
                         {
+                            const TraceRecorder::Scope traceScope("ReferenceAnalysisJob", "reference", traceId);
+
                             // Analyse (CPU-heavy) -> hier rein
-                            auto bands = analyseFileToReferenceBands(file);
+                            auto bands = ReferenceAnalysis::analyseFile(file, nullptr,
+                                [handle] { return handle.isCancelled(); });
+
+                            if (handle.isCancelled())
+                                return;
 
                             juce::MessageManager::callAsync([safe = safeEditor, bands = std::move(bands)]() mutable
                                 {
@@ -445,7 +347,8 @@ void AudioPluginAudioProcessorEditor::setupLoadReferenceButton()
 
                                     // Ergebnis in Processor schreiben + UI freigeben
                                     safe->processorRef.referenceBands = std::move(bands);
-                                    safe->processorRef.hasTargetCorrections = false; // optional: Zielkurve zurücksetzen
+                                    safe->processorRef.referenceBandsChanged();
+                                    safe->processorRef.clearTargetCorrections(); // optional: Zielkurve zurücksetzen
 
                                     safe->referenceAnalysisRunning = false;
                                     safe->loadReferenceButton.setEnabled(true);
@@ -455,238 +358,18 @@ void AudioPluginAudioProcessorEditor::setupLoadReferenceButton()
 
                                     safe->repaint();
                                 });
-
-                            return jobHasFinished;
-                        }
-
-                        // ---- Kern: Datei -> ReferenceBands ----
-                        static std::vector<AudioPluginAudioProcessor::ReferenceBand>
-                            analyseFileToReferenceBands(const juce::File& f)
-                        {
-                            std::vector<AudioPluginAudioProcessor::ReferenceBand> out;
-
-                            juce::AudioFormatManager fm;
-                            fm.registerBasicFormats();
-
-                            std::unique_ptr<juce::AudioFormatReader> reader(fm.createReaderFor(f));
-                            if (!reader)
-                                return out;
-
-                            const double sr = reader->sampleRate > 0.0 ? reader->sampleRate : 48000.0;
-                            const int64 totalSamples = reader->lengthInSamples;
-                            const int numCh = (int)reader->numChannels;
-
-                            // FFT-Settings (offline)
-                            constexpr int fftOrder = 12;               // 4096
-                            constexpr int fftSize = 1 << fftOrder;
-                            constexpr int hopSize = fftSize / 2;      // 50% overlap
-
-                            juce::dsp::FFT fft(fftOrder);
-                            juce::dsp::WindowingFunction<float> win(fftSize, juce::dsp::WindowingFunction<float>::hann);
-
-                            std::vector<float> mono((size_t)fftSize, 0.0f);
-                            std::vector<float> fftData((size_t)2 * fftSize, 0.0f);
-
-                            // Wir sammeln pro EQ-Band viele dB-Werte -> später P10/Median/P90
-                            constexpr float bandFreqs[31] =
-                            {
-                                20, 25, 31.5f, 40, 50, 63, 80, 100, 125, 160,
-                                200, 250, 315, 400, 500, 630, 800, 1000, 1250, 1600,
-                                2000, 2500, 3150, 4000, 5000, 6300, 8000, 10000, 12500, 16000, 20000
-                            };
-
-                            std::array<std::vector<float>, 31> bandDbValues;
-                            for (auto& v : bandDbValues) v.reserve(4096);
-
-                            auto percentile = [](std::vector<float>& v, float p)
-                                {
-                                    if (v.empty()) return DisplayScale::minDb;
-                                    std::sort(v.begin(), v.end());
-                                    const float pos = p * (float)(v.size() - 1);
-                                    const int i0 = (int)std::floor(pos);
-                                    const int i1 = (int)std::ceil(pos);
-                                    if (i0 == i1) return v[(size_t)i0];
-                                    const float t = pos - (float)i0;
-                                    return v[(size_t)i0] + t * (v[(size_t)i1] - v[(size_t)i0]);
-                                };
-
-                            auto hzToBin = [&](float hz)
-                                {
-                                    const int bin = (int)std::round(hz * (float)fftSize / (float)sr);
-                                    return juce::jlimit(0, fftSize / 2, bin);
-                                };
-
-                            // Bandbreite 1/3 Okt: Grenzen = f * 2^(±1/6)
-                            const float bandEdge = std::pow(2.0f, 1.0f / 6.0f);
-
-                            juce::AudioBuffer<float> temp(numCh, (int)juce::jmin<int64>(totalSamples, fftSize));
-
-                            int64 readPos = 0;
-                            std::vector<float> overlap((size_t)fftSize, 0.0f);
-                            bool haveOverlap = false;
-
-                            while (readPos < totalSamples)
-                            {
-                                const int toRead = (int)juce::jmin<int64>((int64)hopSize, totalSamples - readPos);
-                                temp.setSize(numCh, toRead, false, false, true);
-                                reader->read(&temp, 0, toRead, readPos, true, true);
-
-                                // frame bauen (overlap-add)
-                                if (!haveOverlap)
-                                {
-                                    std::fill(overlap.begin(), overlap.end(), 0.0f);
-                                    haveOverlap = true;
-                                }
-
-                                // shift left um hopSize
-                                std::memmove(overlap.data(), overlap.data() + hopSize, sizeof(float) * (fftSize - hopSize));
-
-                                // hinten neue Samples rein (mono)
-                                for (int i = 0; i < hopSize; ++i)
-                                {
-                                    float s = 0.0f;
-                                    if (i < toRead)
-                                    {
-                                        for (int ch = 0; ch < numCh; ++ch)
-                                            s += temp.getSample(ch, i);
-                                        s /= (float)juce::jmax(1, numCh);
-                                    }
-                                    overlap[(size_t)(fftSize - hopSize + i)] = s;
-                                }
-
-                                // window + FFT input
-                                std::copy(overlap.begin(), overlap.end(), mono.begin());
-                                win.multiplyWithWindowingTable(mono.data(), fftSize);
-
-                                std::fill(fftData.begin(), fftData.end(), 0.0f);
-                                std::copy(mono.begin(), mono.end(), fftData.begin());
-
-                                fft.performFrequencyOnlyForwardTransform(fftData.data());
-
-                                // pro Band: mags im Bandbereich mitteln -> dB speichern
-                                for (int b = 0; b < 31; ++b)
-                                {
-                                    const float f0 = bandFreqs[b];
-                                    const float fLo = juce::jmax(20.0f, f0 / bandEdge);
-                                    const float fHi = juce::jmin(20000.0f, f0 * bandEdge);
-
-                                    const int binLo = hzToBin(fLo);
-                                    const int binHi = hzToBin(fHi);
-
-                                    float sum = 0.0f;
-                                    int cnt = 0;
-
-                                    for (int k = binLo; k <= binHi; ++k)
-                                    {
-                                        sum += fftData[(size_t)k];
-                                        ++cnt;
-                                    }
-
-                                    const float magRaw = (cnt > 0) ? (sum / (float)cnt) : 0.0f;
-
-                                    // Normalisierung: JUCE FFT Magnitude ist größenabhängig.
-                                    // Sehr brauchbarer Start: auf fftSize skalieren (single-sided grob: *2/fftSize)
-                                    const float mag = magRaw * (2.0f / (float)fftSize);
-
-                                    const float db = juce::Decibels::gainToDecibels(mag, DisplayScale::minDb);
-                                    bandDbValues[b].push_back(juce::jlimit(DisplayScale::minDb, 0.0f, db));
-                                }
-
-                                readPos += toRead;
-                            }
-
-                            out.reserve(31);
-                            for (int b = 0; b < 31; ++b)
-                            {
-                                auto v = std::move(bandDbValues[b]);
-
-                                AudioPluginAudioProcessor::ReferenceBand band;
-                                band.freq = bandFreqs[b];
-                                band.p10 = percentile(v, 0.20f);
-                                band.median = percentile(v, 0.50f);
-                                band.p90 = percentile(v, 0.80f);
-                                out.push_back(band);
-                            }
-                            {
-                                const int windowSize = 5;
-                                const int passes = 2;
-
-                                std::vector<float> med;
-                                med.reserve(out.size());
-                                for (const auto& b : out)
-                                    med.push_back(b.median);
-
-                                auto smooth = [&](std::vector<float> v)
-                                    {
-                                        if ((int)v.size() < 3 || windowSize < 3) return v;
-
-                                        std::vector<float> cur = v;
-                                        std::vector<float> tmp(v.size());
-                                        const int half = windowSize / 2;
-
-                                        for (int pass = 0; pass < passes; ++pass)
-                                        {
-                                            for (int i = 0; i < (int)cur.size(); ++i)
-                                            {
-                                                double sum = 0.0;
-                                                int cnt = 0;
-                                                for (int j = -half; j <= half; ++j)
-                                                {
-                                                    const int idx = i + j;
-                                                    if (idx >= 0 && idx < (int)cur.size())
-                                                    {
-                                                        sum += cur[(size_t)idx];
-                                                        ++cnt;
-                                                    }
-                                                }
-                                                tmp[(size_t)i] = (cnt > 0) ? (float)(sum / (double)cnt) : cur[(size_t)i];
-                                            }
-                                            cur.swap(tmp);
-                                        }
-                                        return cur;
-                                    };
-
-                                auto medSmoothed = smooth(med);
-
-                                for (size_t i = 0; i < out.size(); ++i)
-                                    out[i].median = medSmoothed[i];
-                            }
-
-                            {
-                                constexpr float targetMidMedianDb = -60.0f;
-
-                                std::vector<float> mids;
-                                mids.reserve(out.size());
-
-                                for (const auto& b : out)
-                                    if (b.freq >= 50.0f && b.freq <= 10000.0f)
-                                        mids.push_back(b.median);
-
-                                if (!mids.empty())
-                                {
-                                    std::sort(mids.begin(), mids.end());
-                                    const float midMedian = mids[mids.size() / 2];
-
-                                    const float shift = targetMidMedianDb - midMedian;
-
-                                    for (auto& b : out)
-                                    {
-                                        b.p10 += shift;
-                                        b.median += shift;
-                                        b.p90 += shift;
-                                    }
-                                }
-                            }
-                            postProcessReferenceBands(out);
-                            return out;
                         }
 
+                        // Kein Processor-Zugriff im Job: er kann den Editor überleben
                         juce::Component::SafePointer<AudioPluginAudioProcessorEditor> safeEditor;
-                        AudioPluginAudioProcessor& processor;
+                        int traceId = -1;
                         juce::File file;
                     };
 
-                    referenceAnalysisPool.addJob(new Job(safeThis, processorRef, file), true);
+                    // Eine ältere, noch laufende Analyse liefert ihr Ergebnis nicht mehr ab
+                    referenceAnalysisJob.cancel();
+                    referenceAnalysisJob = getJobSystem().submit(Job(safeThis, processorRef.getTraceId(), file),
+                        JobSystem::Priority::normal);
                 });
         };
 
@@ -708,14 +391,8 @@ void AudioPluginAudioProcessorEditor::setupGenreDropdown()
     genreBox.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff22262d));
 
     // Alle verfügbaren Genres hinzufügen
-    genreBox.addItem("Pop", 1);
-    genreBox.addItem("HipHop", 2);
-    genreBox.addItem("Jazz", 3);
-    genreBox.addItem("Klassik", 4);
-    genreBox.addItem("Metal", 5);
-    genreBox.addItem("RnB", 6);
-    genreBox.addItem("Rock", 7);
-    genreBox.addItem("EDM", 8);
+    for (const auto& genre : ReferenceAnalysis::getGenres())
+        genreBox.addItem(genre.name, genre.id);
 
 
     // Callback bei Genre-Auswahl: Lädt die entsprechende JSON-Referenzkurve
@@ -725,45 +402,18 @@ void AudioPluginAudioProcessorEditor::setupGenreDropdown()
             processorRef.selectedGenreId = id;
 
             // Genre-spezifische Referenzkurve laden
-            switch (id)
+            if (const auto* genre = ReferenceAnalysis::findGenre(id))
             {
-            case 1:
-                processorRef.loadReferenceCurve("Pop_Referenz.json");
-                postProcessReferenceBands(processorRef.referenceBands);
-                break;
-            case 2:
-                processorRef.loadReferenceCurve("HipHop_Referenz.json");
-                postProcessReferenceBands(processorRef.referenceBands);
-                break;
-            case 3:
-                processorRef.loadReferenceCurve("Jazz_Referenz.json");
-                postProcessReferenceBands(processorRef.referenceBands);
-                break;
-            case 4:
-                processorRef.loadReferenceCurve("Klassik_Referenz.json");
-                postProcessReferenceBands(processorRef.referenceBands);
-                break;
-            case 5:
-                processorRef.loadReferenceCurve("Metal_Referenz.json");
-                postProcessReferenceBands(processorRef.referenceBands);
-                break;
-            case 6:
-                processorRef.loadReferenceCurve("RnB_Referenz.json");
-                postProcessReferenceBands(processorRef.referenceBands);
-                break;
-            case 7:
-                processorRef.loadReferenceCurve("Rock_Referenz.json");
-                postProcessReferenceBands(processorRef.referenceBands);
-                break;
-            case 8:
-                processorRef.loadReferenceCurve("TechHouse_Referenz.json");
+                processorRef.loadReferenceCurve(genre->fileName);
                 postProcessReferenceBands(processorRef.referenceBands);
-                break;
-            default:
+            }
+            else
+            {
                 processorRef.referenceBands.clear();
-                break;
             }
 
+            processorRef.referenceBandsChanged();
+
             repaint();
             updateMeasurementButtonEnabledState();
         };
@@ -814,15 +464,14 @@ void AudioPluginAudioProcessorEditor::setupMeasurementButton()
             processorRef.resetMeasurement();          // Messpuffer, FIFOs, FFT flags, Target Kurve etc.
             processorRef.resetAllBandsToDefault();    // EQ + Q etc.
 
-            showEQCurve = false;
-            eqCurveToggleButton.setToggleState(false, juce::dontSendNotification);
-            eqCurveToggleButton.setButtonText("EQ Ansicht");
+            setEQCurveView(false);
 
             smoothedLevels.clear();
             referenceViewOffsetDb = 0.0f;
             referenceViewOffsetDbSmoothed = 0.0f;
 
             processorRef.startMeasurement();
+            startTimerHz(kMeasurementTimerHz);
 
             genreErkennenButton.setButtonText("Messung stoppen");
             genreErkennenButton.setColour(juce::TextButton::buttonColourId, juce::Colours::red);
@@ -864,9 +513,7 @@ void AudioPluginAudioProcessorEditor::setupResetButton()
                 p->setValueNotifyingHost(p->getDefaultValue());
 
             // 4) UI-View zurück auf "Spektrum/Referenzansicht"
-            showEQCurve = false;
-            eqCurveToggleButton.setToggleState(false, juce::dontSendNotification);
-            eqCurveToggleButton.setButtonText("EQ Ansicht");
+            setEQCurveView(false);
 
             // 5) Glättungs-/Offset-Zustände zurück (sonst “hängt” Anzeige optisch)
             smoothedLevels.clear();
@@ -895,20 +542,244 @@ void AudioPluginAudioProcessorEditor::setupEQCurveToggle()
 
     eqCurveToggleButton.onClick = [this]
         {
-            showEQCurve = eqCurveToggleButton.getToggleState();
-
-            // Button-Text entsprechend der Ansicht aktualisieren
-            if (showEQCurve)
-                eqCurveToggleButton.setButtonText("Referenz Ansicht");
-            else
-                eqCurveToggleButton.setButtonText("EQ Ansicht");
-
+            setEQCurveView(eqCurveToggleButton.getToggleState());
             repaint();
         };
 
     addAndMakeVisible(eqCurveToggleButton);
 }
 
+/**
+ * @brief Schaltet zwischen Spektrum- und EQ-Kurven-Ansicht um.
+ *
+ * Hält Toggle-Zustand und Button-Text synchron und verwirft die
+ * statischen Ebenen, da dB-Raster und -Beschriftung ansichtsabhängig sind.
+ *
+ * @param shouldShowEQCurve true für EQ-Ansicht, false für Spektrum/Referenz
+ */
+void AudioPluginAudioProcessorEditor::setEQCurveView(bool shouldShowEQCurve)
+{
+    if (showEQCurve != shouldShowEQCurve)
+        invalidateStaticLayers();
+
+    showEQCurve = shouldShowEQCurve;
+    eqCurveToggleButton.setToggleState(showEQCurve, juce::dontSendNotification);
+
+    // Button-Text entsprechend der Ansicht aktualisieren
+    if (showEQCurve)
+        eqCurveToggleButton.setButtonText("Referenz Ansicht");
+    else
+        eqCurveToggleButton.setButtonText("EQ Ansicht");
+}
+
+/**
+ * @brief Konfiguriert den Toggle-Button für den adaptiven Modus.
+ *
+ * Schaltet das Referenz-Tracking im Processor ein/aus. Im adaptiven
+ * Modus werden die Band-Gains live nachgeführt, sodass jedes Band im
+ * p10..p90-Fenster der geladenen Referenz bleibt.
+ */
+void AudioPluginAudioProcessorEditor::setupAdaptiveToggle()
+{
+    adaptiveToggleButton.setButtonText("Adaptiv");
+    adaptiveToggleButton.setClickingTogglesState(true);
+    adaptiveToggleButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff22262d));
+    adaptiveToggleButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour::fromString("ff2ecc71"));
+
+    // Mit Parameter-State verbinden (Automation + Session)
+    adaptiveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processorRef.apvts, "adaptiveMode", adaptiveToggleButton);
+
+    addAndMakeVisible(adaptiveToggleButton);
+}
+
+/**
+ * @brief Konfiguriert das Performance-HUD und seinen Toggle-Button.
+ *
+ * Das HUD liegt als Overlay oben links im Spektrum und ist
+ * standardmäßig ausgeblendet. Es liest nur lock-freie Zähler.
+ */
+void AudioPluginAudioProcessorEditor::setupPerformanceHud()
+{
+    hudToggleButton.setButtonText("HUD");
+    hudToggleButton.setClickingTogglesState(true);
+    hudToggleButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff22262d));
+    hudToggleButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xff3a3f47));
+
+    hudToggleButton.onClick = [this]
+        {
+            performanceHud.setVisible(hudToggleButton.getToggleState());
+        };
+
+    addAndMakeVisible(hudToggleButton);
+    addChildComponent(performanceHud);
+}
+
+/**
+ * @brief Konfiguriert die A/B-Snapshot-Buttons und den Morph-Regler.
+ *
+ * Die Buttons arbeiten auf den Processor-Slots 0 und 1. Ein Klick auf
+ * einen leeren Slot (oder mit Shift) speichert die aktuellen EQ-Werte,
+ * sonst wird der Slot vorgehört; ein zweiter Klick geht zurück zu den
+ * Parametern. Mit Alt wird der Slot in die Parameter übernommen. Der
+ * Regler morpht zwischen A und B, sobald beide Slots belegt sind.
+ */
+void AudioPluginAudioProcessorEditor::setupSnapshotControls()
+{
+    auto setupButton = [this](juce::TextButton& button, const juce::String& text, int slot)
+        {
+            button.setButtonText(text);
+            button.setClickingTogglesState(false);
+            button.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff22262d));
+            button.setColour(juce::TextButton::buttonOnColourId, juce::Colour::fromString("ff2ecc71"));
+            button.onClick = [this, slot] { onSnapshotButton(slot); };
+            addAndMakeVisible(button);
+        };
+
+    setupButton(snapshotAButton, "A", 0);
+    setupButton(snapshotBButton, "B", 1);
+
+    snapshotMorphKnob.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    snapshotMorphKnob.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    snapshotMorphKnob.setRange(0.0, 1.0, 0.0);
+    snapshotMorphKnob.setValue(processorRef.getSnapshotMorph(), juce::dontSendNotification);
+    snapshotMorphKnob.onValueChange = [this]
+        {
+            processorRef.setSnapshotCompare(0, 1, (float)snapshotMorphKnob.getValue());
+            updateSnapshotButtons();
+        };
+    addAndMakeVisible(snapshotMorphKnob);
+
+    updateSnapshotButtons();
+}
+
+/**
+ * @brief Reagiert auf einen Klick auf A oder B.
+ *
+ * @param slot Processor-Slot (0 = A, 1 = B)
+ */
+void AudioPluginAudioProcessorEditor::onSnapshotButton(int slot)
+{
+    const auto mods = juce::ModifierKeys::currentModifiers;
+
+    if (mods.isAltDown())
+    {
+        processorRef.applySnapshotToParameters(slot);
+    }
+    else if (mods.isShiftDown() || !processorRef.hasSnapshot(slot))
+    {
+        processorRef.storeSnapshot(slot);
+        snapshotsFromAutoEq = false;
+    }
+    else if (getActiveSnapshotSlot() == slot)
+    {
+        processorRef.setSnapshotCompare(-1, -1, 0.0f);
+    }
+    else if (processorRef.hasSnapshot(0) && processorRef.hasSnapshot(1))
+    {
+        // Beide belegt: A/B als Morph-Endpunkte, damit der Regler anschließen kann
+        processorRef.setSnapshotCompare(0, 1, (float)slot);
+        snapshotMorphKnob.setValue((double)slot, juce::dontSendNotification);
+    }
+    else
+    {
+        processorRef.setSnapshotCompare(slot, -1, 0.0f);
+    }
+
+    updateSnapshotButtons();
+}
+
+/**
+ * @brief Liefert den gerade hörbaren Snapshot-Slot.
+ *
+ * @return 0 (A), 1 (B) oder -1 wenn die Parameter live laufen
+ */
+int AudioPluginAudioProcessorEditor::getActiveSnapshotSlot() const
+{
+    const int slotA = processorRef.getSnapshotCompareSlot();
+
+    if (slotA < 0)
+        return -1;
+
+    if (slotA == 0 && processorRef.hasSnapshot(1))
+        return processorRef.getSnapshotMorph() < 0.5f ? 0 : 1;
+
+    return slotA;
+}
+
+/**
+ * @brief Legt Vorher/Nachher eines Auto-EQ-Laufs in den Slots A und B ab.
+ *
+ * Muss vor dem Übernehmen der neuen Werte aufgerufen werden, A bekommt die
+ * aktuellen Parameter. Liegen in A oder B selbst gespeicherte Snapshots,
+ * wird vorher gefragt, ob sie ersetzt werden sollen.
+ *
+ * @param afterGains Gains des Auto-EQ-Ergebnisses (dB)
+ * @param afterQs Qs des Auto-EQ-Ergebnisses
+ */
+void AudioPluginAudioProcessorEditor::storeAutoEqSnapshots(const std::array<float, 31>& afterGains,
+    const std::array<float, 31>& afterQs)
+{
+    std::array<float, 31> beforeGains{}, beforeQs{};
+    for (int i = 0; i < 31; ++i)
+    {
+        beforeGains[(size_t)i] = eqGainValues[i]->load();
+        beforeQs[(size_t)i] = eqQValues[i]->load();
+    }
+
+    auto store = [safe = juce::Component::SafePointer<AudioPluginAudioProcessorEditor>(this),
+        beforeGains, beforeQs, afterGains, afterQs]
+        {
+            if (safe == nullptr)
+                return;
+
+            safe->processorRef.storeSnapshot(0, beforeGains, beforeQs);
+            safe->processorRef.storeSnapshot(1, afterGains, afterQs);
+            safe->processorRef.setSnapshotCompare(-1, -1, 0.0f);
+            safe->snapshotsFromAutoEq = true;
+            safe->updateSnapshotButtons();
+        };
+
+    const bool ownSnapshots = !snapshotsFromAutoEq && (processorRef.hasSnapshot(0) || processorRef.hasSnapshot(1));
+
+    if (!ownSnapshots)
+    {
+        store();
+        return;
+    }
+
+    juce::AlertWindow::showAsync(juce::MessageBoxOptions()
+        .withIconType(juce::MessageBoxIconType::QuestionIcon)
+        .withTitle("Snapshots A/B ersetzen?")
+        .withMessage("Auto-EQ legt den Stand vorher in A und das Ergebnis in B ab. "
+                     "Die dort gespeicherten Snapshots gehen dabei verloren.")
+        .withButton("Ersetzen")
+        .withButton("Behalten")
+        .withAssociatedComponent(this),
+        [store](int result)
+            {
+                if (result == 1)
+                    store();
+            });
+}
+
+/**
+ * @brief Aktualisiert Zustand und Beschriftung der Snapshot-Controls.
+ */
+void AudioPluginAudioProcessorEditor::updateSnapshotButtons()
+{
+    const int active = getActiveSnapshotSlot();
+
+    snapshotAButton.setToggleState(active == 0, juce::dontSendNotification);
+    snapshotBButton.setToggleState(active == 1, juce::dontSendNotification);
+
+    // Leere Slots gedimmt (Klick speichert)
+    snapshotAButton.setAlpha(processorRef.hasSnapshot(0) ? 1.0f : 0.5f);
+    snapshotBButton.setAlpha(processorRef.hasSnapshot(1) ? 1.0f : 0.5f);
+
+    snapshotMorphKnob.setEnabled(processorRef.hasSnapshot(0) && processorRef.hasSnapshot(1));
+}
+
 /**
  * @brief Konfiguriert alle 31 EQ-Slider.
  *
@@ -937,6 +808,10 @@ void AudioPluginAudioProcessorEditor::setupEQSliders()
         eqSlider[i].setColour(juce::Slider::thumbColourId, juce::Colours::white);
         eqSlider[i].setColour(juce::Slider::trackColourId, juce::Colours::lightgrey);
 
+        // Schlanke Darstellung (31 Fader pro Repaint)
+        eqSlider[i].setLookAndFeel(&faderLookAndFeel);
+        eqSlider[i].setPaintingIsUnclipped(true);
+
         // Mit Parameter-State verbinden für Automation und Preset-Speicherung
         eqAttachments[i] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
             processorRef.apvts, "band" + juce::String(i), eqSlider[i]);
@@ -950,30 +825,38 @@ void AudioPluginAudioProcessorEditor::setupEQSliders()
  *
  * Erstellt Drehregler für den Q-Faktor (Bandbreite) jedes EQ-Bands.
  * Der Q-Bereich reicht von 0.3 (breit) bis 10.0 (schmal).
+ * Wird verzögert nach dem Öffnen des Editors aufgerufen.
  */
 void AudioPluginAudioProcessorEditor::setupQKnobs()
 {
     for (int i = 0; i < 31; ++i)
     {
+        auto knob = std::make_unique<juce::Slider>();
+
         // Knob-Stil und Wertebereich konfigurieren
-        eqKnob[i].setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-        eqKnob[i].setRange(0.3, 10.0, 0.01);
-        eqKnob[i].setValue(4.32);  // Standard Q-Wert für 1/3-Oktav-EQ
-        eqKnob[i].setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-        eqKnob[i].setPopupDisplayEnabled(false, true, this);
-        eqKnob[i].setNumDecimalPlacesToDisplay(2);
+        knob->setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+        knob->setRange(0.3, 10.0, 0.01);
+        knob->setValue(4.32);  // Standard Q-Wert für 1/3-Oktav-EQ
+        knob->setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+        knob->setPopupDisplayEnabled(false, true, this);
+        knob->setNumDecimalPlacesToDisplay(2);
+        knob->setLookAndFeel(&faderLookAndFeel);
+        knob->setPaintingIsUnclipped(true);
 
         // Farben setzen
-        eqKnob[i].setColour(juce::Slider::thumbColourId, juce::Colours::white);
-        eqKnob[i].setColour(juce::Slider::rotarySliderFillColourId, juce::Colours::darkgrey);
-        eqKnob[i].setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colours::black);
+        knob->setColour(juce::Slider::thumbColourId, juce::Colours::white);
+        knob->setColour(juce::Slider::rotarySliderFillColourId, juce::Colours::darkgrey);
+        knob->setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colours::black);
 
         // Mit Parameter-State verbinden
         eqQAttachments[i] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-            processorRef.apvts, "bandQ" + juce::String(i), eqKnob[i]);
+            processorRef.apvts, "bandQ" + juce::String(i), *knob);
 
-        addAndMakeVisible(eqKnob[i]);
+        addAndMakeVisible(*knob);
+        eqKnob[i] = std::move(knob);
     }
+
+    layoutQKnobs();
 }
 
 /**
@@ -992,24 +875,113 @@ void AudioPluginAudioProcessorEditor::setupQKnobs()
   * @brief Hauptzeichenfunktion des Editors.
   *
   * Wird automatisch von JUCE aufgerufen wenn das Fenster neu
-  * gezeichnet werden muss. Delegiert an spezialisierte Draw-Funktionen.
+  * gezeichnet werden muss. Alles Statische (Flächen, Raster, Skalen,
+  * Beschriftungen) kommt aus gecachten Ebenen; pro Frame werden nur
+  * die Kurven im inneren Spektrumbereich neu gezeichnet.
   *
   * @param g Der Graphics-Kontext zum Zeichnen
   */
 void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g)
 {
-    drawTopBar(g);
-    drawBackground(g);
+    const PaintProfiler::Scope profileScope(paintProfiler, "paint");
+    const TraceRecorder::Scope traceScope("paint", "gui", processorRef.getTraceId());
+
+    const double paintStartMs = juce::Time::getMillisecondCounterHiRes();
+    const auto allocationsBefore = AllocationCounter::getCount();
+
+    // Bildschirmwechsel (andere Skalierung) -> Ebenen neu rastern
+    if (!juce::approximatelyEqual(staticLayerScale, juce::Component::getApproximateScaleFactorForComponent(this)))
+        staticLayersDirty = true;
+
+    if (staticLayersDirty)
+        renderStaticLayers();
+
+    // 1) Statischer Hintergrund
+    g.drawImage(staticBackgroundLayer, getLocalBounds().toFloat());
+
+    // 2) Dynamische Kurven (Spektrum / EQ / Referenz)
     drawSpectrumArea(g);
-    drawFrequencyGrid(g);
-    drawEQAreas(g);
-    drawEQFaderDbScale(g);
-    drawEQFaderDbGuideLines(g);
-    drawEQLabels(g);
+
+    // 3) Frequenzraster + Rahmen über den Kurven
+    g.drawImage(staticOverlayLayer, spectrogramArea.toFloat());
+
+    lastPaintDurationMs = juce::Time::getMillisecondCounterHiRes() - paintStartMs;
+
+    auto& counters = processorRef.getPerformanceCounters();
+    counters.paintMs.store((float)lastPaintDurationMs, std::memory_order_relaxed);
+
+    // Zählt prozessweit (auch andere Threads), im ruhigen Zustand aber nahe an paint()
+    if (AllocationCounter::isEnabled())
+        counters.allocationsPerFrame.store((std::int64_t)(AllocationCounter::getCount() - allocationsBefore),
+            std::memory_order_relaxed);
 }
 
 //==============================================================================
-//                           DRAW-FUNKTIONEN
+//                          STATISCHE EBENEN
+//==============================================================================
+
+/**
+ * @brief Markiert die statischen Ebenen zum Neuzeichnen.
+ *
+ * Aufrufen, wenn sich Layout oder Ansicht ändern. Die Ebenen werden
+ * beim nächsten paint() einmalig neu gerendert.
+ */
+void AudioPluginAudioProcessorEditor::invalidateStaticLayers()
+{
+    staticLayersDirty = true;
+    repaint();
+}
+
+/**
+ * @brief Rendert die statischen Ebenen in Bilder (Gerätepixel).
+ *
+ * Hintergrund-Ebene: Topbar, Flächen, EQ-dB-Raster (EQ-Ansicht),
+ * Fader-Skala und alle Beschriftungen. Overlay-Ebene (transparent,
+ * nur spectrogramArea): Rahmenlinien und Frequenzraster, die wie
+ * bisher über den Kurven liegen.
+ */
+void AudioPluginAudioProcessorEditor::renderStaticLayers()
+{
+    const PaintProfiler::Scope profileScope(paintProfiler, "renderStaticLayers");
+
+    staticLayerScale = juce::Component::getApproximateScaleFactorForComponent(this);
+    staticLayersDirty = false;
+
+    auto makeLayer = [this](juce::Rectangle<int> area, juce::Image::PixelFormat format)
+        {
+            return juce::Image(format,
+                juce::jmax(1, juce::roundToInt((float)area.getWidth() * staticLayerScale)),
+                juce::jmax(1, juce::roundToInt((float)area.getHeight() * staticLayerScale)),
+                true);
+        };
+
+    staticBackgroundLayer = makeLayer(getLocalBounds(), juce::Image::RGB);
+    {
+        juce::Graphics g(staticBackgroundLayer);
+        g.addTransform(juce::AffineTransform::scale(staticLayerScale));
+
+        drawTopBar(g);
+        drawBackground(g);
+        drawSpectrumBackground(g);
+        drawEQAreas(g);
+        drawEQFaderDbScale(g);
+        drawEQFaderDbGuideLines(g);
+        drawEQLabels(g);
+    }
+
+    staticOverlayLayer = makeLayer(spectrogramArea, juce::Image::ARGB);
+    {
+        juce::Graphics g(staticOverlayLayer);
+        g.addTransform(juce::AffineTransform::scale(staticLayerScale));
+        g.setOrigin(-spectrogramArea.getPosition());
+
+        drawSpectrumFrameLines(g);
+        drawFrequencyGrid(g);
+    }
+}
+
+//==============================================================================
+//                           DRAW-FUNKTIONEN
 //==============================================================================
 
 /**
@@ -1021,6 +993,8 @@ void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g)
  */
 void AudioPluginAudioProcessorEditor::drawTopBar(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawTopBar");
+
     g.setColour(juce::Colour::fromString("ff2c2f33"));
     g.fillRect(topBarArea);
 }
@@ -1034,29 +1008,65 @@ void AudioPluginAudioProcessorEditor::drawTopBar(juce::Graphics& g)
  */
 void AudioPluginAudioProcessorEditor::drawBackground(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawBackground");
+
     auto rest = getLocalBounds().withY(topBarArea.getBottom());
     g.setColour(juce::Colour::fromString("ff111111"));
     g.fillRect(rest);
 }
 
 /**
- * @brief Zeichnet den Spektrum-Anzeigebereich.
+ * @brief Zeichnet die dynamischen Inhalte des Spektrum-Bereichs.
  *
- * Zeichnet die Debug-Bereiche (orange, grün, pink) und ruft je nach
- * Ansichtsmodus entweder drawFrame() für das Spektrum oder
+ * Ruft je nach Ansichtsmodus entweder drawFrame() für das Spektrum oder
  * drawEQCurve() für die EQ-Kurve auf. Zeichnet auch die Referenzbänder
- * wenn vorhanden.
+ * wenn vorhanden. Flächen, Raster und Rahmen kommen aus den statischen Ebenen.
  *
  * @param g Der Graphics-Kontext zum Zeichnen
  */
 void AudioPluginAudioProcessorEditor::drawSpectrumArea(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawSpectrumArea");
+
     // Konstanten für Frequenz- und dB-Bereich
     const float minFreq = 20.0f;
     const float maxFreq = 20000.0f;
     const float displayMinDb = kRefViewMinDb;
     const float displayMaxDb = kRefViewMaxDb;
 
+    // Spektrum/EQ-Kurve im inneren Bereich zeichnen mit Clipping
+    juce::Graphics::ScopedSaveState save(g);
+    g.reduceClipRegion(spectrumInnerArea);
+
+    // Je nach Ansichtsmodus zeichnen
+    if (!showEQCurve)
+    {
+        drawFrame(g);
+    }
+    else
+    {
+        drawEQCurve(g);
+    }
+
+    // Referenzbänder nur in Spektrum-Ansicht zeichnen
+    if (!showEQCurve && !processorRef.referenceBands.empty())
+    {
+        drawReferenceBands(g, minFreq, maxFreq, displayMinDb, displayMaxDb);
+    }
+}
+
+/**
+ * @brief Zeichnet den statischen Teil des Spektrum-Bereichs.
+ *
+ * Füllt die Spektrum-Flächen und zeichnet in der EQ-Ansicht das
+ * dB-Raster samt Beschriftung. Landet in der Hintergrund-Ebene.
+ *
+ * @param g Der Graphics-Kontext zum Zeichnen
+ */
+void AudioPluginAudioProcessorEditor::drawSpectrumBackground(juce::Graphics& g)
+{
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawSpectrumBackground");
+
     // Debug-Bereiche färben (TODO: Im Release entfernen)
     g.setColour(Theme::bgDeep);
     g.fillRect(spectrogramArea);
@@ -1067,49 +1077,43 @@ void AudioPluginAudioProcessorEditor::drawSpectrumArea(juce::Graphics& g)
     g.setColour(Theme::bgDeep);
     g.fillRect(spectrumInnerArea);
 
-    // Spektrum/EQ-Kurve im inneren Bereich zeichnen mit Clipping
+    if (showEQCurve)
     {
-        juce::Graphics::ScopedSaveState save(g);
-        g.reduceClipRegion(spectrumInnerArea);
-
-        if (showEQCurve)
-            drawEQDbGridLines(g);
-
-        // Je nach Ansichtsmodus zeichnen
-        if (!showEQCurve)
         {
-            drawFrame(g);
-        }
-        else
-        {
-            drawEQCurve(g);
+            juce::Graphics::ScopedSaveState save(g);
+            g.reduceClipRegion(spectrumInnerArea);
+            drawEQDbGridLines(g);
         }
 
-        // Referenzbänder nur in Spektrum-Ansicht zeichnen
-        if (!showEQCurve && !processorRef.referenceBands.empty())
-        {
-            drawReferenceBands(g, minFreq, maxFreq, displayMinDb, displayMaxDb);
-        }
+        drawEQDbGridLabels(g);
     }
-    // --- Frame-Linien für Spektrum (oben/unten), damit es "geschlossen" wirkt ---
-    {
-        const int x1 = spectrumInnerArea.getX();
-        const int x2 = spectrumInnerArea.getRight();
+}
+
+/**
+ * @brief Zeichnet die Rahmenlinien (oben/unten) des Spektrums.
+ *
+ * Damit der Bereich "geschlossen" wirkt. Liegt über den Kurven
+ * (Overlay-Ebene).
+ *
+ * @param g Der Graphics-Kontext zum Zeichnen
+ */
+void AudioPluginAudioProcessorEditor::drawSpectrumFrameLines(juce::Graphics& g)
+{
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawSpectrumFrameLines");
 
-        const int yTop = spectrumInnerArea.getY();
-        const int yBot = spectrumInnerArea.getBottom();
+    const int x1 = spectrumInnerArea.getX();
+    const int x2 = spectrumInnerArea.getRight();
 
-        g.setColour(juce::Colours::white.withAlpha(0.5f)); // fein, wie TBC
+    const int yTop = spectrumInnerArea.getY();
+    const int yBot = spectrumInnerArea.getBottom();
 
-        // obere Linie
-        g.drawLine((float)x1, (float)yTop, (float)x2, (float)yTop, 1.0f);
+    g.setColour(juce::Colours::white.withAlpha(0.5f)); // fein, wie TBC
 
-        // untere Linie
-        g.drawLine((float)x1, (float)yBot, (float)x2, (float)yBot, 1.0f);
-    }
+    // obere Linie
+    g.drawLine((float)x1, (float)yTop, (float)x2, (float)yTop, 1.0f);
 
-    if (showEQCurve)
-        drawEQDbGridLabels(g);
+    // untere Linie
+    g.drawLine((float)x1, (float)yBot, (float)x2, (float)yBot, 1.0f);
 }
 
 /**
@@ -1117,6 +1121,8 @@ void AudioPluginAudioProcessorEditor::drawSpectrumArea(juce::Graphics& g)
  *
  * Zeichnet drei Linien für die statistische Verteilung der
  * Referenzkurve: 10. Perzentil (blau), Median (grau), 90. Perzentil (blau).
+ * Die Pfade werden nur bei neuer Referenz gebaut (normierte Koordinaten)
+ * und hier per AffineTransform auf den Zeichenbereich abgebildet.
  *
  * @param g Der Graphics-Kontext zum Zeichnen
  * @param minFreq Minimale Frequenz in Hz (20)
@@ -1127,81 +1133,115 @@ void AudioPluginAudioProcessorEditor::drawSpectrumArea(juce::Graphics& g)
 void AudioPluginAudioProcessorEditor::drawReferenceBands(juce::Graphics& g,
     float minFreq, float maxFreq, float displayMinDb, float displayMaxDb)
 {
-    if (processorRef.referenceBands.size() < 2)
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawReferenceBands");
+
+    if (!referencePathsBuilt || referencePathsVersion != processorRef.getReferenceBandsVersion())
+        rebuildReferencePaths(minFreq, maxFreq, displayMinDb, displayMaxDb);
+
+    if (referenceMedianPath.isEmpty())
         return;
 
-    std::vector<juce::Point<float>> p10Pts, p90Pts, medPts;
-    p10Pts.reserve(processorRef.referenceBands.size());
-    p90Pts.reserve(processorRef.referenceBands.size());
-    medPts.reserve(processorRef.referenceBands.size());
+    // Normiert (x: 0..1, y: dB) -> Pixel: x linear auf die Breite,
+    // y invertiert (displayMaxDb oben, displayMinDb unten)
+    const auto area = spectrumInnerArea.toFloat();
+    const float pixelsPerDb = area.getHeight() / (displayMaxDb - displayMinDb);
+
+    const auto toScreen = juce::AffineTransform::scale(area.getWidth(), -pixelsPerDb)
+        .translated(area.getX(), area.getBottom() + displayMinDb * pixelsPerDb);
+
+    // --- 1) Fill zwischen P10 und P90 ---
+    g.setColour(Theme::refBandFill);     // pink-basiert mit Alpha
+    g.fillPath(referenceFillPath, toScreen);
+
+    // --- 2) Linien (P10 / P90 / Median) in Pink ---
+    // Strichstärke wird nach der Transformation angewendet (bleibt in Pixeln)
+    g.setColour(Theme::refBandEdge);
+    g.strokePath(referenceP10Path, juce::PathStrokeType(1.5f), toScreen);
+
+    g.setColour(Theme::refBandEdge);
+    g.strokePath(referenceP90Path, juce::PathStrokeType(1.5f), toScreen);
+
+    g.setColour(Theme::refMedian);
+    g.strokePath(referenceMedianPath, juce::PathStrokeType(2.0f), toScreen);
+}
+
+/**
+ * @brief Baut die Referenzband-Pfade in normierten Koordinaten.
+ *
+ * x = log. normierte Frequenz (0..1), y = dB (auf den Anzeigebereich
+ * begrenzt). Unabhängig von Fenstergröße, daher nur nach
+ * referenceBandsChanged() neu nötig.
+ *
+ * @param minFreq Minimale Frequenz in Hz (20)
+ * @param maxFreq Maximale Frequenz in Hz (20000)
+ * @param displayMinDb Minimaler dB-Wert für Anzeige
+ * @param displayMaxDb Maximaler dB-Wert für Anzeige
+ */
+void AudioPluginAudioProcessorEditor::rebuildReferencePaths(
+    float minFreq, float maxFreq, float displayMinDb, float displayMaxDb)
+{
+    const PaintProfiler::Scope profileScope(paintProfiler, "rebuildReferencePaths");
+
+    referencePathsBuilt = true;
+    referencePathsVersion = processorRef.getReferenceBandsVersion();
+
+    referenceFillPath.clear();
+    referenceP10Path.clear();
+    referenceP90Path.clear();
+    referenceMedianPath.clear();
+
+    const auto& bands = processorRef.referenceBands;
 
     auto clampDb = [&](float db)
         {
             return juce::jlimit(displayMinDb, displayMaxDb, db);
         };
 
-    for (const auto& band : processorRef.referenceBands)
+    std::vector<juce::Point<float>> p90Pts;
+    p90Pts.reserve(bands.size());
+
+    for (const auto& band : bands)
     {
         if (band.freq < minFreq || band.freq > maxFreq)
             continue;
 
-        const float normX = juce::mapFromLog10(band.freq, minFreq, maxFreq);
-        const float x = (float)spectrumInnerArea.getX() + normX * (float)spectrumInnerArea.getWidth();
+        const float x = juce::mapFromLog10(band.freq, minFreq, maxFreq);
+        const juce::Point<float> p10(x, clampDb(band.p10));
+        const juce::Point<float> med(x, clampDb(band.median));
+        const juce::Point<float> p90(x, clampDb(band.p90));
 
-        const float yP10 = juce::jmap(clampDb(band.p10), displayMinDb, displayMaxDb,
-            (float)spectrumInnerArea.getBottom(), (float)spectrumInnerArea.getY());
-        const float yMed = juce::jmap(clampDb(band.median), displayMinDb, displayMaxDb,
-            (float)spectrumInnerArea.getBottom(), (float)spectrumInnerArea.getY());
-        const float yP90 = juce::jmap(clampDb(band.p90), displayMinDb, displayMaxDb,
-            (float)spectrumInnerArea.getBottom(), (float)spectrumInnerArea.getY());
+        if (p90Pts.empty())
+        {
+            referenceFillPath.startNewSubPath(p10);
+            referenceP10Path.startNewSubPath(p10);
+            referenceP90Path.startNewSubPath(p90);
+            referenceMedianPath.startNewSubPath(med);
+        }
+        else
+        {
+            referenceFillPath.lineTo(p10);
+            referenceP10Path.lineTo(p10);
+            referenceP90Path.lineTo(p90);
+            referenceMedianPath.lineTo(med);
+        }
 
-        p10Pts.push_back({ x, yP10 });
-        medPts.push_back({ x, yMed });
-        p90Pts.push_back({ x, yP90 });
+        p90Pts.push_back(p90);
     }
 
-    if (p10Pts.size() < 2 || p90Pts.size() < 2)
-        return;
-
-    // --- 1) Fill zwischen P10 und P90 (WICHTIG: P90 rückwärts!) ---
+    if (p90Pts.size() < 2)
     {
-        juce::Path bandFill;
-        bandFill.startNewSubPath(p10Pts.front());
-
-        for (size_t i = 1; i < p10Pts.size(); ++i)
-            bandFill.lineTo(p10Pts[i]);
-
-        for (size_t i = p90Pts.size(); i-- > 0; )
-            bandFill.lineTo(p90Pts[i]);
-
-        bandFill.closeSubPath();
-
-        g.setColour(Theme::refBandFill);     // pink-basiert mit Alpha
-        g.fillPath(bandFill);
+        referenceFillPath.clear();
+        referenceP10Path.clear();
+        referenceP90Path.clear();
+        referenceMedianPath.clear();
+        return;
     }
 
-    // --- 2) Linien (P10 / P90 / Median) in Pink ---
-    auto makePath = [](const std::vector<juce::Point<float>>& pts)
-        {
-            juce::Path p;
-            p.startNewSubPath(pts.front());
-            for (size_t i = 1; i < pts.size(); ++i)
-                p.lineTo(pts[i]);
-            return p;
-        };
-
-    const juce::Path pathP10 = makePath(p10Pts);
-    const juce::Path pathP90 = makePath(p90Pts);
-    const juce::Path pathMed = makePath(medPts);
-
-    g.setColour(Theme::refBandEdge);
-    g.strokePath(pathP10, juce::PathStrokeType(1.5f));
-
-    g.setColour(Theme::refBandEdge);
-    g.strokePath(pathP90, juce::PathStrokeType(1.5f));
+    // Fill zwischen P10 und P90 (WICHTIG: P90 rückwärts!)
+    for (size_t i = p90Pts.size(); i-- > 0; )
+        referenceFillPath.lineTo(p90Pts[i]);
 
-    g.setColour(Theme::refMedian);
-    g.strokePath(pathMed, juce::PathStrokeType(2.0f));
+    referenceFillPath.closeSubPath();
 }
 
 
@@ -1215,14 +1255,16 @@ void AudioPluginAudioProcessorEditor::drawReferenceBands(juce::Graphics& g,
  */
 void AudioPluginAudioProcessorEditor::drawFrequencyGrid(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawFrequencyGrid");
+
     const float minFreq = 20.0f;
     const float maxFreq = 20000.0f;
 
-    g.setFont(15.0f);
+    g.setFont(scaled(15.0f));
     g.setColour(juce::Colours::white.withAlpha(0.5f));
 
     // Y-Position für Beschriftung (unterhalb des Spektrums)
-    float textY = (float)spectrumDisplayArea.getBottom() + 3.0f;
+    float textY = (float)spectrumDisplayArea.getBottom() + scaled(3.0f);
 
     // Durch alle definierten Rasterfrequenzen iterieren
     for (auto f : frequencies)
@@ -1248,10 +1290,10 @@ void AudioPluginAudioProcessorEditor::drawFrequencyGrid(juce::Graphics& g)
         // Beschriftung zentriert unter der Linie
         g.drawFittedText(
             text,
-            (int)(x - 15),
+            (int)(x - scaled(15.0f)),
             (int)textY,
-            30,
-            15,
+            scaled(30),
+            scaled(15),
             juce::Justification::centred,
             1
         );
@@ -1260,6 +1302,8 @@ void AudioPluginAudioProcessorEditor::drawFrequencyGrid(juce::Graphics& g)
 
 void AudioPluginAudioProcessorEditor::drawEQDbGridLines(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawEQDbGridLines");
+
     // Nur im EQ-View sinnvoll
     if (!showEQCurve)
         return;
@@ -1287,6 +1331,8 @@ void AudioPluginAudioProcessorEditor::drawEQDbGridLines(juce::Graphics& g)
 
 void AudioPluginAudioProcessorEditor::drawEQDbGridLabels(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawEQDbGridLabels");
+
     if (!showEQCurve)
         return;
 
@@ -1304,17 +1350,17 @@ void AudioPluginAudioProcessorEditor::drawEQDbGridLabels(juce::Graphics& g)
     const float rightBandX1 = display.getRight();
 
     // Falls die Ränder extrem schmal sind: trotzdem nicht crashen/zeichnen
-    if ((leftBandX1 - leftBandX0) < 10.0f || (rightBandX1 - rightBandX0) < 10.0f)
+    if ((leftBandX1 - leftBandX0) < scaled(10.0f) || (rightBandX1 - rightBandX0) < scaled(10.0f))
         return;
 
-    const float labelW = 36.0f;
-    const float labelH = 16.0f;
+    const float labelW = scaled(36.0f);
+    const float labelH = scaled(16.0f);
 
     const float leftLabelX = (leftBandX0 + leftBandX1) * 0.5f - labelW * 0.5f;
     const float rightLabelX = (rightBandX0 + rightBandX1) * 0.5f - labelW * 0.5f;
 
     g.setColour(juce::Colours::white.withAlpha(0.5f));
-    g.setFont(12.0f);
+    g.setFont(scaled(12.0f));
 
     auto drawLabel = [&](float x, float y, const juce::String& text)
         {
@@ -1346,6 +1392,8 @@ void AudioPluginAudioProcessorEditor::drawEQDbGridLabels(juce::Graphics& g)
  */
 void AudioPluginAudioProcessorEditor::drawEQAreas(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawEQAreas");
+
     // EQ Sliderbereich (blau)
     g.setColour(Theme::bgPanel);
     g.fillRect(eqArea);
@@ -1369,8 +1417,10 @@ void AudioPluginAudioProcessorEditor::drawEQAreas(juce::Graphics& g)
  */
 void AudioPluginAudioProcessorEditor::drawEQLabels(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawEQLabels");
+
     g.setColour(juce::Colours::white.withAlpha(0.5f));
-    g.setFont(14.0f);
+    g.setFont(scaled(14.0f));
 
     for (int i = 0; i < eqFrequencies.size(); i++)
     {
@@ -1397,10 +1447,10 @@ void AudioPluginAudioProcessorEditor::drawEQLabels(juce::Graphics& g)
         // Label zentriert zeichnen
         g.drawFittedText(
             label,
-            x - 20,
-            eqLabelArea.getY() + 5,
-            40,
-            20,
+            x - scaled(20),
+            eqLabelArea.getY() + scaled(5),
+            scaled(40),
+            scaled(20),
             juce::Justification::centred,
             1
         );
@@ -1409,6 +1459,8 @@ void AudioPluginAudioProcessorEditor::drawEQLabels(juce::Graphics& g)
 
 void AudioPluginAudioProcessorEditor::drawEQFaderDbScale(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawEQFaderDbScale");
+
     // Wir brauchen Slider-Bounds (also nach resized() vorhanden)
     const int leftIdx = 0;
     const int rightIdx = 30;
@@ -1438,9 +1490,9 @@ void AudioPluginAudioProcessorEditor::drawEQFaderDbScale(juce::Graphics& g)
         };
 
     // Layout der Textboxen links/rechts
-    const int labelW = 34;
-    const int labelH = 16;
-    const int pad = 6;
+    const int labelW = scaled(34);
+    const int labelH = scaled(16);
+    const int pad = scaled(6);
 
     int leftX = sL.getX() - pad - labelW;
     int rightX = sR.getRight() + pad;
@@ -1450,7 +1502,7 @@ void AudioPluginAudioProcessorEditor::drawEQFaderDbScale(juce::Graphics& g)
     rightX = juce::jmin(getWidth() - labelW, rightX);
 
     g.setColour(juce::Colours::white.withAlpha(0.5f));
-    g.setFont(12.0f);
+    g.setFont(scaled(12.0f));
 
     for (const auto& t : ticks)
     {
@@ -1471,6 +1523,8 @@ void AudioPluginAudioProcessorEditor::drawEQFaderDbScale(juce::Graphics& g)
 
 void AudioPluginAudioProcessorEditor::drawEQFaderDbGuideLines(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawEQFaderDbGuideLines");
+
     const int leftIdx = 0;
     const int rightIdx = 30;
 
@@ -1512,7 +1566,7 @@ void AudioPluginAudioProcessorEditor::drawEQFaderDbGuideLines(juce::Graphics& g)
     const float xMax = (float)eqArea.getRight();
 
     // Wie viel Abstand um jeden Fader ausgespart werden soll
-    const int gapPad = 3;
+    const int gapPad = scaled(3);
 
     // Für jede Linie: wir bauen Ausschlussbereiche (x-ranges) um jeden Slider
     for (const auto& t : ticks)
@@ -1595,21 +1649,90 @@ void AudioPluginAudioProcessorEditor::drawEQFaderDbGuideLines(juce::Graphics& g)
 //==============================================================================
 
 /**
- * @brief Timer-Callback für regelmäßige Display-Updates.
+ * @brief Timer-Callback für die Messung.
  *
- * Wird 30 mal pro Sekunde aufgerufen um das Spektrum zu aktualisieren.
- * Prüft ob neue FFT-Daten verfügbar sind und aktualisiert die Anzeige.
- * Speichert auch Messungs-Snapshots wenn eine Messung aktiv ist.
+ * Läuft nur während einer Messung (30 mal pro Sekunde) und unabhängig
+ * von der Sichtbarkeit des Fensters, damit keine Snapshots verloren gehen.
+ * Stoppt sich selbst, sobald keine Messung mehr läuft.
  */
 void AudioPluginAudioProcessorEditor::timerCallback()
 {
+    if (!processorRef.isMeasuring())
+    {
+        stopTimer();
+        return;
+    }
+
+    // Pre-EQ FFT für Messung aktualisieren
+    if (processorRef.getNextPreEQFFTBlockReady())
+    {
+        processorRef.updatePreEQSpectrumArray(processorRef.getSampleRate());
+        processorRef.setNextPreEQFFTBlockReady(false);
+
+        // Snapshot für Durchschnittsberechnung speichern
+        processorRef.addMeasurementSnapshot();
+    }
+}
+
+/**
+ * @brief VBlank-Callback für Display-Updates.
+ *
+ * Wird im Takt des Bildschirms aufgerufen, solange das Fenster einen
+ * Peer hat. Versteckt/minimiert wird nichts getan. Die Framerate wird
+ * auf kMaxFrameRateHz begrenzt und bei teurem paint() bis auf
+ * kMinFrameRateHz gesenkt. Ohne neue Daten wird kein Frame erzeugt.
+ *
+ * @param timestampSec Zeitstempel des VBlanks in Sekunden
+ */
+void AudioPluginAudioProcessorEditor::onVBlank(double timestampSec)
+{
+    // Versteckt, minimiert oder ohne Peer -> aussetzen
+    if (!isShowing())
+        return;
+
+    // Frame-Budget: Mindestabstand aus Maximalrate und Kosten des letzten paint()
+    const double minIntervalSec = juce::jlimit(1.0 / kMaxFrameRateHz, 1.0 / kMinFrameRateHz,
+        0.001 * lastPaintDurationMs / kPaintBudgetShare);
+
+    if (timestampSec - lastFrameTimestampSec < minIntervalSec)
+        return;
+
+    // Nur neu zeichnen wenn sich etwas geändert hat (nur der Kurvenbereich,
+    // alles andere steckt in den statischen Ebenen)
+    if (pullDisplayData())
+    {
+        lastFrameTimestampSec = timestampSec;
+        repaint(spectrumInnerArea);
+    }
+}
+
+/**
+ * @brief Holt neue Anzeigedaten vom Processor.
+ *
+ * Gleicht einen geladenen State ab, übernimmt einen fertigen
+ * Analyzer-Frame und aktualisiert in der EQ-Ansicht den Frequenzgang.
+ * Wird vom VBlank aufgerufen und vom GUI-Benchmark direkt.
+ *
+ * @return true wenn der Kurvenbereich neu gezeichnet werden muss
+ */
+bool AudioPluginAudioProcessorEditor::pullDisplayData()
+{
+    const TraceRecorder::Scope traceScope("pullDisplayData", "gui", processorRef.getTraceId());
+
+    // Host hat einen State geladen -> Genre-Auswahl, Buttons und Zielkurve nachziehen
+    if (processorStateVersion != processorRef.getStateVersion())
+        syncWithProcessorState();
+
     bool needsRepaint = false;
 
     // Post-EQ FFT für Anzeige aktualisieren
     if (processorRef.getNextFFTBlockReady())
     {
+        const double fftStartMs = juce::Time::getMillisecondCounterHiRes();
         processorRef.updateSpectrumArray(processorRef.getSampleRate());
         processorRef.setNextFFTBlockReady(false);
+        processorRef.getPerformanceCounters().fftMs.store(
+            (float)(juce::Time::getMillisecondCounterHiRes() - fftStartMs), std::memory_order_relaxed);
 
         // Offset live berechnen
         if (!processorRef.referenceBands.empty())
@@ -1629,24 +1752,29 @@ void AudioPluginAudioProcessorEditor::timerCallback()
         needsRepaint = true;
     }
 
-    // Pre-EQ FFT für Messung aktualisieren
-    if (processorRef.getNextPreEQFFTBlockReady())
-    {
-        processorRef.updatePreEQSpectrumArray(processorRef.getSampleRate());
-        processorRef.setNextPreEQFFTBlockReady(false);
+    // EQ-Ansicht: nur neu zeichnen wenn sich der Frequenzgang geändert hat
+    if (showEQCurve && updateEQResponseCache())
+        needsRepaint = true;
 
-        // Snapshot für Durchschnittsberechnung speichern wenn Messung aktiv
-        if (processorRef.isMeasuring())
-        {
-            processorRef.addMeasurementSnapshot();
-        }
-    }
+    return needsRepaint;
+}
 
-    // Nur neu zeichnen wenn sich etwas geändert hat
-    if (needsRepaint)
-    {
-        repaint();
-    }
+/**
+ * @brief Gleicht die UI nach einem geladenen Plugin-State an.
+ *
+ * Parameter-Slider folgen über ihre Attachments von selbst; hier
+ * werden nur die Teile nachgezogen, die nicht an Parametern hängen
+ * (Genre-Auswahl, Mess-Button, Zielkurve). Referenzpfade erkennen
+ * die Änderung an getReferenceBandsVersion().
+ */
+void AudioPluginAudioProcessorEditor::syncWithProcessorState()
+{
+    processorStateVersion = processorRef.getStateVersion();
+
+    genreBox.setSelectedId(processorRef.selectedGenreId, juce::dontSendNotification);
+    updateMeasurementButtonEnabledState();
+    updateSnapshotButtons();
+    repaint();
 }
 
 //==============================================================================
@@ -1661,6 +1789,8 @@ void AudioPluginAudioProcessorEditor::timerCallback()
  */
 void AudioPluginAudioProcessorEditor::resized()
 {
+    uiScale = (float)getWidth() / (float)baseWidth;
+
     auto area = getLocalBounds();
 
     layoutTopBar(area);
@@ -1669,6 +1799,11 @@ void AudioPluginAudioProcessorEditor::resized()
     layoutEQSliders();
     layoutQKnobs();
     calculateSpectrumInnerArea();
+
+    performanceHud.setBounds(spectrumInnerArea.getX() + scaled(8), spectrumInnerArea.getY() + scaled(8),
+        scaled(340), scaled(150));
+
+    invalidateStaticLayers();
 }
 
 //==============================================================================
@@ -1683,14 +1818,24 @@ void AudioPluginAudioProcessorEditor::resized()
 void AudioPluginAudioProcessorEditor::layoutTopBar(juce::Rectangle<int>& area)
 {
     // Topbar-Bereich vom Hauptbereich abtrennen
-    topBarArea = area.removeFromTop(topBarHeight);
+    topBarArea = area.removeFromTop(scaled(topBarHeight));
 
-    // Alle Controls mit festen Positionen
-    genreErkennenButton.setBounds(10, 5, 140, 30);
-    loadReferenceButton.setBounds(560, 5, 140, 30);
-    eqCurveToggleButton.setBounds(160, 5, 140, 30);
-    genreBox.setBounds(710, 5, 220, 30);
-    resetButton.setBounds(940, 5, 50, 30);
+    // Alle Controls mit festen (Basis-)Positionen, skaliert
+    auto place = [this](juce::Component& c, int x, int y, int w, int h)
+        {
+            c.setBounds(scaled(x), scaled(y), scaled(w), scaled(h));
+        };
+
+    place(genreErkennenButton, 10, 5, 140, 30);
+    place(loadReferenceButton, 560, 5, 140, 30);
+    place(eqCurveToggleButton, 160, 5, 140, 30);
+    place(adaptiveToggleButton, 310, 5, 100, 30);
+    place(hudToggleButton, 420, 5, 50, 30);
+    place(snapshotAButton, 476, 5, 26, 30);
+    place(snapshotBButton, 504, 5, 26, 30);
+    place(snapshotMorphKnob, 532, 5, 26, 30);
+    place(genreBox, 710, 5, 220, 30);
+    place(resetButton, 940, 5, 50, 30);
 }
 
 /**
@@ -1701,13 +1846,13 @@ void AudioPluginAudioProcessorEditor::layoutTopBar(juce::Rectangle<int>& area)
 void AudioPluginAudioProcessorEditor::layoutSpectrumAreas(juce::Rectangle<int>& area)
 {
     // Äußerer Bereich für Spektrogramm
-    auto spectroOuter = area.removeFromTop(spectrogramOuterHeight);
+    auto spectroOuter = area.removeFromTop(scaled(spectrogramOuterHeight));
 
     // Innerer Bereich mit Rand
-    spectrogramArea = spectroOuter.reduced(spectrogramMargin);
+    spectrogramArea = spectroOuter.reduced(scaled(spectrogramMargin));
 
     // Display-Bereich für das Spektrum
-    spectrumDisplayArea = spectrogramArea.removeFromTop(spectrumHeight);
+    spectrumDisplayArea = spectrogramArea.removeFromTop(scaled(spectrumHeight));
 }
 
 /**
@@ -1720,8 +1865,8 @@ void AudioPluginAudioProcessorEditor::layoutEQAreas(juce::Rectangle<int>& area)
     auto eqFullArea = area;
     area = {};
 
-    eqLabelArea = eqFullArea.removeFromBottom(eqLabelHeight);
-    eqKnobArea = eqFullArea.removeFromBottom(eqSpacerHeight);
+    eqLabelArea = eqFullArea.removeFromBottom(scaled(eqLabelHeight));
+    eqKnobArea = eqFullArea.removeFromBottom(scaled(eqSpacerHeight));
     eqArea = eqFullArea;
 }
 
@@ -1740,14 +1885,14 @@ void AudioPluginAudioProcessorEditor::layoutEQSliders()
         int x = eqArea.getX() + static_cast<int>(normX * eqArea.getWidth());
 
         // Slider-Dimensionen
-        int sliderWidth = 16;
-        const int verticalMargin = 8;
+        int sliderWidth = scaled(16);
+        const int verticalMargin = scaled(8);
         int sliderHeight = eqArea.getHeight() - 2 * verticalMargin;
 
         // Slider zentriert positionieren
         eqSlider[i].setBounds(
             x - sliderWidth / 2,
-            eqArea.getY() + 10,
+            eqArea.getY() + scaled(10),
             sliderWidth,
             sliderHeight
         );
@@ -1774,7 +1919,8 @@ void AudioPluginAudioProcessorEditor::layoutQKnobs()
         int x = centerX - knobDiameter / 2;
         int y = eqKnobArea.getCentreY() - knobDiameter / 2;
 
-        eqKnob[i].setBounds(x, y, knobDiameter, knobDiameter);
+        if (eqKnob[i] != nullptr)
+            eqKnob[i]->setBounds(x, y, knobDiameter, knobDiameter);
     }
 }
 
@@ -1817,6 +1963,8 @@ void AudioPluginAudioProcessorEditor::calculateSpectrumInnerArea()
  */
 void AudioPluginAudioProcessorEditor::drawFrame(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawFrame");
+
     auto& spectrum = processorRef.spectrumArray;
     if (spectrum.empty())
         return;
@@ -1824,18 +1972,21 @@ void AudioPluginAudioProcessorEditor::drawFrame(juce::Graphics& g)
     // 1. Smoothing-Buffer initialisieren
     initializeSmoothedLevels(spectrum);
 
-    // 2. Spektrumpunkte mit Exponential Smoothing berechnen
-    auto validPoints = calculateSpectrumPoints(spectrum);
+    // 2. X-Positionen nur bei Resize / geänderter Bandanzahl neu berechnen
+    updateSpectrumColumns(spectrum);
+
+    // 3. Spektrumpunkte mit Exponential Smoothing berechnen
+    calculateSpectrumPoints(spectrum);
 
-    // 3. Räumliches Smoothing für glattere Kurve anwenden
-    applySpatialSmoothingToPoints(validPoints);
+    // 4. Räumliches Smoothing für glattere Kurve anwenden
+    applySpatialSmoothingToPoints(spectrumPoints);
 
     // 5. Mindestens 2 Punkte für eine Linie benötigt
-    if (validPoints.size() < 2)
+    if (spectrumPoints.size() < 2)
         return;
 
     // 6. Spektrumkurve zeichnen
-    drawSpectrumPath(g, validPoints);
+    drawSpectrumPath(g, spectrumPoints);
 }
 
 //==============================================================================
@@ -1865,38 +2016,80 @@ void AudioPluginAudioProcessorEditor::initializeSmoothedLevels(
 }
 
 /**
- * @brief Berechnet die Pixel-Koordinaten für alle Spektrumpunkte.
+ * @brief Berechnet die X-Positionen der Spektrumpunkte vor.
  *
- * Wendet dabei Exponential Smoothing (zeitliches Glätten) an und
- * konvertiert Frequenz/dB-Werte zu Bildschirmkoordinaten.
+ * Die Bandfrequenzen sind fest, daher hängen die X-Positionen nur vom
+ * Zeichenbereich und der Bandanzahl ab. Neu berechnet wird nur nach
+ * einem Resize oder wenn sich die Bandanzahl (Samplerate) ändert.
+ * Hier werden auch die Punkt- und Smoothing-Puffer dimensioniert.
  *
  * @param spectrum Referenz auf das aktuelle Spektrum-Array
- * @return Vector mit Punktkoordinaten für den Pfad
  */
-std::vector<juce::Point<float>> AudioPluginAudioProcessorEditor::calculateSpectrumPoints(
+void AudioPluginAudioProcessorEditor::updateSpectrumColumns(
     const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum)
 {
+    if (spectrumColumnsArea == spectrumInnerArea && spectrumColumnsSourceSize == spectrum.size())
+        return;
+
+    spectrumColumnsArea = spectrumInnerArea;
+    spectrumColumnsSourceSize = spectrum.size();
+
     auto area = spectrumInnerArea.toFloat();
 
-    // Display-Grenzen
-    // Display-Grenzen je nach Ansicht
-    const float displayMinDb = showEQCurve ? -12.0f : kRefViewMinDb;
-    const float displayMaxDb = showEQCurve ? 12.0f : kRefViewMaxDb;
     const float minFreq = 20.0f;
     const float maxFreq = 20000.0f;
     const float logMin = std::log10(minFreq);
     const float logMax = std::log10(maxFreq);
 
-    std::vector<juce::Point<float>> validPoints;
+    spectrumColumns.clear();
+    spectrumColumns.reserve(spectrum.size());
 
     for (size_t i = 0; i < spectrum.size(); ++i)
     {
-        auto& point = spectrum[i];
+        const float freq = spectrum[i].frequency;
 
         // Nur Frequenzen im sichtbaren Bereich verarbeiten
-        if (point.frequency < minFreq || point.frequency > maxFreq)
+        if (freq < minFreq || freq > maxFreq)
             continue;
 
+        // Frequenz logarithmisch auf X-Position abbilden
+        const float x = area.getX() + juce::jmap(std::log10(freq), logMin, logMax, 0.0f, 1.0f) * area.getWidth();
+        spectrumColumns.push_back({ i, x });
+    }
+
+    // Puffer einmalig auf Maximalgröße bringen
+    spectrumPoints.reserve(spectrumColumns.size());
+    spectrumYScratch.reserve(spectrumColumns.size());
+    spectrumYSmoothed.reserve(spectrumColumns.size());
+    spectrumPath.preallocateSpace(3 * (int)spectrumColumns.size());
+}
+
+/**
+ * @brief Berechnet die Pixel-Koordinaten für alle Spektrumpunkte.
+ *
+ * Wendet dabei Exponential Smoothing (zeitliches Glätten) an und
+ * konvertiert dB-Werte zu Y-Koordinaten. Die X-Positionen kommen
+ * aus spectrumColumns, das Ergebnis landet in spectrumPoints.
+ *
+ * @param spectrum Referenz auf das aktuelle Spektrum-Array
+ */
+void AudioPluginAudioProcessorEditor::calculateSpectrumPoints(
+    const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum)
+{
+    auto area = spectrumInnerArea.toFloat();
+
+    // Display-Grenzen je nach Ansicht
+    const float displayMinDb = showEQCurve ? -12.0f : kRefViewMinDb;
+    const float displayMaxDb = showEQCurve ? 12.0f : kRefViewMaxDb;
+
+    const bool hasReference = !processorRef.referenceBands.empty();
+
+    spectrumPoints.clear();
+
+    for (const auto& column : spectrumColumns)
+    {
+        auto& point = spectrum[column.index];
+
         // Exponential Smoothing: Kombiniert alten und neuen Wert
         // smoothingFactor nahe 1.0 = langsame Änderung (mehr Glätten)
         // Bass bekommt viel mehr zeitliche Glättung (ruhiger), Höhen dürfen schneller reagieren
@@ -1905,31 +2098,26 @@ std::vector<juce::Point<float>> AudioPluginAudioProcessorEditor::calculateSpectr
         if (point.frequency < 80.0f) a = 0.98f;
         if (point.frequency < 40.0f) a = 0.985f;
 
-        smoothedLevels[i] = smoothedLevels[i] * a + point.level * (1.0f - a);
-
+        float& smoothed = smoothedLevels[column.index];
+        smoothed = smoothed * a + point.level * (1.0f - a);
 
-        float level = smoothedLevels[i];
-        if (!processorRef.referenceBands.empty())
+        float level = smoothed;
+        if (hasReference)
             level += referenceViewOffsetDb;
 
-        // Frequenz logarithmisch auf X-Position abbilden
-        float logFreq = std::log10(point.frequency);
-        float x = area.getX() + juce::jmap(logFreq, logMin, logMax, 0.0f, 1.0f) * area.getWidth();
-
         // dB-Wert auf Y-Position abbilden (invertiert: oben = laut)
         float db = juce::jlimit(displayMinDb, displayMaxDb, level);
         float y = juce::jmap(db, displayMinDb, displayMaxDb, area.getBottom(), area.getY());
 
-        validPoints.push_back({ x, y });
+        spectrumPoints.push_back({ column.x, y });
     }
-
-    return validPoints;
 }
 
 /**
  * @brief Wendet räumliches Smoothing auf die Y-Werte an.
  *
  * Glättet die Kurve durch Mittelwertbildung benachbarter Punkte.
+ * Nutzt die Member-Puffer spectrumYScratch/spectrumYSmoothed.
  *
  * @param points Referenz auf die Punktliste (wird modifiziert)
  */
@@ -1937,18 +2125,17 @@ void AudioPluginAudioProcessorEditor::applySpatialSmoothingToPoints(
     std::vector<juce::Point<float>>& points)
 {
     // Y-Werte extrahieren
-    std::vector<float> yValues;
-    yValues.reserve(points.size());
+    spectrumYScratch.clear();
 
     for (const auto& point : points)
-        yValues.push_back(point.getY());
+        spectrumYScratch.push_back(point.getY());
 
-    // Räumliches Smoothing mit Fenstergröße 5 anwenden
-    auto smoothedY = applySpatialSmoothing(yValues, 3);
+    // Räumliches Smoothing mit Fenstergröße 3 anwenden
+    applySpatialSmoothing(spectrumYScratch, spectrumYSmoothed, 3);
 
     // Geglättete Y-Werte zurückschreiben
-    for (size_t i = 0; i < points.size() && i < smoothedY.size(); ++i)
-        points[i].setY(smoothedY[i]);
+    for (size_t i = 0; i < points.size() && i < spectrumYSmoothed.size(); ++i)
+        points[i].setY(spectrumYSmoothed[i]);
 }
 
 /**
@@ -1964,8 +2151,10 @@ void AudioPluginAudioProcessorEditor::drawSpectrumPath(
     juce::Graphics& g,
     const std::vector<juce::Point<float>>& points)
 {
-    // Pfad aus Punkten aufbauen
-    juce::Path spectrumPath;
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawSpectrumPath");
+
+    // Pfad aus Punkten aufbauen (Speicher des Member-Pfads wird wiederverwendet)
+    spectrumPath.clear();
     spectrumPath.startNewSubPath(points[0]);
 
     for (size_t i = 1; i < points.size(); ++i)
@@ -1995,16 +2184,20 @@ void AudioPluginAudioProcessorEditor::drawSpectrumPath(
  * innerhalb des angegebenen Fensters.
  *
  * @param levels Die zu glättenden Werte
+ * @param smoothed Ausgabe mit geglätteten Werten (wird auf Größe gebracht)
  * @param windowSize Größe des Glättungsfensters
- * @return Vector mit geglätteten Werten
  */
-std::vector<float> AudioPluginAudioProcessorEditor::applySpatialSmoothing(
-    const std::vector<float>& levels, int windowSize)
+void AudioPluginAudioProcessorEditor::applySpatialSmoothing(
+    const std::vector<float>& levels, std::vector<float>& smoothed, int windowSize)
 {
+    smoothed.resize(levels.size());
+
     if (levels.empty() || windowSize < 1)
-        return levels;
+    {
+        std::copy(levels.begin(), levels.end(), smoothed.begin());
+        return;
+    }
 
-    std::vector<float> smoothed(levels.size());
     int halfWindow = windowSize / 2;
 
     for (size_t i = 0; i < levels.size(); ++i)
@@ -2027,8 +2220,6 @@ std::vector<float> AudioPluginAudioProcessorEditor::applySpatialSmoothing(
 
         smoothed[i] = (count > 0) ? (sum / count) : levels[i];
     }
-
-    return smoothed;
 }
 
 //==============================================================================
@@ -2038,30 +2229,20 @@ std::vector<float> AudioPluginAudioProcessorEditor::applySpatialSmoothing(
 /**
  * @brief Zeichnet die kombinierte EQ-Frequenzgang-Kurve.
  *
- * Berechnet und zeichnet den Gesamtfrequenzgang aller aktiven
- * EQ-Bänder sowie die Ziel-Korrekturkurve.
+ * Zeichnet den gecachten Gesamtfrequenzgang aller aktiven EQ-Bänder
+ * sowie die Ziel-Korrekturkurve. Berechnet wird nur, wenn sich ein
+ * Parameter geändert hat.
  *
  * @param g Der Graphics-Kontext zum Zeichnen
  */
 void AudioPluginAudioProcessorEditor::drawEQCurve(juce::Graphics& g)
 {
-    const int numPoints = 2000;
-    const float minFreq = 20.0f;
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawEQCurve");
 
-    float sr = (float)processorRef.getSampleRate();
-    if (!(sr > 0.0f)) sr = 48000.0f;
-
-    const float maxUsable = 0.5f * sr * 0.999f;
-    const float maxFreqDraw = juce::jmin(20000.0f, maxUsable);
-
-    // WICHTIG: genau dieses Array später weiterverwenden
-    auto frequencies = generateLogFrequencies(numPoints, minFreq, maxFreqDraw);
+    updateEQResponseCache();
+    rebuildEQPathIfNeeded();
 
-    auto totalMagnitudeDB = calculateTotalMagnitude(frequencies, numPoints);
-
-    auto eqPath = buildEQPath(frequencies, totalMagnitudeDB, numPoints, minFreq, maxFreqDraw);
-
-    drawEQPathWithFill(g, eqPath);
+    drawEQPathWithFill(g, eqCurvePath, eqCurveFillPath);
     drawTargetEQCurve(g);
 }
 
@@ -2098,681 +2279,331 @@ std::vector<float> AudioPluginAudioProcessorEditor::generateLogFrequencies(
 }
 
 /**
- * @brief Berechnet die Gesamtmagnitude aller EQ-Bänder.
+ * @brief Gleicht den EQ-Cache mit den aktuellen Parametern ab.
  *
- * Summiert die Frequenzgänge aller aktiven EQ-Filter.
- * Filter mit Gain < 0.01 dB werden übersprungen.
+ * Liest Gain und Q aller Bänder aus dem Parameter-State. Nur Bänder,
+ * deren Werte sich geändert haben, werden neu berechnet. Bei geänderter
+ * Samplerate wird das Frequenzraster neu angelegt.
  *
- * @param frequencies Array der Frequenzpunkte
- * @param numPoints Anzahl der Frequenzpunkte
- * @return Vector mit Magnitude in dB für jeden Frequenzpunkt
+ * @return true wenn sich der Frequenzgang geändert hat
  */
-std::vector<float> AudioPluginAudioProcessorEditor::calculateTotalMagnitude(
-    const std::vector<float>& frequencies, int numPoints)
+bool AudioPluginAudioProcessorEditor::updateEQResponseCache()
 {
-    std::vector<float> totalMagnitudeDB(numPoints, 0.0f);
+    double sr = processorRef.getSampleRate();
+    if (!(sr > 0.0)) sr = 48000.0;
 
-    // Samplerate für korrekte Filterberechnung
-    float sampleRate = processorRef.getSampleRate();
-    if (sampleRate <= 0.0f)
-        sampleRate = 48000.0f;  // Fallback
+    const auto versionBefore = eqResponse.getVersion();
 
-    // Durch alle 31 EQ-Bänder iterieren
-    for (int bandIdx = 0; bandIdx < 31; ++bandIdx)
+    if (!eqResponse.isPreparedFor(sr))
     {
-        float f0 = eqFrequencies[bandIdx];
-        float gainDb = eqSlider[bandIdx].getValue();
-        float Q = eqKnob[bandIdx].getValue();
-
-        // Nur aktive Bänder berechnen (Gain > 0.01 dB)
-        if (std::abs(gainDb) > 0.01f)
-        {
-            // Magnitude für jede Frequenz berechnen
-            for (int i = 0; i < numPoints; ++i)
-            {
-                auto H = peakingEQComplex(frequencies[i], f0, Q, gainDb, sampleRate);
-                float magDb = 20.0f * std::log10(std::abs(H));
-                totalMagnitudeDB[i] += magDb;  // Additiv in dB (= multiplikativ linear)
-            }
-        }
+        const auto range = getEQFrequencyRange();
+        eqResponse.prepare(eqFrequencies, sr, range.getStart(), range.getEnd());
     }
 
-    return totalMagnitudeDB;
+    for (int i = 0; i < 31; ++i)
+        eqResponse.setBand(i, eqGainValues[i]->load(), eqQValues[i]->load());
+
+    return eqResponse.getVersion() != versionBefore;
 }
 
 /**
- * @brief Erstellt einen Pfad aus Frequenz- und Magnitude-Daten.
- *
- * @param frequencies Array der Frequenzpunkte
- * @param magnitudeDB Array der Magnitude-Werte in dB
- * @param numPoints Anzahl der Punkte
- * @param minFreq Minimale Frequenz für Skalierung
- * @param maxFreq Maximale Frequenz für Skalierung
- * @return juce::Path Objekt für das Zeichnen
+ * @brief Baut den EQ-Pfad neu, falls sich Daten oder Zeichenbereich geändert haben.
  */
-juce::Path AudioPluginAudioProcessorEditor::buildEQPath(
-    const std::vector<float>& frequencies,
-    const std::vector<float>& magnitudeDB,
-    int numPoints, float minFreq, float maxFreq)
+void AudioPluginAudioProcessorEditor::rebuildEQPathIfNeeded()
 {
-    juce::Path eqPath;
-    bool firstPoint = true;
+    if (eqCurvePathVersion == eqResponse.getVersion() && eqCurvePathArea == spectrumInnerArea)
+        return;
+
+    eqCurvePathVersion = eqResponse.getVersion();
+    eqCurvePathArea = spectrumInnerArea;
+
+    const auto& frequencies = eqResponse.getFrequencies();
+    const auto& magnitudeDB = eqResponse.getTotalDb();
     auto area = spectrumInnerArea.toFloat();
 
-    for (int i = 0; i < numPoints; ++i)
-    {
-        float freq = frequencies[i];
-        float db = magnitudeDB[i];
+    eqCurvePath.clear();
+    eqCurvePath.preallocateSpace(3 * (int)frequencies.size());
 
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
         // Frequenz auf X-Position abbilden
-        float normX = juce::mapFromLog10(freq, minFreq, maxFreq);
-        float x = area.getX() + normX * area.getWidth();
+        float x = eqFrequencyToX(frequencies[i]);
 
         // dB auf Y-Position abbilden (begrenzt auf ±12 dB)
-        float clampedDb = juce::jlimit(-12.0f, 12.0f, db);
+        float clampedDb = juce::jlimit(-12.0f, 12.0f, magnitudeDB[i]);
         float y = juce::jmap(clampedDb, -12.0f, 12.0f,
             area.getBottom(), area.getY());
 
         // Pfad aufbauen
-        if (firstPoint)
-        {
-            eqPath.startNewSubPath(x, y);
-            firstPoint = false;
-        }
+        if (i == 0)
+            eqCurvePath.startNewSubPath(x, y);
         else
-        {
-            eqPath.lineTo(x, y);
-        }
+            eqCurvePath.lineTo(x, y);
     }
 
-    return eqPath;
+    // Gefüllter Bereich zwischen Kurve und 0dB-Linie
+    const float y0dB = juce::jmap(0.0f, -12.0f, 12.0f, area.getBottom(), area.getY());
+
+    eqCurveFillPath = eqCurvePath;
+    eqCurveFillPath.lineTo(area.getRight(), y0dB);
+    eqCurveFillPath.lineTo(area.getX(), y0dB);
+    eqCurveFillPath.closeSubPath();
 }
 
 /**
  * @brief Zeichnet die EQ-Kurve mit 0dB-Linie und Füllung.
  *
  * @param g Der Graphics-Kontext zum Zeichnen
- * @param eqPath Der zu zeichnende Pfad
- */
-void AudioPluginAudioProcessorEditor::drawEQPathWithFill(juce::Graphics& g, const juce::Path& eqPath)
-{
-    auto area = spectrumInnerArea.toFloat();
-
-    // 0 dB Referenzlinie zeichnen
-    float y0dB = juce::jmap(0.0f, -12.0f, 12.0f, area.getBottom(), area.getY());
-    g.setColour(juce::Colours::white.withAlpha(0.3f));
-    g.drawHorizontalLine((int)y0dB, area.getX(), area.getRight());
-
-    // EQ Kurve zeichnen
-    g.setColour(Theme::curveEQ.withAlpha(0.9f));
-    g.strokePath(eqPath, juce::PathStrokeType(3.0f));
-
-    // Gefüllten Bereich zwischen Kurve und 0dB-Linie zeichnen
-    juce::Path filledPath = eqPath;
-    filledPath.lineTo(area.getRight(), y0dB);
-    filledPath.lineTo(area.getX(), y0dB);
-    filledPath.closeSubPath();
-
-    g.setColour(Theme::curveEQ.withAlpha(0.15f));
-    g.fillPath(filledPath);
-}
-
-/**
- * @brief Berechnet die komplexe Übertragungsfunktion eines Peaking-EQ-Filters.
- *
- * Implementiert einen parametrischen EQ-Filter basierend auf dem
- * "Audio EQ Cookbook" von Robert Bristow-Johnson.
- *
- * @param freq Frequenz für die Berechnung in Hz
- * @param f0 Mittenfrequenz des Filters in Hz
- * @param Q Q-Faktor (Güte/Bandbreite) des Filters
- * @param gainDb Verstärkung/Dämpfung in dB
- * @param sampleRate Abtastrate in Hz
- * @return Komplexe Übertragungsfunktion H(f)
- */
-std::complex<float> AudioPluginAudioProcessorEditor::peakingEQComplex(
-    float freq, float f0, float Q, float gainDb, float sampleRate)
-{
-    // Gain-Faktor (linear)
-    const float A = std::pow(10.0f, gainDb / 40.0f);
-
-    // Normierte Kreisfrequenzen
-    const float w0 = juce::MathConstants<float>::twoPi * f0 / sampleRate;
-    const float w = juce::MathConstants<float>::twoPi * freq / sampleRate;
-
-    // Bandbreiten-Parameter
-    const float alpha = std::sin(w0) / (2.0f * Q);
-
-    // Biquad-Koeffizienten berechnen
-    float b0 = 1.0f + alpha * A;
-    float b1 = -2.0f * std::cos(w0);
-    float b2 = 1.0f - alpha * A;
-    float a0 = 1.0f + alpha / A;
-    float a1 = -2.0f * std::cos(w0);
-    float a2 = 1.0f - alpha / A;
-
-    // Normieren auf a0
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
-
-    // Komplexe Exponentialfunktionen für z^-1 und z^-2
-    std::complex<float> expMinusJw(std::cos(-w), std::sin(-w));
-    std::complex<float> expMinus2Jw(std::cos(-2.0f * w), std::sin(-2.0f * w));
-
-    // Übertragungsfunktion H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
-    std::complex<float> num = b0 + b1 * expMinusJw + b2 * expMinus2Jw;
-    std::complex<float> den = 1.0f + a1 * expMinusJw + a2 * expMinus2Jw;
-
-    return num / den;
-}
-
-//==============================================================================
-//                              Gains-Fit
-//==============================================================================
-
-namespace
-{
-    // Log-Interpolation: 31 Bandpunkte -> Zielkurve auf beliebigen Frequenzen
-    static float interpLogCurveDb(const std::vector<float>& bandFreqs,
-        const std::vector<float>& bandDb,
-        float fHz)
-    {
-        jassert(bandFreqs.size() == bandDb.size());
-        if (bandFreqs.empty()) return 0.0f;
-
-        if (fHz <= bandFreqs.front()) return bandDb.front();
-        if (fHz >= bandFreqs.back())  return bandDb.back();
-
-        const float lf = std::log10(fHz);
-
-        for (size_t i = 1; i < bandFreqs.size(); ++i)
-        {
-            if (bandFreqs[i] >= fHz)
-            {
-                const float f0 = bandFreqs[i - 1];
-                const float f1 = bandFreqs[i];
-                const float l0 = std::log10(f0);
-                const float l1 = std::log10(f1);
-
-                const float t = (lf - l0) / (l1 - l0);
-                return bandDb[i - 1] + t * (bandDb[i] - bandDb[i - 1]);
-            }
-        }
-
-        return bandDb.back();
-    }
-
-    // Berechnet EQ-Response in dB (Summe der log-Magnitudes) für gegebene Gains+Qs
-    static void computeEQResponseDb(const std::vector<float>& freqs,
-        const std::array<float, 31>& gainsDb,
-        const std::array<float, 31>& Qs,
-        float sampleRate,
-        std::vector<float>& outDb,
-        const std::vector<float>& eqFreqs)
-    {
-        outDb.assign(freqs.size(), 0.0f);
-
-        float sr = sampleRate;
-        if (!(sr > 0.0f))
-            sr = 48000.0f;
-
-        const float nyq = 0.5f * sr;
-        const float maxUsableHz = nyq * 0.999f; // Sicherheitsabstand zu Nyquist
-
-        for (size_t k = 0; k < freqs.size(); ++k)
-        {
-            const float fIn = freqs[k];
-            const float f = juce::jlimit(20.0f, maxUsableHz, fIn);
-
-            double sumDb = 0.0;
-
-            for (int i = 0; i < 31; ++i)
-            {
-                const float gRaw = gainsDb[(size_t)i];
-                if (std::abs(gRaw) <= 0.0001f)
-                    continue;
-
-                float f0 = eqFreqs[(size_t)i];
-                f0 = juce::jlimit(20.0f, maxUsableHz, f0);
-
-                float Q = Qs[(size_t)i];
-                Q = juce::jmax(0.001f, Q);
-
-                // Gain clamp + finite
-                const float g = finiteClamp(gRaw, -12.0f, 12.0f, 0.0f);
-
-                const float A = std::pow(10.0f, g / 40.0f);
-
-                const float w0 = juce::MathConstants<float>::twoPi * f0 / sr;
-                const float w = juce::MathConstants<float>::twoPi * f / sr;
-
-                const float alpha = std::sin(w0) / (2.0f * Q);
-
-                float b0 = 1.0f + alpha * A;
-                float b1 = -2.0f * std::cos(w0);
-                float b2 = 1.0f - alpha * A;
-
-                float a0 = 1.0f + alpha / A;
-                float a1 = -2.0f * std::cos(w0);
-                float a2 = 1.0f - alpha / A;
-
-                // Normieren auf a0
-                b0 /= a0; b1 /= a0; b2 /= a0;
-                a1 /= a0; a2 /= a0;
-
-                // H(e^jw) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2), z^-1 = e^{-jw}
-                const std::complex<float> z1(std::cos(-w), std::sin(-w));
-                const std::complex<float> z2(std::cos(-2.0f * w), std::sin(-2.0f * w));
-
-                const std::complex<float> num = b0 + b1 * z1 + b2 * z2;
-                const std::complex<float> den = 1.0f + a1 * z1 + a2 * z2;
-
-                const float denMag = std::abs(den);
-                if (!std::isfinite(denMag) || denMag < 1.0e-12f)
-                    continue; // Beitrag überspringen statt NaN zu erzeugen
-
-                float mag = std::abs(num / den);
-                if (!std::isfinite(mag)) mag = 1.0f;
-                mag = std::max(1.0e-8f, mag);
-
-                float magDb = 20.0f * std::log10(mag);
-                if (!std::isfinite(magDb)) magDb = 0.0f;
-
-                sumDb += (double)magDb;
-            }
-
-            outDb[k] = (float)sumDb;
-        }
-    }
-
-    static juce::Path buildResponsePath(
-        const juce::Rectangle<float>& area,
-        const std::vector<float>& freqs,
-        const std::vector<float>& respDb,
-        float minFreq, float maxFreq,
-        float minDb, float maxDb)
-    {
-        juce::Path p;
-        bool first = true;
-
-        for (size_t i = 0; i < freqs.size() && i < respDb.size(); ++i)
-        {
-            const float f = freqs[i];
-            const float db = juce::jlimit(minDb, maxDb, respDb[i]);
-
-            const float x = area.getX() + juce::mapFromLog10(f, minFreq, maxFreq) * area.getWidth();
-            const float y = juce::jmap(db, minDb, maxDb, area.getBottom(), area.getY());
-
-            if (first) { p.startNewSubPath(x, y); first = false; }
-            else { p.lineTo(x, y); }
-        }
-        return p;
-    }
-
-    static float computeMakeupGainDbFromEQ(const std::vector<float>& freqs,
-        const std::array<float, 31>& gainsDb,
-        const std::array<float, 31>& Qs,
-        float sampleRate,
-        const std::vector<float>& eqFreqs)
-    {
-        std::vector<float> respDb;
-        computeEQResponseDb(freqs, gainsDb, Qs, sampleRate, respDb, eqFreqs);
-
-        // Wir mitteln im "relevanten" Bereich (Bass nicht überbewerten)
-        const float fMin = 60.0f;
-        const float fMax = 12000.0f;
-
-        double sumW = 0.0;
-        double sumPow = 0.0;
-
-        for (size_t k = 0; k < freqs.size(); ++k)
-        {
-            const float f = freqs[k];
-            if (f < fMin || f > fMax) continue;
-
-            // Gewicht: Bass etwas weniger, Mitten normal
-            double w = 1.0;
-            if (f < 120.0f) w *= 0.6;      // Bass weniger stark zählen
-            if (f > 8000.0f) w *= 0.8;     // Air weniger stark zählen
-
-            const double db = (double)respDb[k];
-
-            // respDb = 20log10(|H|) -> Power-Gain = |H|^2 = 10^(db/10)
-            const double powGain = std::pow(10.0, db / 10.0);
-
-            sumPow += w * powGain;
-            sumW += w;
-        }
-
-        if (sumW <= 1.0e-12) return 0.0f;
-
-        const double meanPow = sumPow / sumW;
-
-        // Makeup so, dass mittlere Power wieder ~1 wird
-        const double makeupDb = -10.0 * std::log10(std::max(1.0e-12, meanPow));
-        return (float)makeupDb;
-    }
-
-    // Löser für symmetrisches, positiv definites LGS (Cholesky) – n ist klein (31)
-    static bool solveSPD_Cholesky(std::vector<double>& A, std::vector<double>& b, int n)
-    {
-        // A ist n*n in row-major
-        // Cholesky: A = L*L^T (wir speichern L in A)
-        for (int i = 0; i < n; ++i)
-        {
-            for (int j = 0; j <= i; ++j)
-            {
-                double sum = A[(size_t)i * n + j];
-
-                for (int k = 0; k < j; ++k)
-                    sum -= A[(size_t)i * n + k] * A[(size_t)j * n + k];
-
-                if (i == j)
-                {
-                    if (sum <= 1.0e-12)
-                        return false;
-
-                    A[(size_t)i * n + j] = std::sqrt(sum);
-                }
-                else
-                {
-                    A[(size_t)i * n + j] = sum / A[(size_t)j * n + j];
-                }
-            }
-
-            // oberen Teil nicht nötig
-            for (int j = i + 1; j < n; ++j)
-                A[(size_t)i * n + j] = 0.0;
-        }
-
-        // Forward solve: L*y = b
-        std::vector<double> y((size_t)n, 0.0);
-        for (int i = 0; i < n; ++i)
-        {
-            double sum = b[(size_t)i];
-            for (int k = 0; k < i; ++k)
-                sum -= A[(size_t)i * n + k] * y[(size_t)k];
-
-            y[(size_t)i] = sum / A[(size_t)i * n + i];
-        }
-
-        // Backward solve: L^T*x = y  (x wird in b zurückgeschrieben)
-        for (int i = n - 1; i >= 0; --i)
-        {
-            double sum = y[(size_t)i];
-            for (int k = i + 1; k < n; ++k)
-                sum -= A[(size_t)k * n + i] * b[(size_t)k];
+ * @param eqPath Der zu zeichnende Pfad
+ * @param filledPath Geschlossener Pfad für die Füllung bis 0 dB
+ */
+void AudioPluginAudioProcessorEditor::drawEQPathWithFill(juce::Graphics& g, const juce::Path& eqPath,
+    const juce::Path& filledPath)
+{
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawEQPathWithFill");
 
-            b[(size_t)i] = sum / A[(size_t)i * n + i];
-        }
+    auto area = spectrumInnerArea.toFloat();
 
-        return true;
-    }
+    // 0 dB Referenzlinie zeichnen
+    float y0dB = juce::jmap(0.0f, -12.0f, 12.0f, area.getBottom(), area.getY());
+    g.setColour(juce::Colours::white.withAlpha(0.3f));
+    g.drawHorizontalLine((int)y0dB, area.getX(), area.getRight());
 
-    static double computeLossWithSmoothness(const std::vector<float>& freqs,
-        const std::vector<float>& targetDb,
-        const std::array<float, 31>& gainsDb,
-        const std::array<float, 31>& Qs,
-        float sampleRate,
-        const std::vector<float>& eqFreqs,
-        double lambdaSmooth,
-        double lambdaQ,
-        const std::array<float, 31>& Q0)
-    {
-        std::vector<float> respDb;
-        computeEQResponseDb(freqs, gainsDb, Qs, sampleRate, respDb, eqFreqs);
-
-        // 1) Fit error
-        double fit = 0.0;
-        for (size_t k = 0; k < freqs.size(); ++k)
-        {
-            const double e = (double)respDb[k] - (double)targetDb[k];
-            fit += e * e;
-        }
+    // EQ Kurve zeichnen
+    g.setColour(Theme::curveEQ.withAlpha(0.9f));
+    g.strokePath(eqPath, juce::PathStrokeType(3.0f));
 
-        // 2) Smoothness (2nd derivative penalty) -> reduziert "Kammfilter/Ripple"
-        double smooth = 0.0;
-        if (respDb.size() >= 3)
-        {
-            for (size_t k = 1; k + 1 < respDb.size(); ++k)
-            {
-                const double d2 = (double)respDb[k + 1] - 2.0 * (double)respDb[k] + (double)respDb[k - 1];
-                smooth += d2 * d2;
-            }
-        }
+    // Gefüllten Bereich zwischen Kurve und 0dB-Linie zeichnen
+    g.setColour(Theme::curveEQ.withAlpha(0.15f));
+    g.fillPath(filledPath);
+}
 
-        // 3) Q regularization (log-domain, damit Multiplikativänderungen sinnvoll sind)
-        double qpen = 0.0;
-        for (int i = 0; i < 31; ++i)
-        {
-            const double q = juce::jmax(0.3, (double)Qs[(size_t)i]);
-            const double q0 = juce::jmax(0.3, (double)Q0[(size_t)i]);
-            const double t = std::log(q / q0);
-            qpen += t * t;
-        }
+/**
+ * @brief Frequenzbereich der EQ-Ansicht: 20 Hz bis 20 kHz, höchstens knapp unter Nyquist.
+ */
+juce::Range<float> AudioPluginAudioProcessorEditor::getEQFrequencyRange() const
+{
+    double sr = processorRef.getSampleRate();
+    if (!(sr > 0.0)) sr = 48000.0;
 
-        return fit + lambdaSmooth * smooth + lambdaQ * qpen;
-    }
+    const float maxUsable = 0.5f * (float)sr * 0.999f;
+    return { 20.0f, juce::jmin(20000.0f, maxUsable) };
+}
 
-    static std::array<float, 31> fitQsStage2_Coordinate(const std::vector<float>& freqs,
-        const std::vector<float>& targetDb,
-        const std::array<float, 31>& gainsDbFixed,
-        std::array<float, 31> Qs,
-        float sampleRate,
-        const std::vector<float>& eqFreqs)
-    {
-        // Defaults / Gewichte: praxisnah starten
-        const double lambdaSmooth = 0.25;  // höher => glatter, weniger Ripple
-        const double lambdaQ = 0.05;  // höher => Q bleibt näher am Default
+/**
+ * @brief Bildet eine Frequenz auf die X-Position im EQ-Kurvenbereich ab.
+ *
+ * Gemeinsame Abbildung für EQ-Kurve, Zielkurve, Target-Punkte und die
+ * Drag-Trefferprüfung, damit Punkte und Kurven exakt übereinander liegen.
+ *
+ * @param freq Frequenz in Hz (wird auf den Anzeigebereich begrenzt)
+ * @return X-Position in Pixeln
+ */
+float AudioPluginAudioProcessorEditor::eqFrequencyToX(float freq) const
+{
+    const auto area = spectrumInnerArea.toFloat();
+    const auto range = getEQFrequencyRange();
+    const float f = range.clipValue(freq);
 
-        std::array<float, 31> Q0 = Qs;      // "aktueller" Ausgangspunkt als Default (oder 4.32 überall)
+    return area.getX() + juce::mapFromLog10(f, range.getStart(), range.getEnd()) * area.getWidth();
+}
 
-        // Kandidatenfaktoren (multiplikativ)
-        const float factors[] = { 0.70f, 0.85f, 1.0f, 1.18f, 1.35f };
+//==============================================================================
+//                  DRAG-TO-SHAPE (EQ-Ansicht)
+//==============================================================================
 
-        double bestLoss = computeLossWithSmoothness(freqs, targetDb, gainsDbFixed, Qs, sampleRate, eqFreqs,
-            lambdaSmooth, lambdaQ, Q0);
+/**
+ * @brief X-Position der Bandmitte im EQ-Kurvenbereich.
+ *
+ * @param band Bandindex (0-30)
+ * @return X-Position in Pixeln
+ */
+float AudioPluginAudioProcessorEditor::bandCentreX(int band) const
+{
+    return eqFrequencyToX(eqFrequencies[(size_t)band]);
+}
 
-        constexpr int iters = 4; // 3..6 reicht oft
+/**
+ * @brief Sucht das Band, dessen Mitte am nächsten an x liegt.
+ */
+int AudioPluginAudioProcessorEditor::findNearestBand(float x) const
+{
+    int best = 0;
+    float bestDist = std::numeric_limits<float>::max();
 
-        for (int iter = 0; iter < iters; ++iter)
+    for (int i = 0; i < 31; ++i)
+    {
+        const float dist = std::abs(bandCentreX(i) - x);
+        if (dist < bestDist)
         {
-            bool anyImproved = false;
+            bestDist = dist;
+            best = i;
+        }
+    }
 
-            for (int i = 0; i < 31; ++i)
-            {
-                const float qCur = Qs[(size_t)i];
+    return best;
+}
 
-                float bestQ = qCur;
-                double localBest = bestLoss;
+/**
+ * @brief Prüft, ob ein Target-Punkt unter der Mausposition liegt.
+ *
+ * @param position Mausposition im Editor
+ * @return Bandindex des Punkts oder -1
+ */
+int AudioPluginAudioProcessorEditor::findTargetPointAt(juce::Point<float> position) const
+{
+    const auto target = processorRef.getTargetCurve();
+    if (!target.isVisible())
+        return -1;
 
-                for (float fac : factors)
-                {
-                    float qTry = juce::jlimit(0.3f, 10.0f, qCur * fac);
+    const auto area = spectrumInnerArea.toFloat();
+    const float hitRadius = 8.0f;
 
-                    auto QtryArr = Qs;
-                    QtryArr[(size_t)i] = qTry;
+    const int band = findNearestBand(position.x);
+    const float db = juce::jlimit(-12.0f, 12.0f, target.shownDb()[(size_t)band]);
 
-                    const double L = computeLossWithSmoothness(freqs, targetDb, gainsDbFixed, QtryArr, sampleRate, eqFreqs,
-                        lambdaSmooth, lambdaQ, Q0);
+    const juce::Point<float> point(bandCentreX(band), juce::jmap(db, -12.0f, 12.0f, area.getBottom(), area.getY()));
 
-                    if (L < localBest)
-                    {
-                        localBest = L;
-                        bestQ = qTry;
-                    }
-                }
+    return point.getDistanceFrom(position) <= hitRadius ? band : -1;
+}
 
-                if (bestQ != qCur)
-                {
-                    Qs[(size_t)i] = bestQ;
-                    bestLoss = localBest;
-                    anyImproved = true;
-                }
-            }
+/**
+ * @brief Startet einen Drag auf Kurve oder Target-Punkt (nur EQ-Ansicht).
+ *
+ * Öffnet für alle Band-Gains eine Änderungs-Geste, damit der Host den
+ * ganzen Drag als eine Automationsbewegung aufzeichnet.
+ */
+void AudioPluginAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
+{
+    const auto position = e.position;
 
-            if (!anyImproved)
-                break;
-        }
+    if (!showEQCurve || autoEqRunning.load() || !spectrumInnerArea.toFloat().contains(position))
+        return;
 
-        return Qs;
-    }
+    updateEQResponseCache();
 
-    // Stufe 1 Fit: Gauss-Newton nur für Gains, Q fix
-    static std::array<float, 31> fitGainsStage1(const std::vector<float>& freqs,
-        const std::vector<float>& targetDb,
-        const std::array<float, 31>& Qs,
-        float sampleRate,
-        const std::vector<float>& eqFreqs,
-        const std::array<double, 31>* extraDiagPenalty = nullptr)
+    const int targetBand = findTargetPointAt(position);
+    dragEditsTarget = (targetBand >= 0);
+    dragBand = dragEditsTarget ? targetBand : findNearestBand(position.x);
 
-    {
-        std::array<float, 31> gains{};
-        gains.fill(0.0f);
+    for (int i = 0; i < 31; ++i)
+        if (auto* p = processorRef.apvts.getParameter("band" + juce::String(i)))
+            p->beginChangeGesture();
 
-        const int N = (int)freqs.size();
-        const int M = 31;
+    applyDragAt(position);
+}
 
-        std::vector<float> curDb, plusDb, minusDb;
-        std::vector<double> r((size_t)N, 0.0);
+void AudioPluginAudioProcessorEditor::mouseDrag(const juce::MouseEvent& e)
+{
+    if (dragBand >= 0)
+        applyDragAt(e.position);
+}
 
-        constexpr float deltaDb = 0.25f;     // finite difference step
-        constexpr int iters = 8;             // 6–10 ist meist genug
-        constexpr double damping = 1e-2;     // stabilisiert (Tikhonov)
+void AudioPluginAudioProcessorEditor::mouseUp(const juce::MouseEvent&)
+{
+    if (dragBand < 0)
+        return;
 
-        for (int iter = 0; iter < iters; ++iter)
-        {
-            // current response
-            computeEQResponseDb(freqs, gains, Qs, sampleRate, curDb, eqFreqs);
+    for (int i = 0; i < 31; ++i)
+        if (auto* p = processorRef.apvts.getParameter("band" + juce::String(i)))
+            p->endChangeGesture();
 
-            // residual r = target - current
-            for (int k = 0; k < N; ++k)
-                r[(size_t)k] = (double)targetDb[(size_t)k] - (double)curDb[(size_t)k];
+    dragBand = -1;
+    dragEditsTarget = false;
+}
 
-            // Normal equations: (J^T J + λI) * dg = J^T r
-            std::vector<double> AtA((size_t)M * M, 0.0);
-            std::vector<double> Atb((size_t)M, 0.0);
+/**
+ * @brief Setzt den Zielwert an der gezogenen Bandmitte und löst nach den Gains.
+ *
+ * Kurve: alle anderen Bandmitten behalten ihren aktuellen Wert (M * g),
+ * nur die gezogene folgt der Maus. Target-Punkt: der Punkt wird verschoben
+ * und der EQ folgt der gesamten Zielkurve. Die Gains kommen in beiden
+ * Fällen aus der Interaktionsmatrix (ein 31x31-Produkt pro Mausbewegung);
+ * die Anzeige aktualisiert sich über den inkrementellen EQ-Cache.
+ *
+ * @param position Mausposition im Editor
+ */
+void AudioPluginAudioProcessorEditor::applyDragAt(juce::Point<float> position)
+{
+    const auto area = spectrumInnerArea.toFloat();
+    const float desiredDb = juce::jlimit(-12.0f, 12.0f,
+        juce::jmap(position.y, area.getBottom(), area.getY(), -12.0f, 12.0f));
 
-            // Für jede Spalte i: Jacobian per finite diff
-            for (int i = 0; i < M; ++i)
-            {
-                auto gPlus = gains;
-                auto gMinus = gains;
-                gPlus[(size_t)i] = juce::jlimit(-12.0f, 12.0f, gPlus[(size_t)i] + deltaDb);
-                gMinus[(size_t)i] = juce::jlimit(-12.0f, 12.0f, gMinus[(size_t)i] - deltaDb);
-
-                computeEQResponseDb(freqs, gPlus, Qs, sampleRate, plusDb, eqFreqs);
-                computeEQResponseDb(freqs, gMinus, Qs, sampleRate, minusDb, eqFreqs);
-
-                // Ji[k] = d(curDb)/d(gain_i)
-                // Wir bauen AtA und Atb inkrementell
-                std::vector<double> Ji((size_t)N, 0.0);
-                const double denom = 1.0 / (2.0 * (double)deltaDb);
-
-                for (int k = 0; k < N; ++k)
-                    Ji[(size_t)k] = ((double)plusDb[(size_t)k] - (double)minusDb[(size_t)k]) * denom;
-
-                // Atb[i] += Σ Ji[k] * r[k]
-                double sumAtb = 0.0;
-                for (int k = 0; k < N; ++k)
-                    sumAtb += Ji[(size_t)k] * r[(size_t)k];
-                Atb[(size_t)i] = sumAtb;
-
-                // AtA[i,j] += Σ Ji[k]*Jj[k]
-                // -> wir brauchen Jj; für M=31 geht’s so:
-                for (int j = 0; j <= i; ++j)
-                {
-                    // Jj per finite diff erneut zu rechnen wäre teuer.
-                    // Trick: wir berechnen AtA "spaltenweise" nicht optimal.
-                    // Für Stufe 1 reicht aber Performance; M ist klein.
-                    // => Wir rechnen Jj ebenfalls kurz aus.
-                    auto gPlus2 = gains;
-                    auto gMinus2 = gains;
-                    gPlus2[(size_t)j] = juce::jlimit(-12.0f, 12.0f, gPlus2[(size_t)j] + deltaDb);
-                    gMinus2[(size_t)j] = juce::jlimit(-12.0f, 12.0f, gMinus2[(size_t)j] - deltaDb);
-
-                    std::vector<float> plusDb2, minusDb2;
-                    computeEQResponseDb(freqs, gPlus2, Qs, sampleRate, plusDb2, eqFreqs);
-                    computeEQResponseDb(freqs, gMinus2, Qs, sampleRate, minusDb2, eqFreqs);
-
-                    double sum = 0.0;
-                    for (int k = 0; k < N; ++k)
-                    {
-                        const double Jj = ((double)plusDb2[(size_t)k] - (double)minusDb2[(size_t)k]) * denom;
-                        sum += Ji[(size_t)k] * Jj;
-                    }
+    double sr = processorRef.getSampleRate();
+    if (!(sr > 0.0)) sr = 48000.0;
 
-                    AtA[(size_t)i * M + j] += sum;
-                    AtA[(size_t)j * M + i] += sum; // symmetrisch
-                }
-            }
+    EQInteractionMatrix::BandArray qs{}, gains{};
+    for (int i = 0; i < 31; ++i)
+    {
+        qs[(size_t)i] = eqQValues[i]->load();
+        gains[(size_t)i] = eqGainValues[i]->load();
+    }
 
-            // Damping auf Diagonale
-            for (int i = 0; i < M; ++i)
-                AtA[(size_t)i * M + i] += damping;
+    interactionMatrix.update(eqFrequencies, qs, sr);
 
-            if (extraDiagPenalty != nullptr)
-            {
-                for (int i = 0; i < M; ++i)
-                    AtA[(size_t)i * M + i] += (*extraDiagPenalty)[(size_t)i];
-            }
+    EQInteractionMatrix::BandArray target{};
 
-            // --- Gain Smoothness Regularization (verhindert Ripple/Kammfilter in der EQ-Kurve) ---
-            // Minimiert Sum (g[i] - g[i-1])^2
-            constexpr double lambdaGainSmooth = 0.35; // 0.15 .. 1.0 (höher = glatter)
+    if (dragEditsTarget)
+    {
+        processorRef.setTargetPoint(dragBand, desiredDb);
+        target = processorRef.getTargetCurve().shownDb();
+    }
+    else
+    {
+        target = interactionMatrix.responseAtCentres(gains);
+        target[(size_t)dragBand] = desiredDb;
+    }
 
-            for (int i = 0; i < M; ++i)
-            {
-                double diag = 0.0;
+    const auto solved = interactionMatrix.solveGains(target);
 
-                if (i > 0)
-                {
-                    diag += lambdaGainSmooth;
-                    AtA[(size_t)i * M + (i - 1)] -= lambdaGainSmooth;
-                    AtA[(size_t)(i - 1) * M + i] -= lambdaGainSmooth;
-                }
+    for (int i = 0; i < 31; ++i)
+    {
+        const float newGain = juce::jlimit(-12.0f, 12.0f, solved[(size_t)i]);
 
-                if (i < M - 1)
-                {
-                    diag += lambdaGainSmooth;
-                    // (i,i+1) kommt implizit über den i>0-Teil beim nächsten Index rein
-                }
+        // Kleinständerungen nicht an den Host schicken
+        if (std::abs(newGain - gains[(size_t)i]) < 0.01f)
+            continue;
 
-                AtA[(size_t)i * M + i] += diag;
-            }
+        if (auto* p = processorRef.apvts.getParameter("band" + juce::String(i)))
+            p->setValueNotifyingHost(p->convertTo0to1(newGain));
+    }
 
-            // Solve
-            auto Awork = AtA;
-            auto bwork = Atb;
+    if (dragEditsTarget)
+        repaint(spectrumInnerArea);
+}
 
-            if (!solveSPD_Cholesky(Awork, bwork, M))
-                break;
+//==============================================================================
+//                              Gains-Fit
+//==============================================================================
 
-            // Update gains
-            float maxStep = 0.0f;
-            for (int i = 0; i < M; ++i)
-            {
-                const float step = (float)bwork[(size_t)i];
-                maxStep = std::max(maxStep, std::abs(step));
+namespace
+{
+    using CurveMath::interpLogCurveDb;
+    using AutoEqSolver::computeEQResponseDb;
+    using AutoEqSolver::fitGainsStage1;
 
-                float stepF = finiteOr((float)bwork[(size_t)i], 0.0f);
+    static juce::Path buildResponsePath(
+        const juce::Rectangle<float>& area,
+        const std::vector<float>& freqs,
+        const std::vector<float>& respDb,
+        float minFreq, float maxFreq,
+        float minDb, float maxDb)
+    {
+        juce::Path p;
+        bool first = true;
 
-                // Optional: Step begrenzen (stabilisiert den Solver extrem)
-                stepF = juce::jlimit(-3.0f, 3.0f, stepF);
+        for (size_t i = 0; i < freqs.size() && i < respDb.size(); ++i)
+        {
+            const float f = freqs[i];
+            const float db = juce::jlimit(minDb, maxDb, respDb[i]);
 
-                const float newG = gains[(size_t)i] + stepF;
-                gains[(size_t)i] = finiteClamp(newG, -12.0f, 12.0f, 0.0f);
-            }
+            const float x = area.getX() + juce::mapFromLog10(f, minFreq, maxFreq) * area.getWidth();
+            const float y = juce::jmap(db, minDb, maxDb, area.getBottom(), area.getY());
 
-            // Abbruch wenn kaum Änderung
-            if (maxStep < 0.02f)
-                break;
+            if (first) { p.startNewSubPath(x, y); first = false; }
+            else { p.lineTo(x, y); }
         }
-
-        return gains;
+        return p;
     }
 }
 
@@ -2842,7 +2673,7 @@ void AudioPluginAudioProcessorEditor::startAutoEqAsync()
 
     std::array<float, 31> qCopy{};
     for (int i = 0; i < 31; ++i)
-        qCopy[(size_t)i] = (float)eqKnob[i].getValue(); // nur JETZT lesen (Message Thread)
+        qCopy[(size_t)i] = eqQValues[i]->load(); // nur JETZT lesen (Message Thread)
 
     std::array<float, 31> eqFreqCopy{};
     for (int i = 0; i < 31; ++i)
@@ -2859,355 +2690,66 @@ void AudioPluginAudioProcessorEditor::startAutoEqAsync()
     // SafePointer: falls Editor geschlossen wird während der Berechnung
     juce::Component::SafePointer<AudioPluginAudioProcessorEditor> safeThis(this);
 
-    struct Job : public juce::ThreadPoolJob
+    struct Job
     {
         Job(juce::Component::SafePointer<AudioPluginAudioProcessorEditor> s,
-            AudioPluginAudioProcessor& p,
+            int traceIdToUse,
             std::vector<AudioPluginAudioProcessor::SpectrumPoint> spec,
             std::vector<AudioPluginAudioProcessor::ReferenceBand> ref,
             std::array<float, 31> q,
             std::array<float, 31> eqF,
             float sampleRate,
             float inputGainBefore)
-            : juce::ThreadPoolJob("AutoEqJob"),
-            safeEditor(s), processor(p),
+            : safeEditor(s), traceId(traceIdToUse),
             spectrum(std::move(spec)), reference(std::move(ref)),
             qFixed(q), eqFreqs(eqF), sr(sampleRate), inputGainBeforeDb(inputGainBefore) {
         }
 
-        static float computeOffsetFromCopies(
-            const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum,
-            const std::vector<AudioPluginAudioProcessor::ReferenceBand>& reference,
-            const std::array<float, 31>& eqFreqs)
-        {
-            if (spectrum.empty() || reference.empty())
-                return 0.0f;
-
-            std::vector<float> diffs;
-            diffs.reserve(31);
-
-            const float fMin = 50.0f;
-            const float fMax = 10000.0f;
-
-            for (int i = 0; i < 31; ++i)
-            {
-                const float f = eqFreqs[(size_t)i];
-                if (f < fMin || f > fMax) continue;
-
-                const float ref = sampleLogInterpolatedReferenceMedian(reference, f, DisplayScale::minDb);
-                const float meas = sampleLogInterpolatedSpectrum(spectrum, f, DisplayScale::minDb);
-                diffs.push_back(ref - meas);
-            }
-
-            if (diffs.empty())
-                return 0.0f;
-
-            std::nth_element(diffs.begin(), diffs.begin() + diffs.size() / 2, diffs.end());
-            const float median = diffs[diffs.size() / 2];
-            return juce::jlimit(-36.0f, 36.0f, median);
-        }
-
-        static std::vector<float> generateLogFrequenciesLocal(int numPoints, float minFreq, float maxFreq)
+        void operator()(const JobSystem::JobHandle& handle) const
         {
-            std::vector<float> out;
-            out.reserve((size_t)numPoints);
-
-            const float logMin = std::log10(minFreq);
-            const float logMax = std::log10(maxFreq);
-
-            for (int i = 0; i < numPoints; ++i)
-            {
-                const float t = (numPoints <= 1) ? 0.0f : (float)i / (float)(numPoints - 1);
-                const float lf = logMin + (logMax - logMin) * t;
-                out.push_back(std::pow(10.0f, lf));
-            }
-            return out;
-        }
+            if (safeEditor == nullptr || handle.isCancelled())
+                return;
 
-        JobStatus runJob() override
-        {
-            if (safeEditor == nullptr)
-                return jobHasFinished;
+            const TraceRecorder::Scope traceScope("AutoEqJob", "autoEq", traceId);
+            const double solveStartMs = juce::Time::getMillisecondCounterHiRes();
 
             // --- HEAVY COMPUTE (kein GUI!) ---
-            const float offsetDb = computeOffsetFromCopies(spectrum, reference, eqFreqs);
-
-            // Residuals (31)
-            std::vector<float> residuals;
-            residuals.reserve(31);
-
-            for (int i = 0; i < 31; ++i)
-            {
-                const float f = eqFreqs[(size_t)i];
-
-                const float refLevel = sampleLogInterpolatedReferenceMedian(reference, f, DisplayScale::minDb);
-                float measLevel = sampleLogInterpolatedSpectrum(spectrum, f, DisplayScale::minDb);
-
-                const float gateDb = DisplayScale::minDb + 10.0f;
-                if (measLevel < gateDb) measLevel = gateDb;
-
-                measLevel += offsetDb;
-
-                auto bassWeight = [](float f)
-                    {
-                        if (f < 40.0f) return 0.20f;
-                        if (f < 80.0f) return 0.35f;
-                        if (f < 120.0f) return 0.55f;
-                        return 1.0f;
-                    };
-
-                auto bandMaxCorr = [](float f)
-                    {
-                        if (f < 60.0f)  return 4.0f;   // ganz unten nie “wild” korrigieren
-                        if (f < 120.0f) return 6.0f;
-                        return 12.0f;
-                    };
-
-                float r = (refLevel - measLevel) * edgeWeight(f) * bassWeight(f);
-                r = juce::jlimit(-bandMaxCorr(f), bandMaxCorr(f), r);
-                residuals.push_back(r);
-            }
-
-            // smoothing + amount
-            residuals = smoothMovingAverage(residuals, 5, 1);
-            for (auto& r : residuals)
-                r *= 1.0f; // kAutoEqAmount
-
-            std::array<float, 31> residualsArr{};
-            for (int i = 0; i < 31; ++i)
-                residualsArr[(size_t)i] = juce::jlimit(-12.0f, 12.0f, residuals[(size_t)i]);
-
-            // ==============================
-            // Hybrid Bass Mode (Peak+Dip breitbandig)
-            // ==============================
-            bool hybridBass = false;
-            int idxMax = -1;
-            int idxMin = -1;
-
-            std::array<double, 31> extraPenalty{};
-            extraPenalty.fill(0.0);
-
-            auto isBass = [&](float f)
-                {
-                    return (f >= 40.0f && f <= 400.0f);
-                };
-
-            // 1) Bass-Schwankung messen (Peak-to-Peak)
-            float bassMax = -1.0e9f;
-            float bassMin = 1.0e9f;
-
-            for (int i = 0; i < 31; ++i)
-            {
-                const float f = eqFreqs[(size_t)i];
-                if (!isBass(f)) continue;
-
-                bassMax = std::max(bassMax, residuals[(size_t)i]);
-                bassMin = std::min(bassMin, residuals[(size_t)i]);
-            }
-
-            const float bassP2P = bassMax - bassMin;
-
-            // Schwelle: ab hier "große" Schwankung -> Hybrid-Modus
-            // (Tipp: 5..8 dB je nach Material)
-            if (bassP2P > 6.0f)
-            {
-                hybridBass = true;
-
-                // 2) stärkstes Maximum + Minimum finden
-                float bestPos = -1.0e9f;
-                float bestNeg = 1.0e9f;
-
-                for (int i = 0; i < 31; ++i)
-                {
-                    const float f = eqFreqs[(size_t)i];
-                    if (!isBass(f)) continue;
-
-                    const float r = residuals[(size_t)i];
-
-                    if (r > bestPos) { bestPos = r; idxMax = i; }
-                    if (r < bestNeg) { bestNeg = r; idxMin = i; }
-                }
-
-                // 3) coarse bass target aus 2 breiten Gaussians bauen
-                std::vector<float> coarse = residuals;
-
-                // Bassbereich "leer machen"
-                for (int i = 0; i < 31; ++i)
-                    if (isBass(eqFreqs[(size_t)i]))
-                        coarse[(size_t)i] = 0.0f;
-
-                const float sigmaOct = 0.55f; // Breite in Oktaven (größer = breiter)
-
-                auto g = [&](float f, float fc)
-                    {
-                        const float x = std::log2(f);
-                        const float xc = std::log2(fc);
-                        const float d = (x - xc) / sigmaOct;
-                        return std::exp(-0.5f * d * d);
-                    };
-
-                if (idxMax >= 0)
-                {
-                    const float fc = eqFreqs[(size_t)idxMax];
-                    const float A = residuals[(size_t)idxMax];
-                    for (int i = 0; i < 31; ++i)
-                    {
-                        const float f = eqFreqs[(size_t)i];
-                        if (!isBass(f)) continue;
-                        coarse[(size_t)i] += A * g(f, fc);
-                    }
-                }
-
-                if (idxMin >= 0)
-                {
-                    const float fc = eqFreqs[(size_t)idxMin];
-                    const float A = residuals[(size_t)idxMin];
-                    for (int i = 0; i < 31; ++i)
-                    {
-                        const float f = eqFreqs[(size_t)i];
-                        if (!isBass(f)) continue;
-                        coarse[(size_t)i] += A * g(f, fc);
-                    }
-                }
-
-                // 4) Bass-Residuals ersetzen (Mix, damit’s nicht "zu hart" wird)
-                const float mix = 0.85f; // 0.7..0.95
-                for (int i = 0; i < 31; ++i)
-                {
-                    const float f = eqFreqs[(size_t)i];
-                    if (!isBass(f)) continue;
-
-                    residuals[(size_t)i] = (1.0f - mix) * residuals[(size_t)i] + mix * coarse[(size_t)i];
-                }
-
-                // 5) Solver zwingen: nur die 2 Extrem-Bänder im Bass sollen "frei" sein
-                // Alle anderen Bass-Bänder bekommen Zusatz-Penalty -> bleiben näher an 0 dB Gain.
-                for (int i = 0; i < 31; ++i)
-                {
-                    const float f = eqFreqs[(size_t)i];
-                    if (!isBass(f)) continue;
-
-                    if (i == idxMax || i == idxMin)
-                        extraPenalty[(size_t)i] = 0.05;  // fast frei
-                    else
-                        extraPenalty[(size_t)i] = 2.5;   // stärker "zu 0 drücken" (1.0..6.0)
-                }
-            }
-
-            // Fit (etwas kleiner -> weniger Freeze/CPU)
-            const int fitPoints = 350; // 250..400 ist sehr praxisnah
-            auto fitFreqs = generateLogFrequenciesLocal(fitPoints, 20.0f, 20000.0f);
-
-            std::vector<float> bandFreqs;
-            bandFreqs.reserve(31);
-            for (int i = 0; i < 31; ++i)
-                bandFreqs.push_back(eqFreqs[(size_t)i]);
-
-            std::vector<float> targetDb;
-            targetDb.reserve(fitFreqs.size());
-            for (auto f : fitFreqs)
-                targetDb.push_back(interpLogCurveDb(bandFreqs, residuals, f));
-
-            // Stufe 1: Gains fitten (Q fix)
-            const std::array<double, 31>* penaltyPtr = hybridBass ? &extraPenalty : nullptr;
-
-            std::array<float, 31> gainsStage1 = fitGainsStage1(fitFreqs, targetDb, qFixed, sr, bandFreqs, penaltyPtr);
-
-            // Stufe 2: Qs optimieren (gegen Ripple)
-            std::array<float, 31> qStage2 = fitQsStage2_Coordinate(fitFreqs, targetDb, gainsStage1, qFixed, sr, bandFreqs);
-
-            if (hybridBass)
-            {
-                // Nur die 2 aktiven Bassbänder wirklich breit (kleines Q)
-                if (idxMax >= 0) qStage2[(size_t)idxMax] = juce::jlimit(0.6f, 1.4f, qStage2[(size_t)idxMax]);
-                if (idxMin >= 0) qStage2[(size_t)idxMin] = juce::jlimit(0.6f, 1.4f, qStage2[(size_t)idxMin]);
-
-                // Restliche Bassbänder notfalls auch nicht zu schmal werden lassen
-                for (int i = 0; i < 31; ++i)
-                    if (eqFreqs[(size_t)i] >= 40.0f && eqFreqs[(size_t)i] <= 400.0f)
-                        qStage2[(size_t)i] = juce::jmin(qStage2[(size_t)i], 2.0f);
-            }
-
-            // Q hard limits (Basis)
-            for (auto& q : qStage2)
-                q = juce::jlimit(0.6f, 6.0f, q);
-
-            // Danach: Gains nochmal fitten mit neuen Qs
-            std::array<float, 31> finalGains = fitGainsStage1(fitFreqs, targetDb, qStage2, sr, bandFreqs, penaltyPtr);
-
-            // Optional: Q abhängig von Gain begrenzen
-            for (int i = 0; i < 31; ++i)
-            {
-                const float gAbs = std::abs(finalGains[(size_t)i]);
-                float q = qStage2[(size_t)i];
-
-                const float qMax = (gAbs > 8.0f) ? 1.4f
-                    : (gAbs > 5.0f) ? 2.2f
-                    : 4.0f;
-
-                qStage2[(size_t)i] = juce::jlimit(0.6f, qMax, q);
-            }
-
-            // WICHTIG: Nach Q-Begrenzung Gains nochmal refitten, sonst passt’s nicht mehr!
-            finalGains = fitGainsStage1(fitFreqs, targetDb, qStage2, sr, bandFreqs, penaltyPtr);
-
-            // === Makeup Gain so berechnen, dass (Meas + offset + EQResponse) wieder zur Referenz passt ===
-            // 1) EQ-Response in dB auf fitFreqs berechnen
-            std::vector<float> respDb;
-            computeEQResponseDb(fitFreqs, finalGains, qStage2, sr, respDb, bandFreqs);
-
-            // 2) Median-Differenz im stabilen Bereich bilden
-            std::vector<float> diffs;
-            diffs.reserve(fitFreqs.size());
-
-            for (size_t k = 0; k < fitFreqs.size(); ++k)
-            {
-                const float f = fitFreqs[k];
-                if (f < 50.0f || f > 10000.0f) // ggf. 60..10k wenn du Bass noch mehr rausnehmen willst
-                    continue;
-
-                const float ref = sampleLogInterpolatedReferenceMedian(reference, f, DisplayScale::minDb);
-                float meas = sampleLogInterpolatedSpectrum(spectrum, f, DisplayScale::minDb);
-
-                // Gate wie bei Residuals (verhindert "Noise floor" Einfluss)
-                const float gateDb = DisplayScale::minDb + 10.0f;
-                if (meas < gateDb) meas = gateDb;
-
-                const float predictedPost = meas + offsetDb + respDb[k];
-                diffs.push_back(ref - predictedPost);
-            }
-
-            float makeupDeltaDb = 0.0f;
-            if (!diffs.empty())
-            {
-                std::nth_element(diffs.begin(), diffs.begin() + diffs.size() / 2, diffs.end());
-                makeupDeltaDb = diffs[diffs.size() / 2];
-            }
-
-            makeupDeltaDb = juce::jlimit(-12.0f, 12.0f, makeupDeltaDb);
+            const auto result = AutoEqSolver::solve(spectrum, reference, qFixed, eqFreqs, sr,
+                [handle] { return handle.isCancelled(); });
 
             const float inputGainBefore = inputGainBeforeDb;
+            const double solveMs = juce::Time::getMillisecondCounterHiRes() - solveStartMs;
 
+            if (handle.isCancelled())
+                return;
 
             juce::MessageManager::callAsync([safe = safeEditor,
-                finalGains,
-                finalQs = qStage2,
-                residualsArr,
-                makeupDeltaDb,
-                inputGainBefore]() mutable
+                finalGains = result.gainsDb,
+                finalQs = result.qs,
+                residualsArr = result.residualsDb,
+                makeupDeltaDb = result.makeupDb,
+                inputGainBefore,
+                solveMs]() mutable
                 {
                     if (safe == nullptr)
                         return;
 
+                    // Laufzeit erst hier eintragen: der Processor lebt mindestens so lange wie der Editor
+                    safe->processorRef.getPerformanceCounters().recordAutoEqSolve(solveMs);
+
                     // 1) Zielkurve (31 Punkte) speichern -> gestrichelt zeichnen (ohne Kammfilter!)
-                    safe->processorRef.targetResidualsDb = residualsArr;
-                    safe->processorRef.hasTargetResiduals = true;
+                    safe->processorRef.setTargetResiduals(residualsArr);
 
                     // 2) Dein bisheriges: fitted Gains speichern (falls du das weiter nutzt)
+                    std::array<float, 31> corrections{};
                     for (int i = 0; i < 31; ++i)
-                        safe->processorRef.targetCorrections[i] = juce::jlimit(-12.0f, 12.0f, finalGains[(size_t)i]);
+                        corrections[(size_t)i] = juce::jlimit(-12.0f, 12.0f, finalGains[(size_t)i]);
 
-                    safe->processorRef.hasTargetCorrections = true;
+                    safe->processorRef.setTargetCorrections(corrections);
+
+                    // Vorher/Nachher als A/B ablegen (Vergleich ohne erneutes Lösen);
+                    // eigene Snapshots dort werden nur nach Rückfrage ersetzt
+                    safe->storeAutoEqSnapshots(finalGains, finalQs);
 
                     // Qs/Gains/InputGain anwenden ...
                     applyQsToApvts(safe->processorRef, finalQs);
@@ -3221,16 +2763,16 @@ void AudioPluginAudioProcessorEditor::startAutoEqAsync()
                     safe->loadReferenceButton.setEnabled(true);
                     safe->resetButton.setEnabled(true);
                     safe->eqCurveToggleButton.setEnabled(true);
+                    safe->updateSnapshotButtons();
 
                     safe->repaint();
                     safe->autoEqRunning.store(false);
                 });
-
-            return jobHasFinished;
         }
 
+        // Kein Processor-Zugriff im Job: er kann den Editor überleben
         juce::Component::SafePointer<AudioPluginAudioProcessorEditor> safeEditor;
-        AudioPluginAudioProcessor& processor;
+        int traceId = -1;
 
         std::vector<AudioPluginAudioProcessor::SpectrumPoint> spectrum;
         std::vector<AudioPluginAudioProcessor::ReferenceBand> reference;
@@ -3241,15 +2783,16 @@ void AudioPluginAudioProcessorEditor::startAutoEqAsync()
         float inputGainBeforeDb = 0.0f;
     };
 
-    autoEqPool.addJob(new Job(safeThis,
-        processorRef,
+    // Hohe Priorität: der Nutzer wartet auf das Ergebnis
+    autoEqJob = getJobSystem().submit(Job(safeThis,
+        processorRef.getTraceId(),
         averagedSpectrumCopy,
         referenceBandsCopy,
         qCopy,
         eqFreqCopy,
         sr,
         inputGainBeforeDb),
-        true);
+        JobSystem::Priority::high);
 }
 
 //==============================================================================
@@ -3328,7 +2871,7 @@ void AudioPluginAudioProcessorEditor::applyAutoEQ()
     // 2) Q fest lassen (aktueller Knob-Stand)
     std::array<float, 31> fixedQs;
     for (int i = 0; i < 31; ++i)
-        fixedQs[(size_t)i] = (float)eqKnob[i].getValue();
+        fixedQs[(size_t)i] = eqQValues[i]->load();
 
     // 3) SampleRate
     float sr = (float)processorRef.getSampleRate();
@@ -3337,15 +2880,16 @@ void AudioPluginAudioProcessorEditor::applyAutoEQ()
     // 4) Fit berechnen: gives recommended slider gains
     std::array<float, 31> fittedGains = fitGainsStage1(fitFreqs, targetDb, fixedQs, sr, bandFreqs);
 
-    // 5) Ergebnis in targetCorrections speichern (das sind jetzt "Slider-Gains", nicht nur Residual-Punkte)
+    // 5) Ergebnis als Zielkorrekturen speichern (das sind jetzt "Slider-Gains", nicht nur Residual-Punkte)
+    std::array<float, 31> corrections{};
     for (int i = 0; i < 31; ++i)
     {
         const float g = fittedGains[(size_t)i];
-        processorRef.targetCorrections[i] = finiteClamp(g, -12.0f, 12.0f, 0.0f);
+        corrections[(size_t)i] = finiteClamp(g, -12.0f, 12.0f, 0.0f);
     }
 
-    // Flag erst setzen, wenn die Daten sicher sind
-    processorRef.hasTargetCorrections = true;
+    // Kurve und Flag gemeinsam übergeben
+    processorRef.setTargetCorrections(corrections);
 
 
     DBG("=== Auto-EQ Stufe 1 (Gains-Fit) abgeschlossen ===");
@@ -3480,18 +3024,20 @@ void AudioPluginAudioProcessorEditor::applyCorrections(
 {
     DBG("=== EQ-Band Korrekturen (nur Visualisierung) ===");
 
+    std::array<float, 31> corrections{};
     for (int i = 0; i < 31; ++i)
     {
         float correction = residuals[i];
 
         correction = juce::jlimit(-kAutoEqMaxCorr, kAutoEqMaxCorr, correction);
 
-        processorRef.targetCorrections[i] = correction;
+        corrections[(size_t)i] = correction;
 
         DBG("Band " + juce::String(i) + " (" + juce::String(eqFrequencies[i]) + " Hz): "
             + juce::String(correction, 2) + " dB");
     }
 
+    processorRef.setTargetCorrections(corrections);
 }
 
 //==============================================================================
@@ -3549,6 +3095,8 @@ float AudioPluginAudioProcessorEditor::findMeasuredLevel(
  */
 void AudioPluginAudioProcessorEditor::drawTargetEQCurve(juce::Graphics& g)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawTargetEQCurve");
+
     const auto targetPath = buildTargetPath();
     if (targetPath.isEmpty())
         return;
@@ -3570,33 +3118,21 @@ juce::Path AudioPluginAudioProcessorEditor::buildTargetPath()
 {
     juce::Path path;
 
-    const bool useResiduals = processorRef.hasTargetResiduals;
-    const bool useCorrections = processorRef.hasTargetCorrections.load(std::memory_order_acquire);
+    const auto target = processorRef.getTargetCurve();
 
-    if (!useResiduals && !useCorrections)
+    if (!target.isVisible())
         return path;
 
     auto area = spectrumInnerArea.toFloat();
 
-    const float minFreq = 20.0f;
-    float sr = (float)processorRef.getSampleRate();
-    if (!(sr > 0.0f)) sr = 48000.0f;
-    const float maxFreq = juce::jmin(20000.0f, 0.5f * sr * 0.999f);
-
     const float minDb = -12.0f, maxDb = 12.0f;
 
     bool first = true;
     for (int i = 0; i < 31; ++i)
     {
-        const float f = juce::jlimit(minFreq, maxFreq, eqFrequencies[i]);
-
-        float db = 0.0f;
-        if (useResiduals)
-            db = finiteClamp(processorRef.targetResidualsDb[(size_t)i], minDb, maxDb, 0.0f);
-        else
-            db = finiteClamp(processorRef.targetCorrections[i], minDb, maxDb, 0.0f);
+        const float db = finiteClamp(target.shownDb()[(size_t)i], minDb, maxDb, 0.0f);
 
-        const float x = area.getX() + juce::mapFromLog10(f, minFreq, maxFreq) * area.getWidth();
+        const float x = bandCentreX(i);
         const float y = juce::jmap(db, minDb, maxDb, area.getBottom(), area.getY());
 
         if (first) { path.startNewSubPath(x, y); first = false; }
@@ -3616,6 +3152,8 @@ juce::Path AudioPluginAudioProcessorEditor::buildTargetPath()
 void AudioPluginAudioProcessorEditor::drawDashedTargetCurve(
     juce::Graphics& g, const juce::Path& targetPath)
 {
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawDashedTargetCurve");
+
     // Gestrichelten Pfad erstellen
     juce::Path dashedPath;
     float dashLengths[] = { 6.0f, 4.0f };  // 6px Linie, 4px Lücke
@@ -3634,18 +3172,14 @@ void AudioPluginAudioProcessorEditor::drawDashedTargetCurve(
  */
 void AudioPluginAudioProcessorEditor::drawTargetPoints(juce::Graphics& g)
 {
-    const bool useResiduals = processorRef.hasTargetResiduals;
-    const bool useCorrections = processorRef.hasTargetCorrections.load(std::memory_order_acquire);
-    if (!useResiduals && !useCorrections)
+    const PaintProfiler::Scope profileScope(paintProfiler, "drawTargetPoints");
+
+    const auto target = processorRef.getTargetCurve();
+    if (!target.isVisible())
         return;
 
     auto area = spectrumInnerArea.toFloat();
 
-    const float minFreq = 20.0f;
-    float sr = (float)processorRef.getSampleRate();
-    if (!(sr > 0.0f)) sr = 48000.0f;
-    const float maxFreq = juce::jmin(20000.0f, 0.5f * sr * 0.999f);
-
     const float minDb = -12.0f;
     const float maxDb = 12.0f;
 
@@ -3653,17 +3187,9 @@ void AudioPluginAudioProcessorEditor::drawTargetPoints(juce::Graphics& g)
 
     for (int i = 0; i < 31; ++i)
     {
-        const float f = juce::jlimit(minFreq, maxFreq, (float)eqFrequencies[i]);
-
-        float db = 0.0f;
-        if (useResiduals)
-            db = processorRef.targetResidualsDb[(size_t)i];
-        else
-            db = processorRef.targetCorrections[(size_t)i];
-
-        db = juce::jlimit(minDb, maxDb, db);
+        const float db = juce::jlimit(minDb, maxDb, target.shownDb()[(size_t)i]);
 
-        const float x = area.getX() + juce::mapFromLog10(f, minFreq, maxFreq) * area.getWidth();
+        const float x = bandCentreX(i);
         const float y = juce::jmap(db, minDb, maxDb, area.getBottom(), area.getY());
 
         g.fillEllipse(x - 3.0f, y - 3.0f, 6.0f, 6.0f);
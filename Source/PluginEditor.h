@@ -3,7 +3,14 @@
 #pragma once
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "EQResponseCache.h"
+#include "PerformanceHud.h"
+#include "FaderLookAndFeel.h"
+#include "EQInteractionMatrix.h"
+#include "PaintProfiler.h"
+#include "JobSystem.h"
 #include <atomic>
+#include <optional>
 
 //==============================================================================
 class AudioPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
@@ -17,6 +24,17 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 
+    // Drag-to-shape in der EQ-Ansicht
+    void mouseDown(const juce::MouseEvent& e) override;
+    void mouseDrag(const juce::MouseEvent& e) override;
+    void mouseUp(const juce::MouseEvent& e) override;
+
+    //==============================================================================
+    // Headless-Rendering (GUI-Benchmark): ohne Fenster und VBlank steuerbar
+    void setEQCurveView(bool shouldShowEQCurve);
+    void invalidateStaticLayers();
+    bool pullDisplayData();  // Analyzer/EQ-Cache wie im VBlank nachziehen, true = neuer Frame
+    void setPaintProfiler(PaintProfiler* profilerToUse) noexcept { paintProfiler = profilerToUse; }
 
 private:
     // Setup-Funktionen (aus Konstruktor ausgelagert)
@@ -26,6 +44,9 @@ private:
     void setupLoadReferenceButton();
     void setupResetButton();
     void setupEQCurveToggle();
+    void setupAdaptiveToggle();
+    void setupPerformanceHud();
+    void setupSnapshotControls();
     void setupEQSliders();
     void setupQKnobs();
     void setupInputGainSlider();
@@ -38,8 +59,12 @@ private:
     void drawTopBar(juce::Graphics& g);
     void drawBackground(juce::Graphics& g);
     void drawSpectrumArea(juce::Graphics& g);
+    void drawSpectrumBackground(juce::Graphics& g);
+    void drawSpectrumFrameLines(juce::Graphics& g);
     void drawReferenceBands(juce::Graphics& g, float minFreq, float maxFreq,
         float displayMinDb, float displayMaxDb);
+    void rebuildReferencePaths(float minFreq, float maxFreq,
+        float displayMinDb, float displayMaxDb);
     void drawFrequencyGrid(juce::Graphics& g);
     void drawEQAreas(juce::Graphics& g);
     void drawEQLabels(juce::Graphics& g);
@@ -100,21 +125,19 @@ private:
     // drawEQCurve Hilfsfunktionen
     std::vector<float> generateLogFrequencies(int numPoints, float minFreq, float maxFreq);
 
-    std::vector<float> calculateTotalMagnitude(
-        const std::vector<float>& frequencies, int numPoints);
+    bool updateEQResponseCache();
+    void rebuildEQPathIfNeeded();
 
-    juce::Path buildEQPath(
-        const std::vector<float>& frequencies,
-        const std::vector<float>& magnitudeDB,
-        int numPoints, float minFreq, float maxFreq);
-
-    void drawEQPathWithFill(juce::Graphics& g, const juce::Path& eqPath);
+    void drawEQPathWithFill(juce::Graphics& g, const juce::Path& eqPath, const juce::Path& filledPath);
 
     // drawFrame Hilfsfunktionen
     void initializeSmoothedLevels(
         const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum);
 
-    std::vector<juce::Point<float>> calculateSpectrumPoints(
+    void updateSpectrumColumns(
+        const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum);
+
+    void calculateSpectrumPoints(
         const std::vector<AudioPluginAudioProcessor::SpectrumPoint>& spectrum);
 
     void applySpatialSmoothingToPoints(std::vector<juce::Point<float>>& points);
@@ -127,9 +150,20 @@ private:
         juce::Graphics& g,
         const std::vector<juce::Point<float>>& points);
 
-    // Timer callback for GUI updates
+    // Timer nur whrend der Messung (Pre-EQ Snapshots, auch bei verstecktem Fenster)
     void timerCallback() override;
 
+    // Anzeige-Updates im Takt des Bildschirms (VBlank)
+    void onVBlank(double timestampSec);
+    juce::VBlankAttachment vBlankAttachment;
+    double lastFrameTimestampSec = 0.0;
+    double lastPaintDurationMs = 0.0;     // Kosten des letzten paint() fr das Frame-Budget
+    PaintProfiler* paintProfiler = nullptr; // nur im GUI-Benchmark gesetzt
+
+    // Nach setStateInformation() (Undo, Preset, Session) UI an den Processor angleichen
+    void syncWithProcessorState();
+    juce::uint32 processorStateVersion = 0;
+
     void startAutoEqAsync(); // Auto-EQ im Background starten
 
     // Auto-EQ Funktion
@@ -175,13 +209,17 @@ private:
     // Async FileChooser am Leben halten
     std::unique_ptr<juce::FileChooser> referenceFileChooser;
 
-    // Background-Job Pool (1 Thread reicht)
-    juce::ThreadPool referenceAnalysisPool{ 1 };
+    // Gemeinsamer Scheduler aller Instanzen, erst beim ersten Job geholt,
+    // damit das ffnen des Editors keine Threads startet
+    std::optional<juce::SharedResourcePointer<JobSystem>> jobSystem;
+    JobSystem& getJobSystem();
+
+    JobSystem::JobHandle referenceAnalysisJob;
 
     // UI-Status
     bool referenceAnalysisRunning = false;
 
-    juce::ThreadPool autoEqPool{ 1 };              // 1 Thread reicht
+    JobSystem::JobHandle autoEqJob;
     std::atomic<bool> autoEqRunning{ false };      // verhindert Doppelstarts
 
     // Button fr Reset
@@ -217,8 +255,16 @@ private:
         -20.0f, 0.0f, 20.0f, 40.0f, 60.0f, 80.0f
     };
 
-    // Hintergrundbild: Spektogramm
-    juce::Image background;
+    // Gecachte statische Ebenen (in Gertepixeln, neu gerendert bei resized()/Ansichtswechsel)
+    juce::Image staticBackgroundLayer;  // Flchen, Skalen, Beschriftungen (unter den Kurven)
+    juce::Image staticOverlayLayer;     // Frequenzraster + Rahmen (ber den Kurven, nur spectrogramArea)
+    bool staticLayersDirty = true;
+    float staticLayerScale = 1.0f;
+
+    void renderStaticLayers();
+
+    // Schlankes Zeichnen fr Fader/Knobs (muss lnger leben als die Slider)
+    FaderLookAndFeel faderLookAndFeel;
 
     // EQ Bereich einfgen
     juce::Rectangle<int> eqArea;
@@ -229,7 +275,7 @@ private:
 
     // Q-Bereich
     juce::Rectangle<int> eqKnobArea;
-    juce::Slider eqKnob[31];
+    std::unique_ptr<juce::Slider> eqKnob[31];     // verzgert erzeugt (nach dem ffnen)
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqQAttachments[31];
 
     // EQ Beschriftungsbereich
@@ -237,23 +283,91 @@ private:
 
     bool showEQCurve = false;
     juce::TextButton eqCurveToggleButton;
+
+    // Adaptiver Referenz-Tracking-Modus (Parameter "adaptiveMode")
+    juce::TextButton adaptiveToggleButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> adaptiveAttachment;
+
+    // Performance-HUD (Overlay ber dem Spektrum)
+    juce::TextButton hudToggleButton;
+    PerformanceHud performanceHud;
+
+    // EQ-Snapshots A/B (Processor-Slots 0 und 1) mit Morph-Regler
+    // Klick: vergleichen bzw. zurck zu live, leerer Slot/Shift: speichern, Alt: bernehmen
+    juce::TextButton snapshotAButton;
+    juce::TextButton snapshotBButton;
+    juce::Slider snapshotMorphKnob;
+    void onSnapshotButton(int slot);
+    int getActiveSnapshotSlot() const;
+    void updateSnapshotButtons();
+    void storeAutoEqSnapshots(const std::array<float, 31>& afterGains, const std::array<float, 31>& afterQs);
+    bool snapshotsFromAutoEq = false;   // A/B stammen vom letzten Auto-EQ (ohne Rckfrage ersetzbar)
     float eqDisplayOffsetDb = 0.0f;
 
     // in class AudioPluginAudioProcessorEditor
     float averagedSpectrumDb = DisplayScale::minDb;
 
     // Bei den Funktionen hinzufgen:
-    std::complex<float> peakingEQComplex(float freq, float f0, float Q, float gainDb, float sampleRate);
     void drawEQCurve(juce::Graphics& g);
 
+    // Gecachter EQ-Frequenzgang (nur bei Parameternderung neu berechnet)
+    EQResponseCache eqResponse;
+    std::array<std::atomic<float>*, 31> eqGainValues{};
+    std::array<std::atomic<float>*, 31> eqQValues{};
+
+    // Pfad nur neu bauen wenn sich Version oder Zeichenbereich ndern
+    juce::Path eqCurvePath;
+    juce::Path eqCurveFillPath;
+
+    // Drag-to-shape: gezogenes Band, Ziel = Kurve oder Target-Punkt
+    EQInteractionMatrix interactionMatrix;
+    int dragBand = -1;
+    bool dragEditsTarget = false;
+
+    juce::Range<float> getEQFrequencyRange() const;
+    float eqFrequencyToX(float freq) const;
+    float bandCentreX(int band) const;
+    int findNearestBand(float x) const;
+    int findTargetPointAt(juce::Point<float> position) const;
+    void applyDragAt(juce::Point<float> position);
+    juce::uint32 eqCurvePathVersion = 0;
+    juce::Rectangle<int> eqCurvePathArea;
+
     // Fr Spektrum Smoothing (Ableton Standard)
     std::vector<float> smoothedLevels;
     static constexpr float smoothingFactor = 0.95f;
 
-    // Rumliches Smoothing fr glatteres Spektrum
-    std::vector<float> applySpatialSmoothing(const std::vector<float>& levels, int windowSize = 3);
+    // Rumliches Smoothing fr glatteres Spektrum (schreibt in smoothed, keine Allokation)
+    void applySpatialSmoothing(const std::vector<float>& levels, std::vector<float>& smoothed, int windowSize = 3);
 
-    // Layout Konstanten
+    // Wiederverwendete Puffer fr das Spektrum (keine Heap-Allokation pro Frame)
+    struct SpectrumColumn
+    {
+        size_t index;   // Index im Spektrum-Array
+        float x;        // vorberechnete X-Position
+    };
+
+    std::vector<SpectrumColumn> spectrumColumns;        // neu nur bei Resize / anderer Bandanzahl
+    juce::Rectangle<int> spectrumColumnsArea;
+    size_t spectrumColumnsSourceSize = 0;
+
+    std::vector<juce::Point<float>> spectrumPoints;
+    std::vector<float> spectrumYScratch;
+    std::vector<float> spectrumYSmoothed;
+    juce::Path spectrumPath;
+
+    // Referenzbnder in normierten Koordinaten (x: 0..1, y: dB), nur bei neuer
+    // Referenz gebaut und per AffineTransform in den Zeichenbereich abgebildet
+    juce::Path referenceFillPath;
+    juce::Path referenceP10Path;
+    juce::Path referenceP90Path;
+    juce::Path referenceMedianPath;
+    juce::uint32 referencePathsVersion = 0;
+    bool referencePathsBuilt = false;
+
+    // Layout Konstanten (gelten fr die Basisgre, skaliert mit uiScale)
+    static constexpr int baseWidth = 1000;
+    static constexpr int baseHeight = 680;
     static constexpr int topBarHeight = 40;
     static constexpr int spectrogramOuterHeight = 430;
     static constexpr int spectrogramMargin = 10;
@@ -263,5 +377,10 @@ private:
     static constexpr int spectrumHeight = 390;
     static constexpr int spectrumBottomMargin = 20;
 
+    // Fensterbreite / baseWidth (Seitenverhltnis ist fest)
+    float uiScale = 1.0f;
+    int scaled(int value) const noexcept { return juce::roundToInt((float)value * uiScale); }
+    float scaled(float value) const noexcept { return value * uiScale; }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessorEditor)
 };
\ No newline at end of file
@@ -1,5 +1,98 @@
 ﻿#include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "FastMath.h"
+
+namespace
+{
+    // Adaptiver Modus: Regelparameter
+    constexpr float kAdaptiveMaxDb = 6.0f;            // max. Zusatzkorrektur je Band (±)
+    constexpr float kAdaptiveRateDbPerSec = 1.0f;     // max. Sollwert-Änderung (Regelgeschwindigkeit)
+    constexpr float kAdaptiveRampDbPerSec = 2.0f;     // max. Gain-Rampe der Koeffizienten
+    constexpr float kAdaptiveLevelTauSec = 1.5f;      // Zeitkonstante Kurzzeitpegel
+    constexpr float kAdaptiveGateDb = -120.0f;        // darunter: Band gilt als still (nicht regeln)
+    constexpr int kControlBlockSize = 32;             // Sub-Block-Raster für Koeffizienten-Rampen
+    constexpr float kSnapshotMorphRampSec = 0.02f;    // Dauer einer vollen A->B- bzw. Parameter->Snapshot-Überblendung
+
+    // Terzband-Grenzen: Faktor 2^(1/6)
+    const float kBandEdgeFactor = std::pow(2.0f, 1.0f / 6.0f);
+
+    // Peak-Filter-Koeffizienten (RBJ), normiert auf a0: b0, b1, b2, a1, a2
+    // Gleiche Formel wie Coefficients::makePeakFilter, mit vorberechnetem sin/cos(w0)
+    void computePeakCoefficients(float* c, float sinW0, float cosW0, float gainDb, float Q) noexcept
+    {
+        const float A = std::pow(10.0f, juce::jlimit(-12.0f, 12.0f, gainDb) / 40.0f);
+        const float alpha = sinW0 / (2.0f * juce::jmax(0.01f, Q));
+        const float c2 = -2.0f * cosW0;
+
+        const float a0Inv = 1.0f / (1.0f + alpha / A);
+
+        c[0] = (1.0f + alpha * A) * a0Inv;
+        c[1] = c2 * a0Inv;
+        c[2] = (1.0f - alpha * A) * a0Inv;
+        c[3] = c2 * a0Inv;
+        c[4] = (1.0f - alpha / A) * a0Inv;
+    }
+
+    // Plugin-State (Binärformat, little-endian):
+    //   Header:    Magic "MEQS", Formatversion
+    //   Sektionen: [Tag (int32)] [Länge in Bytes (int32)] [Nutzdaten]
+    // Unbekannte Sektionen werden beim Laden übersprungen, fehlende behalten
+    // ihren aktuellen Zustand. Neue Daten bekommen eine neue Sektion.
+    constexpr int kStateMagic = 0x5351454d;           // "MEQS"
+    constexpr int kStateVersion = 1;
+
+    enum StateSection : int
+    {
+        stateParameters = 1,  // Anzahl, dann je Parameter: ID (UTF-8) + normierter Wert
+        stateGenre = 2,       // selectedGenreId
+        stateReference = 3,   // Anzahl Bänder, dann je Band freq/p10/median/p90
+        stateTargets = 4,     // Flags + Zielkorrekturen + Zielresiduen (TargetCurve)
+        stateMeasurement = 5, // Snapshot-Anzahl, Bins, Frequenzen + Leistungssummen
+        stateSnapshots = 6    // Anzahl Slots, dann je Slot: gültig + Gains + Qs
+    };
+
+    // Schreibt eine Sektion und trägt ihre Länge nachträglich ein
+    template <typename WriteFn>
+    void writeStateSection(juce::MemoryOutputStream& out, StateSection tag, WriteFn&& writePayload)
+    {
+        out.writeInt(tag);
+        const auto lengthPos = out.getPosition();
+        out.writeInt(0);
+
+        writePayload(out);
+
+        const auto endPos = out.getPosition();
+        out.setPosition(lengthPos);
+        out.writeInt((int)(endPos - lengthPos - 4));
+        out.setPosition(endPos);
+    }
+
+    // Log-Interpolation der Referenz an einer Bandfrequenz
+    static AudioPluginAudioProcessor::ReferenceBand interpolateReferenceBand(
+        const std::vector<AudioPluginAudioProcessor::ReferenceBand>& ref, float fHz)
+    {
+        if (fHz <= ref.front().freq) return ref.front();
+        if (fHz >= ref.back().freq)  return ref.back();
+
+        for (size_t i = 1; i < ref.size(); ++i)
+        {
+            if (ref[i].freq >= fHz)
+            {
+                const auto& a = ref[i - 1];
+                const auto& b = ref[i];
+
+                const float t = (std::log10(fHz) - std::log10(a.freq)) / (std::log10(b.freq) - std::log10(a.freq));
+
+                return { fHz,
+                         a.p10 + t * (b.p10 - a.p10),
+                         a.median + t * (b.median - a.median),
+                         a.p90 + t * (b.p90 - a.p90) };
+            }
+        }
+
+        return ref.back();
+    }
+}
 
 //==============================================================================
 // Konstruktor
@@ -17,19 +110,34 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
     forwardFFT(fftOrder),
     window(fftSize, juce::dsp::WindowingFunction<float>::hann),
     preEQForwardFFT(fftOrder),
-    preEQWindow(fftSize, juce::dsp::WindowingFunction<float>::hann)
+    preEQWindow(fftSize, juce::dsp::WindowingFunction<float>::hann),
+    adaptiveFFT(fftOrder),
+    adaptiveWindow(fftSize, juce::dsp::WindowingFunction<float>::hann)
 {
     // Pre-EQ Puffer initialisieren
     juce::zeromem(preEQFifo, sizeof(preEQFifo));
     juce::zeromem(preEQFftData, sizeof(preEQFftData));
+    juce::zeromem(adaptiveFifo, sizeof(adaptiveFifo));
+    juce::zeromem(adaptiveFftData, sizeof(adaptiveFftData));
 
-    // Target Corrections initialisieren
-    targetCorrections.fill(0.0f);
+    inputGainParam = apvts.getRawParameterValue("inputGain");
+    adaptiveModeParam = apvts.getRawParameterValue("adaptiveMode");
 
     for (int i = 0; i < numBands; ++i)
     {
         apvts.addParameterListener("band" + juce::String(i), this);
         apvts.addParameterListener("bandQ" + juce::String(i), this);
+
+        bandGainParams[i] = apvts.getRawParameterValue("band" + juce::String(i));
+        bandQParams[i] = apvts.getRawParameterValue("bandQ" + juce::String(i));
+
+        // Ein Koeffizienten-Objekt pro Band, wird später nur noch in-place beschrieben
+        bandCoefficients[i] = Coefficients::makePeakFilter(48000.0, filterFrequencies[i], 4.32f, 1.0f);
+        leftFilters[i].coefficients = bandCoefficients[i];
+        rightFilters[i].coefficients = bandCoefficients[i];
+
+        for (auto& slot : snapshotCoefficients)
+            slot[i] = Coefficients::makePeakFilter(48000.0, filterFrequencies[i], 4.32f, 1.0f);
     }
 }
 
@@ -38,6 +146,8 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
 // Nullt alle Puffer beim Aufräumen, um Speicherreste zu vermeiden
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
+    cancelPendingUpdate();
+
     juce::zeromem(fifo, sizeof(fifo));
     juce::zeromem(fftData, sizeof(fftData));
     juce::zeromem(scopeData, sizeof(scopeData));
@@ -157,6 +267,13 @@ AudioPluginAudioProcessor::createParameterLayout()
         ));
     }
 
+    // Adaptiver Referenz-Tracking-Modus (an/aus)
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "adaptiveMode",
+        "Adaptive Reference Tracking",
+        false
+    ));
+
     return layout;
 }
 
@@ -170,6 +287,20 @@ void AudioPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerB
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = 1; // Mono pro Filter, getrennt für L/R
 
+    // Samplerate-abhängige Konstanten (sin/cos je Band, FFT-Bins)
+    prepareBandCoefficients(sampleRate);
+
+    // Snapshot-Koeffizienten gelten nur für eine Samplerate -> neu berechnen
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+
+        for (auto& snapshot : pendingSnapshots)
+            if (snapshot.valid)
+                computeSnapshotCoefficients(snapshot);
+
+        snapshotsChanged = true;
+    }
+
     // Alle 31 Filter vorbereiten
     for (int i = 0; i < numBands; ++i)
     {
@@ -177,41 +308,82 @@ void AudioPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerB
         rightFilters[i].prepare(spec);
     }
 
+    // Adaptiven Zustand neu starten
+    adaptiveFifoIndex = 0;
+    adaptiveLevelsPrimed = false;
+    adaptiveTargetDb.fill(0.0f);
+    adaptiveGainDb.fill(0.0f);
+
     updateFilters();
 }
 
 //==============================================================================
-// Filter aktualisieren
-// Berechnet die aktuellen Biquad-Parameter für jeden Band-EQ
-void AudioPluginAudioProcessor::updateFilters()
+// Samplerate-abhängige Konstanten vorberechnen
+// sin/cos(w0) für die Koeffizienten, FFT-Bins für die adaptive Bandpegel-Analyse
+void AudioPluginAudioProcessor::prepareBandCoefficients(double sampleRate)
 {
-    auto sampleRate = getSampleRate();
-    if (sampleRate <= 0)
+    currentSampleRate = sampleRate;
+    if (sampleRate <= 0.0)
         return;
 
+    const double nyquist = 0.5 * sampleRate;
+    const double binWidth = sampleRate / (double)fftSize;
+    const int maxBin = (fftSize / 2) - 1;
+
     for (int i = 0; i < numBands; ++i)
     {
-        auto* gainParam = apvts.getRawParameterValue("band" + juce::String(i));
-        auto* qParam = apvts.getRawParameterValue("bandQ" + juce::String(i));
-        if (gainParam == nullptr || qParam == nullptr)
+        // Mittenfrequenz knapp unter Nyquist halten (z.B. 20 kHz bei 32 kHz SR)
+        const double f0 = juce::jmin((double)filterFrequencies[i], nyquist * 0.98);
+        const double w0 = juce::MathConstants<double>::twoPi * f0 / sampleRate;
+
+        bandSinW0[i] = (float)std::sin(w0);
+        bandCosW0[i] = (float)std::cos(w0);
+
+        // Bins wie in updatePreEQSpectrumArray()
+        const double lowerFreq = filterFrequencies[i] / kBandEdgeFactor;
+        const double upperFreq = juce::jmin((double)filterFrequencies[i] * kBandEdgeFactor, nyquist);
+
+        if (lowerFreq >= nyquist)
+        {
+            adaptiveBinLo[i] = adaptiveBinHi[i] = -1; // Band liegt über Nyquist
             continue;
+        }
 
-        float gainDB = gainParam->load(); // Gain aus Parameter (dB)
-        float gainLinear = juce::Decibels::decibelsToGain(gainDB); // Linearer Gain
-        float Q = qParam->load(); // Bandbreite für jedes Band
+        adaptiveBinLo[i] = juce::jlimit(1, maxBin, (int)std::floor(lowerFreq / binWidth));
+        adaptiveBinHi[i] = juce::jlimit(1, maxBin, (int)std::ceil(upperFreq / binWidth));
+    }
+}
 
-        // Biquad-Koeffizienten für Peak-Filter berechnen
-        auto coeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-            sampleRate,
-            filterFrequencies[i],
-            Q,
-            gainLinear
-        );
+//==============================================================================
+// Peak-Filter-Koeffizienten eines Bands direkt im bestehenden Objekt setzen
+// Gleiche Formel wie Coefficients::makePeakFilter, aber ohne Allokation und
+// mit vorberechnetem sin/cos(w0) -> billig genug für Rampen im Sub-Block-Raster
+void AudioPluginAudioProcessor::setBandCoefficients(int band, float gainDb, float Q) noexcept
+{
+    computePeakCoefficients(bandCoefficients[band]->getRawCoefficients(),
+        bandSinW0[band], bandCosW0[band], gainDb, Q);
+}
+
+//==============================================================================
+// Filter aktualisieren
+// Berechnet die aktuellen Biquad-Parameter für jeden Band-EQ
+// (Parameter-Gain + adaptive Zusatzkorrektur)
+void AudioPluginAudioProcessor::updateFilters()
+{
+    const TraceRecorder::Scope traceScope("updateFilters", "audio", traceId);
 
-        // Filter aktualisieren
-        leftFilters[i].coefficients = coeffs;
-        rightFilters[i].coefficients = coeffs;
+    if (currentSampleRate <= 0)
+        return;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        appliedGainDb[i] = bandGainParams[i]->load(); // Gain aus Parameter (dB)
+        appliedQ[i] = bandQParams[i]->load();         // Bandbreite für jedes Band
+
+        setBandCoefficients(i, appliedGainDb[i] + adaptiveGainDb[i], appliedQ[i]);
     }
+
+    performanceCounters.coefficientRebuilds.fetch_add(numBands, std::memory_order_relaxed);
 }
 
 void AudioPluginAudioProcessor::resetAllBandsToDefault()
@@ -236,7 +408,9 @@ void AudioPluginAudioProcessor::resetAllBandsToDefault()
                 pQ->setValueNotifyingHost(pQ->getDefaultValue());
         }
     }
-    updateFilters();
+
+    // Koeffizienten werden nur im Audio-Thread geschrieben
+    filtersNeedUpdate.store(true, std::memory_order_release);
 }
 
 
@@ -273,11 +447,16 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layout
 // Audio-Block verarbeiten
 void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    const TraceRecorder::Scope traceScope("processBlock", "audio", traceId);
+    const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+
     if (filtersNeedUpdate.exchange(false, std::memory_order_acq_rel))
         updateFilters();
 
+    const bool snapshotCompare = updateSnapshotRouting();
+
     // Input Gain anwenden
-    float inputGainDb = apvts.getRawParameterValue("inputGain")->load();
+    float inputGainDb = inputGainParam->load();
     float inputGainLinear = juce::Decibels::decibelsToGain(inputGainDb);
 
     juce::ignoreUnused(midiMessages);
@@ -331,20 +510,37 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
 
     //==========================================================================
     // EQ-Filter anwenden
+    // Im adaptiven Modus (oder solange dessen Gains noch zurückrampen) wird im
+    // Sub-Block-Raster verarbeitet, damit sich die Koeffizienten stufenlos ändern.
     //==========================================================================
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    const bool adaptiveEnabled = adaptiveModeParam->load() > 0.5f;
+
+    if (!adaptiveEnabled)
+        adaptiveTargetDb.fill(0.0f);
+
+    if (snapshotCompare)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        juce::dsp::AudioBlock<float> block(&channelData, 1, buffer.getNumSamples());
+        // A/B-Vergleich: Snapshot-Koeffizienten statt Parameter (ohne adaptive Korrektur)
+        for (int start = 0; start < buffer.getNumSamples(); start += kControlBlockSize)
+        {
+            const int len = juce::jmin(kControlBlockSize, buffer.getNumSamples() - start);
 
-        for (int i = 0; i < numBands; ++i)
+            stepSnapshotMorph(len);
+            processEQ(buffer, start, len);
+        }
+    }
+    else if (!adaptiveEnabled && isAdaptiveIdle())
+    {
+        processEQ(buffer, 0, buffer.getNumSamples());
+    }
+    else
+    {
+        for (int start = 0; start < buffer.getNumSamples(); start += kControlBlockSize)
         {
-            juce::dsp::ProcessContextReplacing<float> context(block);
+            const int len = juce::jmin(kControlBlockSize, buffer.getNumSamples() - start);
 
-            if (channel == 0)
-                leftFilters[i].process(context);
-            else if (channel == 1)
-                rightFilters[i].process(context);
+            rampAdaptiveGains(len);
+            processEQ(buffer, start, len);
         }
     }
 
@@ -366,6 +562,9 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
             {
                 float monoSample = (leftData[i] + rightData[i]) * 0.5f;
                 pushNextSampleIntoFifo(monoSample);
+
+                if (adaptiveEnabled)
+                    pushNextSampleIntoAdaptiveFifo(monoSample);
             }
         }
         else if (numChannels == 1)
@@ -373,9 +572,424 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
             // Mono-Input: direkt verwenden
             auto* channelData = buffer.getReadPointer(0);
             for (auto i = 0; i < numSamples; ++i)
+            {
                 pushNextSampleIntoFifo(channelData[i]);
+
+                if (adaptiveEnabled)
+                    pushNextSampleIntoAdaptiveFifo(channelData[i]);
+            }
         }
     }
+
+    // Beim Ausschalten Analyse verwerfen, damit ein Neustart frisch einschwingt
+    if (!adaptiveEnabled)
+    {
+        adaptiveFifoIndex = 0;
+        adaptiveLevelsPrimed = false;
+    }
+
+    // Blockdauer gegen Deadline (Blocklänge in Echtzeit) für das HUD
+    if (currentSampleRate > 0.0)
+    {
+        const double durationMs = 1000.0 * juce::Time::highResolutionTicksToSeconds(
+            juce::Time::getHighResolutionTicks() - blockStartTicks);
+        const double deadlineMs = 1000.0 * buffer.getNumSamples() / currentSampleRate;
+
+        performanceCounters.recordBlock(durationMs, deadlineMs);
+    }
+}
+
+//==============================================================================
+// Alle Bänder auf einen Abschnitt des Buffers anwenden (L/R getrennt)
+void AudioPluginAudioProcessor::processEQ(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    const int numChannels = juce::jmin(2, getTotalNumInputChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* channelData = buffer.getWritePointer(channel, startSample);
+        juce::dsp::AudioBlock<float> block(&channelData, 1, (size_t)numSamples);
+        juce::dsp::ProcessContextReplacing<float> context(block);
+
+        auto& filters = (channel == 0) ? leftFilters : rightFilters;
+
+        for (int i = 0; i < numBands; ++i)
+            filters[i].process(context);
+    }
+}
+
+//==============================================================================
+// Adaptiver Modus: Post-EQ Samples sammeln (Hop = fftSize / 2)
+void AudioPluginAudioProcessor::pushNextSampleIntoAdaptiveFifo(float sample) noexcept
+{
+    adaptiveFifo[adaptiveFifoIndex++] = sample;
+
+    if (adaptiveFifoIndex == fftSize)
+    {
+        runAdaptiveAnalysis();
+
+        // 50% Overlap: zweite Hälfte nach vorne schieben
+        std::memmove(adaptiveFifo, adaptiveFifo + fftSize / 2, sizeof(float) * (fftSize / 2));
+        adaptiveFifoIndex = fftSize / 2;
+    }
+}
+
+//==============================================================================
+// Adaptiver Modus: Bandpegel messen und Sollwerte nachführen
+// Läuft im Audio-Thread, einmal pro Hop (~23 Hz bei 48 kHz)
+void AudioPluginAudioProcessor::runAdaptiveAnalysis() noexcept
+{
+    const TraceRecorder::Scope traceScope("runAdaptiveAnalysis", "audio", traceId);
+
+    // Neue Referenz übernehmen (nie blockieren: bei Konflikt nächster Hop)
+    {
+        const juce::SpinLock::ScopedTryLockType lock(adaptiveReferenceLock);
+        if (lock.isLocked() && adaptiveReferenceChanged)
+        {
+            adaptiveReference = pendingAdaptiveReference;
+            adaptiveReferenceChanged = false;
+        }
+    }
+
+    if (!adaptiveReference.valid || currentSampleRate <= 0.0)
+    {
+        adaptiveTargetDb.fill(0.0f);
+        return;
+    }
+
+    // --- 1) Kurzzeit-Bandpegel (gleiche Skalierung wie Anzeige/Offline-Analyse) ---
+    std::copy(adaptiveFifo, adaptiveFifo + fftSize, adaptiveFftData);
+    std::fill(adaptiveFftData + fftSize, adaptiveFftData + 2 * fftSize, 0.0f);
+
+    adaptiveWindow.multiplyWithWindowingTable(adaptiveFftData, fftSize);
+    adaptiveFFT.performFrequencyOnlyForwardTransform(adaptiveFftData);
+
+    const float hopSeconds = (float)((fftSize / 2) / currentSampleRate);
+    const float levelCoeff = std::exp(-hopSeconds / kAdaptiveLevelTauSec);
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        if (adaptiveBinLo[i] < 0)
+            continue;
+
+        float sumMag = 0.0f;
+        for (int bin = adaptiveBinLo[i]; bin <= adaptiveBinHi[i]; ++bin)
+            sumMag += adaptiveFftData[bin];
+
+        const float mag = sumMag / (float)(adaptiveBinHi[i] - adaptiveBinLo[i] + 1) * (2.0f / (float)fftSize);
+        const float db = FastMath::gainToDb(mag, -160.0f);
+
+        adaptiveLevelDb[i] = adaptiveLevelsPrimed ? levelCoeff * adaptiveLevelDb[i] + (1.0f - levelCoeff) * db
+                                                  : db;
+    }
+
+    adaptiveLevelsPrimed = true;
+
+    // --- 2) Pegel-Offset zur Referenz (Median 50 Hz..10 kHz, wie die Anzeige) ---
+    std::array<float, numBands> diffs{};
+    int numDiffs = 0;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        const float f = filterFrequencies[i];
+        if (f < 50.0f || f > 10000.0f || adaptiveBinLo[i] < 0 || adaptiveLevelDb[i] < kAdaptiveGateDb)
+            continue;
+
+        diffs[numDiffs++] = adaptiveReference.median[i] - adaptiveLevelDb[i];
+    }
+
+    if (numDiffs == 0)
+        return; // Stille -> Sollwerte halten
+
+    std::nth_element(diffs.begin(), diffs.begin() + numDiffs / 2, diffs.begin() + numDiffs);
+    const float offsetDb = diffs[numDiffs / 2];
+
+    // --- 3) Sollwerte ratenbegrenzt Richtung p10..p90-Fenster schieben ---
+    const float maxStep = kAdaptiveRateDbPerSec * hopSeconds;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        if (adaptiveBinLo[i] < 0 || adaptiveLevelDb[i] < kAdaptiveGateDb)
+            continue;
+
+        const float aligned = adaptiveLevelDb[i] + offsetDb;
+
+        float errorDb = 0.0f;
+        if (aligned < adaptiveReference.p10[i])
+            errorDb = adaptiveReference.p10[i] - aligned;
+        else if (aligned > adaptiveReference.p90[i])
+            errorDb = adaptiveReference.p90[i] - aligned;
+
+        adaptiveTargetDb[i] = juce::jlimit(-kAdaptiveMaxDb, kAdaptiveMaxDb,
+            adaptiveTargetDb[i] + juce::jlimit(-maxStep, maxStep, errorDb));
+    }
+}
+
+//==============================================================================
+// Adaptiver Modus: angewendete Gains Richtung Sollwert rampen
+// Gibt true zurück, wenn sich mindestens ein Koeffizientensatz geändert hat
+bool AudioPluginAudioProcessor::rampAdaptiveGains(int numSamples) noexcept
+{
+    if (currentSampleRate <= 0.0)
+        return false;
+
+    const float maxStep = kAdaptiveRampDbPerSec * (float)numSamples / (float)currentSampleRate;
+    int numChanged = 0;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        const float diff = adaptiveTargetDb[i] - adaptiveGainDb[i];
+        if (diff == 0.0f)
+            continue;
+
+        // Letzten Schritt exakt auf den Sollwert setzen (sonst nie "idle")
+        adaptiveGainDb[i] = (std::abs(diff) <= maxStep) ? adaptiveTargetDb[i]
+                                                        : adaptiveGainDb[i] + std::copysign(maxStep, diff);
+        setBandCoefficients(i, appliedGainDb[i] + adaptiveGainDb[i], appliedQ[i]);
+        ++numChanged;
+    }
+
+    if (numChanged > 0)
+        performanceCounters.coefficientRebuilds.fetch_add((std::uint64_t)numChanged, std::memory_order_relaxed);
+
+    return numChanged > 0;
+}
+
+bool AudioPluginAudioProcessor::isAdaptiveIdle() const noexcept
+{
+    for (int i = 0; i < numBands; ++i)
+        if (adaptiveGainDb[i] != 0.0f || adaptiveTargetDb[i] != 0.0f)
+            return false;
+
+    return true;
+}
+
+//==============================================================================
+// EQ-Snapshots: Slot aus den aktuellen Parametern speichern (Message-Thread)
+void AudioPluginAudioProcessor::storeSnapshot(int slot)
+{
+    std::array<float, numBands> gains{}, qs{};
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        gains[(size_t)i] = bandGainParams[i]->load();
+        qs[(size_t)i] = bandQParams[i]->load();
+    }
+
+    storeSnapshot(slot, gains, qs);
+}
+
+void AudioPluginAudioProcessor::storeSnapshot(int slot, const std::array<float, 31>& gainsDb,
+    const std::array<float, 31>& qs)
+{
+    if (!juce::isPositiveAndBelow(slot, numSnapshots))
+        return;
+
+    const juce::SpinLock::ScopedLockType lock(snapshotLock);
+
+    auto& snapshot = pendingSnapshots[(size_t)slot];
+    snapshot.gainDb = gainsDb;
+    snapshot.q = qs;
+    snapshot.valid = true;
+    computeSnapshotCoefficients(snapshot);
+
+    snapshotsChanged = true;
+}
+
+bool AudioPluginAudioProcessor::hasSnapshot(int slot) const
+{
+    return juce::isPositiveAndBelow(slot, numSnapshots) && pendingSnapshots[(size_t)slot].valid;
+}
+
+//==============================================================================
+// Vergleich einstellen: slotA allein (Umschalten) oder slotA->slotB mit Morph 0..1
+void AudioPluginAudioProcessor::setSnapshotCompare(int slotA, int slotB, float morph)
+{
+    snapshotMorphTarget.store(juce::jlimit(0.0f, 1.0f, morph), std::memory_order_relaxed);
+    snapshotCompareB.store(slotB, std::memory_order_relaxed);
+    snapshotCompareA.store(slotA, std::memory_order_release);
+}
+
+//==============================================================================
+// Snapshot in die Parameter übernehmen und Vergleich beenden
+void AudioPluginAudioProcessor::applySnapshotToParameters(int slot)
+{
+    if (!hasSnapshot(slot))
+        return;
+
+    const auto& snapshot = pendingSnapshots[(size_t)slot];
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        if (auto* p = dynamic_cast<juce::RangedAudioParameter*>(apvts.getParameter("band" + juce::String(i))))
+        {
+            p->beginChangeGesture();
+            p->setValueNotifyingHost(p->convertTo0to1(snapshot.gainDb[(size_t)i]));
+            p->endChangeGesture();
+        }
+
+        if (auto* pQ = dynamic_cast<juce::RangedAudioParameter*>(apvts.getParameter("bandQ" + juce::String(i))))
+        {
+            pQ->beginChangeGesture();
+            pQ->setValueNotifyingHost(pQ->convertTo0to1(snapshot.q[(size_t)i]));
+            pQ->endChangeGesture();
+        }
+    }
+
+    setSnapshotCompare(-1, -1, 0.0f);
+}
+
+//==============================================================================
+// Koeffizienten eines Snapshots für die aktuelle Samplerate berechnen
+void AudioPluginAudioProcessor::computeSnapshotCoefficients(EQSnapshot& snapshot) const noexcept
+{
+    if (currentSampleRate <= 0.0)
+        return; // prepareToPlay() holt das nach
+
+    for (int i = 0; i < numBands; ++i)
+        computePeakCoefficients(snapshot.coefficients.data() + 5 * i, bandSinW0[i], bandCosW0[i],
+            snapshot.gainDb[(size_t)i], snapshot.q[(size_t)i]);
+}
+
+//==============================================================================
+// Audio-Thread: neue Snapshots übernehmen und Vergleichsmodus bestimmen
+// Gibt true zurück, wenn der Block mit Snapshot-Koeffizienten laufen soll
+bool AudioPluginAudioProcessor::updateSnapshotRouting() noexcept
+{
+    {
+        const juce::SpinLock::ScopedTryLockType lock(snapshotLock);
+
+        if (lock.isLocked() && snapshotsChanged)
+        {
+            for (int s = 0; s < numSnapshots; ++s)
+            {
+                const auto& snapshot = pendingSnapshots[(size_t)s];
+                snapshotValid[(size_t)s] = snapshot.valid;
+
+                if (!snapshot.valid)
+                    continue;
+
+                for (int i = 0; i < numBands; ++i)
+                    std::copy_n(snapshot.coefficients.data() + 5 * i, 5,
+                        snapshotCoefficients[(size_t)s][(size_t)i]->getRawCoefficients());
+            }
+
+            snapshotsChanged = false;
+        }
+    }
+
+    auto isValidSlot = [this](int slot)
+        {
+            return juce::isPositiveAndBelow(slot, numSnapshots) && snapshotValid[(size_t)slot];
+        };
+
+    const int slotA = snapshotCompareA.load(std::memory_order_acquire);
+    comparingSnapshots = isValidSlot(slotA);
+
+    if (comparingSnapshots)
+    {
+        // Aus den Parametern kommend: Morph-Punkt direkt setzen, hörbar wird er über snapshotBlend
+        if (snapshotBlend <= 0.0f)
+            snapshotMorph = snapshotMorphTarget.load(std::memory_order_relaxed);
+
+        const int slotB = snapshotCompareB.load(std::memory_order_relaxed);
+        activeCompareA = slotA;
+        activeCompareB = isValidSlot(slotB) ? slotB : slotA;
+        return true;
+    }
+
+    // Noch beim Ausblenden: weiter mit den zuletzt gewählten Slots
+    if (snapshotBlend > 0.0f && isValidSlot(activeCompareA) && isValidSlot(activeCompareB))
+        return true;
+
+    // Ausgeblendet: bandCoefficients aus den Parametern und wieder einhängen
+    if (activeCompareA >= 0)
+    {
+        activeCompareA = activeCompareB = -1;
+        snapshotBlend = 0.0f;
+        updateFilters();
+        pointFiltersAt(-1);
+    }
+
+    return false;
+}
+
+//==============================================================================
+// Audio-Thread: Morph-Position und Überblendung rampen, Koeffizienten für den Sub-Block setzen
+// Voll eingeblendet hängen die Filter an den Morph-Endpunkten direkt an den
+// Snapshot-Koeffizienten (Zeigertausch). Dazwischen wird in bandCoefficients
+// linear interpoliert: erst zwischen den Slots, dann beim Ein- und Ausschalten
+// zwischen den Parametern und dem Snapshot-Stand, damit der Wechsel nicht klickt.
+// Die Interpolation bleibt stabil: das Stabilitätsdreieck von (a1, a2) ist konvex.
+void AudioPluginAudioProcessor::stepSnapshotMorph(int numSamples) noexcept
+{
+    const int slotA = activeCompareA;
+    const int slotB = activeCompareB;
+
+    const float maxStep = (float)numSamples / (kSnapshotMorphRampSec * (float)currentSampleRate);
+    auto rampTowards = [maxStep](float& value, float target)
+        {
+            const float diff = target - value;
+            value = (std::abs(diff) <= maxStep) ? target : value + std::copysign(maxStep, diff);
+        };
+
+    rampTowards(snapshotMorph, (slotB == slotA) ? 0.0f : snapshotMorphTarget.load(std::memory_order_relaxed));
+    rampTowards(snapshotBlend, comparingSnapshots ? 1.0f : 0.0f);
+
+    if (snapshotBlend >= 1.0f && snapshotMorph <= 0.0f)
+    {
+        pointFiltersAt(slotA);
+        return;
+    }
+
+    if (snapshotBlend >= 1.0f && snapshotMorph >= 1.0f)
+    {
+        pointFiltersAt(slotB);
+        return;
+    }
+
+    const float t = snapshotMorph;
+    const float blend = snapshotBlend;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        const auto* a = snapshotCoefficients[(size_t)slotA][(size_t)i]->getRawCoefficients();
+        const auto* b = snapshotCoefficients[(size_t)slotB][(size_t)i]->getRawCoefficients();
+        auto* c = bandCoefficients[i]->getRawCoefficients();
+
+        // Parameter-Stand wie in updateFilters() (inkl. eingefrorener adaptiver Korrektur)
+        float live[5] = {};
+        if (blend < 1.0f)
+            computePeakCoefficients(live, bandSinW0[i], bandCosW0[i], appliedGainDb[i] + adaptiveGainDb[i], appliedQ[i]);
+
+        for (int k = 0; k < 5; ++k)
+        {
+            const float snapshot = a[k] + t * (b[k] - a[k]);
+            c[k] = (blend < 1.0f) ? live[k] + blend * (snapshot - live[k]) : snapshot;
+        }
+    }
+
+    performanceCounters.coefficientRebuilds.fetch_add(numBands, std::memory_order_relaxed);
+    pointFiltersAt(-1);
+}
+
+//==============================================================================
+// Audio-Thread: Filter auf einen Koeffizientensatz umhängen (-1 = bandCoefficients)
+// Die Objekte gehören dem Processor, der Tausch gibt also nie Speicher frei.
+void AudioPluginAudioProcessor::pointFiltersAt(int source) noexcept
+{
+    if (source == filterCoefficientSource)
+        return;
+
+    filterCoefficientSource = source;
+
+    const auto& set = (source < 0) ? bandCoefficients : snapshotCoefficients[(size_t)source];
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        leftFilters[i].coefficients = set[i];
+        rightFilters[i].coefficients = set[i];
+    }
 }
 
 //==============================================================================
@@ -390,6 +1004,12 @@ void AudioPluginAudioProcessor::pushNextSampleIntoFifo(float sample) noexcept
             juce::zeromem(fftData, sizeof(fftData));
             memcpy(fftData, fifo, sizeof(fifo));
             nextFFTBlockReady.store(true);
+            performanceCounters.analyzerFramesProduced.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            // GUI hat den letzten Block noch nicht abgeholt
+            performanceCounters.analyzerFramesDropped.fetch_add(1, std::memory_order_relaxed);
         }
         fifoIndex = 0;
     }
@@ -403,6 +1023,10 @@ void AudioPluginAudioProcessor::pushNextSampleIntoPreEQFifo(float sample) noexce
 {
     if (preEQFifoIndex == fftSize)
     {
+        // Jeder volle Block während der Messung sollte einen Snapshot ergeben
+        if (measuring.load(std::memory_order_relaxed))
+            performanceCounters.measurementFramesExpected.fetch_add(1, std::memory_order_relaxed);
+
         if (!nextPreEQFFTBlockReady.load())
         {
             juce::zeromem(preEQFftData, sizeof(preEQFftData));
@@ -420,6 +1044,8 @@ void AudioPluginAudioProcessor::pushNextSampleIntoPreEQFifo(float sample) noexce
 // Berechnet FFT, wendet Windowing an und erstellt normalisiertes Spektrum
 void AudioPluginAudioProcessor::updateSpectrumArray(double sampleRate)
 {
+    const TraceRecorder::Scope traceScope("updateSpectrumArray", "analyzer", traceId);
+
     // Fensterung
     window.multiplyWithWindowingTable(fftData, fftSize);
     forwardFFT.performFrequencyOnlyForwardTransform(fftData);
@@ -427,13 +1053,9 @@ void AudioPluginAudioProcessor::updateSpectrumArray(double sampleRate)
     spectrumArray.clear();
     spectrumArray.reserve(scopeSize);
 
-    // Terzband-Mittenfrequenzen (nach IEC 61260)
-    // Von 25 Hz bis 20 kHz
-    std::vector<float> thirdOctaveCenterFreqs = {
-        20.0f, 25.0f, 31.5f, 40.0f, 50.0f, 63.0f, 80.0f, 100.0f, 125.0f, 160.0f, 200.0f,
-        250.0f, 315.0f, 400.0f, 500.0f, 630.0f, 800.0f, 1000.0f, 1250.0f, 1600.0f, 2000.0f,
-        2500.0f, 3150.0f, 4000.0f, 5000.0f, 6300.0f, 8000.0f, 10000.0f, 12500.0f, 16000.0f, 20000.0f
-    };
+    // Terzband-Mittenfrequenzen (nach IEC 61260) = Filterfrequenzen,
+    // kein lokaler Vektor mehr (keine Allokation pro Frame)
+    const auto& thirdOctaveCenterFreqs = filterFrequencies;
 
     // Amplituden normieren
     const float binWidth = sampleRate / (float)fftSize;
@@ -479,7 +1101,7 @@ void AudioPluginAudioProcessor::updateSpectrumArray(double sampleRate)
 
         // In dB umrechnen
         const float floorDb = -160.0f;
-        float dbFs = juce::Decibels::gainToDecibels(mag, floorDb);
+        float dbFs = FastMath::gainToDb(mag, floorDb);
 
         spectrumArray.push_back({ centerFreq, dbFs });
     }
@@ -489,6 +1111,8 @@ void AudioPluginAudioProcessor::updateSpectrumArray(double sampleRate)
 // Pre-EQ Spectrum Array aktualisieren (für Messung)
 void AudioPluginAudioProcessor::updatePreEQSpectrumArray(double sampleRate)
 {
+    const TraceRecorder::Scope traceScope("updatePreEQSpectrumArray", "analyzer", traceId);
+
     // Fensterung
     preEQWindow.multiplyWithWindowingTable(preEQFftData, fftSize);
     preEQForwardFFT.performFrequencyOnlyForwardTransform(preEQFftData);
@@ -496,12 +1120,8 @@ void AudioPluginAudioProcessor::updatePreEQSpectrumArray(double sampleRate)
     preEQSpectrumArray.clear();
     preEQSpectrumArray.reserve(scopeSize);
 
-    // Terzband-Mittenfrequenzen (nach IEC 61260)
-    std::vector<float> thirdOctaveCenterFreqs = {
-        20.0f, 25.0f, 31.5f, 40.0f, 50.0f, 63.0f, 80.0f, 100.0f, 125.0f, 160.0f, 200.0f,
-        250.0f, 315.0f, 400.0f, 500.0f, 630.0f, 800.0f, 1000.0f, 1250.0f, 1600.0f, 2000.0f,
-        2500.0f, 3150.0f, 4000.0f, 5000.0f, 6300.0f, 8000.0f, 10000.0f, 12500.0f, 16000.0f, 20000.0f
-    };
+    // Terzband-Mittenfrequenzen (nach IEC 61260) = Filterfrequenzen
+    const auto& thirdOctaveCenterFreqs = filterFrequencies;
 
     // Amplituden normieren
     const float fftNorm = (float)fftSize;
@@ -545,7 +1165,7 @@ void AudioPluginAudioProcessor::updatePreEQSpectrumArray(double sampleRate)
         float mag = magRaw * (2.0f / (float)fftSize);
 
         const float floorDb = -160.0f;
-        float dbFs = juce::Decibels::gainToDecibels(mag, floorDb);
+        float dbFs = FastMath::gainToDb(mag, floorDb);
 
         preEQSpectrumArray.push_back({ centerFreq, dbFs });
     }
@@ -570,14 +1190,340 @@ void AudioPluginAudioProcessor::parameterChanged(const juce::String&, float)
 
 //==============================================================================
 // State Management
+// Hosts rufen das häufig auf (Undo, Autosave, Session mit vielen Instanzen),
+// deshalb ein flaches Binärformat statt XML/ValueTree: kein Parsen, keine
+// Zwischenobjekte, Größe vorab reserviert.
 void AudioPluginAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    juce::ignoreUnused(destData);
+    const auto& params = getParameters();
+
+    // Ein geladener, vom Message-Thread noch nicht übernommener State hat Vorrang
+    const juce::SpinLock::ScopedLockType loadedLock(loadedStateLock);
+    const auto& loaded = pendingLoadedState;
+    const bool pendingMeasurement = loadedStateChanged && loaded.hasMeasurement;
+
+    const int genreId = loadedStateChanged && loaded.hasGenre ? loaded.selectedGenreId : selectedGenreId;
+    const auto& bands = loadedStateChanged && loaded.hasReference ? loaded.referenceBands : referenceBands;
+    const auto& frequencies = pendingMeasurement ? loaded.measurementFrequencies : measurementFrequencies;
+    const auto& powerSum = pendingMeasurement ? loaded.measurementPowerSum : measurementPowerSum;
+    const int snapshotCount = pendingMeasurement ? loaded.measurementSnapshotCount : measurementSnapshotCount;
+
+    destData.reset();
+    juce::MemoryOutputStream out(destData, false);
+    out.preallocate(64 + params.size() * 20
+                    + bands.size() * sizeof(ReferenceBand)
+                    + 2 * numBands * sizeof(float)
+                    + frequencies.size() * (sizeof(float) + sizeof(double)));
+
+    out.writeInt(kStateMagic);
+    out.writeInt(kStateVersion);
+
+    writeStateSection(out, stateParameters, [&](juce::MemoryOutputStream& s)
+        {
+            s.writeInt(params.size());
+
+            for (auto* param : params)
+            {
+                auto* withId = dynamic_cast<juce::AudioProcessorParameterWithID*>(param);
+                s.writeString(withId != nullptr ? withId->paramID : juce::String());
+                s.writeFloat(param->getValue());
+            }
+        });
+
+    writeStateSection(out, stateGenre, [&](juce::MemoryOutputStream& s)
+        {
+            s.writeInt(genreId);
+        });
+
+    writeStateSection(out, stateReference, [&](juce::MemoryOutputStream& s)
+        {
+            s.writeInt((int)bands.size());
+
+            for (const auto& band : bands)
+            {
+                s.writeFloat(band.freq);
+                s.writeFloat(band.p10);
+                s.writeFloat(band.median);
+                s.writeFloat(band.p90);
+            }
+        });
+
+    writeStateSection(out, stateTargets, [&](juce::MemoryOutputStream& s)
+        {
+            const auto target = getTargetCurve();
+
+            s.writeBool(target.hasCorrections);
+            s.writeBool(target.hasResiduals);
+            s.writeInt(numBands);
+
+            for (int i = 0; i < numBands; ++i)
+                s.writeFloat(target.correctionsDb[(size_t)i]);
+
+            for (int i = 0; i < numBands; ++i)
+                s.writeFloat(target.residualsDb[(size_t)i]);
+        });
+
+    writeStateSection(out, stateMeasurement, [&](juce::MemoryOutputStream& s)
+        {
+            s.writeInt(snapshotCount);
+            s.writeInt((int)frequencies.size());
+
+            for (const float f : frequencies)
+                s.writeFloat(f);
+
+            for (const double p : powerSum)
+                s.writeDouble(p);
+        });
+
+    writeStateSection(out, stateSnapshots, [&](juce::MemoryOutputStream& s)
+        {
+            s.writeInt(numSnapshots);
+            s.writeInt(numBands);
+
+            for (const auto& snapshot : pendingSnapshots)
+            {
+                s.writeBool(snapshot.valid);
+
+                for (const float g : snapshot.gainDb)
+                    s.writeFloat(g);
+
+                for (const float q : snapshot.q)
+                    s.writeFloat(q);
+            }
+        });
+
+    out.flush();
 }
 
 void AudioPluginAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    juce::ignoreUnused(data, sizeInBytes);
+    if (data == nullptr || sizeInBytes < 8)
+        return;
+
+    juce::MemoryInputStream in(data, (size_t)sizeInBytes, false);
+
+    if (in.readInt() != kStateMagic)
+    {
+        DBG("Plugin-State: unbekanntes Format, wird ignoriert");
+        return;
+    }
+
+    // Neuere Versionen sind lesbar, solange sie nur Sektionen hinzufügen
+    const int version = in.readInt();
+    if (version < 1)
+        return;
+
+    // Referenzkurve, Messung und Genre gehören dem Message-Thread: hier nur
+    // sammeln, übernommen wird in handleAsyncUpdate()
+    LoadedState loaded;
+
+    while (in.getNumBytesRemaining() >= 8)
+    {
+        const int tag = in.readInt();
+        const int length = in.readInt();
+
+        if (length < 0 || length > in.getNumBytesRemaining())
+            break; // abgeschnittener State -> Rest verwerfen
+
+        const auto sectionEnd = in.getPosition() + length;
+
+        switch (tag)
+        {
+        case stateParameters:
+        {
+            const int count = in.readInt();
+
+            // Wie ein XML-State über apvts.replaceState(): die Werte landen im
+            // State-Baum, die APVTS setzt nur geänderte Parameter
+            auto state = apvts.copyState();
+
+            for (int i = 0; i < count && in.getPosition() < sectionEnd; ++i)
+            {
+                const auto id = in.readString();
+                const float value = juce::jlimit(0.0f, 1.0f, in.readFloat());
+
+                if (auto* param = apvts.getParameter(id))
+                {
+                    auto child = state.getChildWithProperty("id", id);
+                    if (child.isValid())
+                        child.setProperty("value", param->convertFrom0to1(value), nullptr);
+                }
+            }
+
+            apvts.replaceState(state);
+            break;
+        }
+
+        case stateGenre:
+            loaded.selectedGenreId = in.readInt();
+            loaded.hasGenre = true;
+            break;
+
+        case stateReference:
+        {
+            const int count = in.readInt();
+
+            if (count >= 0 && (juce::int64)count * 16 <= sectionEnd - in.getPosition())
+            {
+                loaded.referenceBands.resize((size_t)count);
+
+                for (auto& band : loaded.referenceBands)
+                {
+                    band.freq = in.readFloat();
+                    band.p10 = in.readFloat();
+                    band.median = in.readFloat();
+                    band.p90 = in.readFloat();
+                }
+
+                loaded.hasReference = true;
+            }
+            break;
+        }
+
+        case stateTargets:
+        {
+            TargetCurve target;
+            target.hasCorrections = in.readBool();
+            target.hasResiduals = in.readBool();
+
+            if (in.readInt() == numBands)
+            {
+                for (int i = 0; i < numBands; ++i)
+                    target.correctionsDb[(size_t)i] = in.readFloat();
+
+                for (int i = 0; i < numBands; ++i)
+                    target.residualsDb[(size_t)i] = in.readFloat();
+
+                const juce::SpinLock::ScopedLockType lock(targetLock);
+                targetCurve = target;
+            }
+            break;
+        }
+
+        case stateMeasurement:
+        {
+            const int snapshots = in.readInt();
+            const int bins = in.readInt();
+
+            // Auch ohne gültige Daten: geladene (leere) Messung ersetzt die alte
+            loaded.hasMeasurement = true;
+
+            if (snapshots > 0 && bins > 0 && (juce::int64)bins * 12 <= sectionEnd - in.getPosition())
+            {
+                loaded.measurementFrequencies.resize((size_t)bins);
+                loaded.measurementPowerSum.resize((size_t)bins);
+
+                for (auto& f : loaded.measurementFrequencies)
+                    f = in.readFloat();
+
+                for (auto& p : loaded.measurementPowerSum)
+                    p = in.readDouble();
+
+                loaded.measurementSnapshotCount = snapshots;
+            }
+            break;
+        }
+
+        case stateSnapshots:
+        {
+            const int slots = in.readInt();
+
+            if (in.readInt() != numBands)
+                break;
+
+            for (int slot = 0; slot < slots && in.getPosition() < sectionEnd; ++slot)
+            {
+                const bool valid = in.readBool();
+                std::array<float, numBands> gains{}, qs{};
+
+                for (auto& g : gains)
+                    g = in.readFloat();
+
+                for (auto& q : qs)
+                    q = in.readFloat();
+
+                if (valid)
+                {
+                    storeSnapshot(slot, gains, qs);
+                }
+                else if (juce::isPositiveAndBelow(slot, numSnapshots))
+                {
+                    const juce::SpinLock::ScopedLockType lock(snapshotLock);
+                    pendingSnapshots[(size_t)slot].valid = false;
+                    snapshotsChanged = true;
+                }
+            }
+
+            // Geladener State klingt wie seine Parameter
+            setSnapshotCompare(-1, -1, 0.0f);
+            break;
+        }
+
+        default:
+            break; // unbekannte Sektion (neuere Version)
+        }
+
+        in.setPosition(sectionEnd);
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(loadedStateLock);
+        pendingLoadedState = std::move(loaded);
+        loadedStateChanged = true;
+    }
+
+    filtersNeedUpdate.store(true, std::memory_order_release);
+
+    // Auf dem Message-Thread sofort übernehmen, sonst beim nächsten Durchlauf
+    triggerAsyncUpdate();
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        handleUpdateNowIfNeeded();
+}
+
+//==============================================================================
+// Geladenen State übernehmen (Message-Thread). Der Host darf setStateInformation()
+// aus einem beliebigen Thread aufrufen; Editor-Timer und Messung lesen
+// Referenzkurve und Akkumulator aber ohne Lock, deshalb erst hier tauschen.
+void AudioPluginAudioProcessor::handleAsyncUpdate()
+{
+    LoadedState loaded;
+
+    {
+        const juce::SpinLock::ScopedTryLockType lock(loadedStateLock);
+
+        if (!lock.isLocked())
+        {
+            triggerAsyncUpdate(); // Host lädt oder speichert gerade -> später nochmal
+            return;
+        }
+
+        if (!loadedStateChanged)
+            return;
+
+        loaded = std::move(pendingLoadedState);
+        pendingLoadedState = {};
+        loadedStateChanged = false;
+    }
+
+    if (loaded.hasGenre)
+        selectedGenreId = loaded.selectedGenreId;
+
+    if (loaded.hasMeasurement)
+    {
+        measuring.store(false, std::memory_order_release);
+        measurementFrequencies = std::move(loaded.measurementFrequencies);
+        measurementPowerSum = std::move(loaded.measurementPowerSum);
+        measurementSnapshotCount = loaded.measurementSnapshotCount;
+    }
+
+    if (loaded.hasReference)
+    {
+        referenceBands = std::move(loaded.referenceBands);
+        referenceBandsChanged();
+    }
+
+    stateVersion.fetch_add(1, std::memory_order_acq_rel);
 }
 
 //==============================================================================
@@ -592,7 +1538,7 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 void AudioPluginAudioProcessor::startMeasurement()
 {
     // nur Mess/FFT-Teil resetten (Referenz bleibt)
-    measurementBuffer.clear();
+    resetMeasurementAccumulator();
     preEQSpectrumArray.clear();
 
     preEQFifoIndex = 0;
@@ -609,7 +1555,7 @@ void AudioPluginAudioProcessor::startMeasurement()
 void AudioPluginAudioProcessor::stopMeasurement()
 {
     measuring.store(false);
-    DBG("Messung gestoppt - " + juce::String(measurementBuffer.size()) + " Snapshots gesammelt");
+    DBG("Messung gestoppt - " + juce::String(measurementSnapshotCount) + " Snapshots gesammelt");
 }
 
 //==============================================================================
@@ -617,17 +1563,44 @@ void AudioPluginAudioProcessor::stopMeasurement()
 // WICHTIG: Verwendet jetzt preEQSpectrumArray statt spectrumArray!
 void AudioPluginAudioProcessor::addMeasurementSnapshot()
 {
-    if (measuring.load() && !preEQSpectrumArray.empty())
+    const TraceRecorder::Scope traceScope("addMeasurementSnapshot", "analyzer", traceId);
+
+    if (!measuring.load() || preEQSpectrumArray.empty())
+        return;
+
+    // Erster Snapshot (oder geänderte Auflösung) legt die Bins fest
+    if (measurementSnapshotCount == 0 || measurementPowerSum.size() != preEQSpectrumArray.size())
     {
-        measurementBuffer.push_back(preEQSpectrumArray);
+        resetMeasurementAccumulator();
+        measurementFrequencies.resize(preEQSpectrumArray.size());
+        measurementPowerSum.assign(preEQSpectrumArray.size(), 0.0);
+
+        for (size_t i = 0; i < preEQSpectrumArray.size(); ++i)
+            measurementFrequencies[i] = preEQSpectrumArray[i].frequency;
     }
+
+    // Mittelung in der Power-Domain: dB -> Leistung aufsummieren
+    for (size_t i = 0; i < preEQSpectrumArray.size(); ++i)
+        measurementPowerSum[i] += (double)FastMath::dbToPower(preEQSpectrumArray[i].level);
+
+    ++measurementSnapshotCount;
+    performanceCounters.measurementFramesCaptured.fetch_add(1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+// Mess-Akkumulator leeren
+void AudioPluginAudioProcessor::resetMeasurementAccumulator()
+{
+    measurementFrequencies.clear();
+    measurementPowerSum.clear();
+    measurementSnapshotCount = 0;
 }
 
 //==============================================================================
 // Messung löschen
 void AudioPluginAudioProcessor::clearMeasurement()
 {
-    measurementBuffer.clear();
+    resetMeasurementAccumulator();
     measuring = false;
 }
 
@@ -635,15 +1608,14 @@ void AudioPluginAudioProcessor::resetMeasurement()
 {
     // 1) Mess-Logik stoppen & Buffer leeren
     measuring.store(false, std::memory_order_release);
-    measurementBuffer.clear();
+    resetMeasurementAccumulator();
     preEQSpectrumArray.clear();
 
     // 2) Target (grüne gestrichelte Kurve) zurücksetzen / ausblenden
-    targetCorrections.fill(0.0f);
-    hasTargetCorrections.store(false, std::memory_order_release);
-
-    targetResidualsDb.fill(0.0f);
-    hasTargetResiduals = false;
+    {
+        const juce::SpinLock::ScopedLockType lock(targetLock);
+        targetCurve = {};
+    }
 
     // 3) FFT-States (Pre + Post) sauber zurücksetzen
     fifoIndex = 0;
@@ -669,51 +1641,21 @@ AudioPluginAudioProcessor::getAveragedSpectrum() const
 {
     std::vector<SpectrumPoint> averaged;
 
-    if (measurementBuffer.empty())
+    if (measurementSnapshotCount == 0)
         return averaged;
 
-    const size_t numBands = measurementBuffer[0].size();
-    const size_t numSnapshots = measurementBuffer.size();
-
-    averaged.resize(numBands);
+    const size_t numBins = measurementPowerSum.size();
+    averaged.resize(numBins);
 
     constexpr float floorDb = -160.0f;
-    const float floorPower = std::pow(10.0f, floorDb / 10.0f);
 
-    for (size_t band = 0; band < numBands; ++band)
+    for (size_t bin = 0; bin < numBins; ++bin)
     {
-        double powerSum = 0.0;
-        int validCount = 0;
-
-        for (const auto& snapshot : measurementBuffer)
-        {
-            if (band < snapshot.size())
-            {
-                const float db = snapshot[band].level;
-                const double p = std::pow(10.0, (double)db / 10.0);
-
-                powerSum += p;
-                ++validCount;
-            }
-        }
+        averaged[bin].frequency = measurementFrequencies[bin];
 
-        // Frequenz aus erstem Snapshot übernehmen (ist konstant)
-        averaged[band].frequency = measurementBuffer[0][band].frequency;
-
-        // Mittelwert Power-Domain berechnen
-        if (validCount > 0)
-        {
-            const double meanPower = powerSum / (double)validCount;
-
-            if (meanPower <= floorPower)
-                averaged[band].level = floorDb;
-            else
-                averaged[band].level = (float)(10.0 * std::log10(meanPower));
-        }
-        else
-        {
-            averaged[band].level = floorDb;
-        }
+        // Mittelwert Power-Domain berechnen (unter floorDb -> floorDb)
+        const double meanPower = measurementPowerSum[bin] / (double)measurementSnapshotCount;
+        averaged[bin].level = FastMath::powerToDb((float)meanPower, floorDb);
     }
 
     return averaged;
@@ -777,4 +1719,73 @@ void AudioPluginAudioProcessor::loadReferenceCurve(const juce::String& filename)
     }
 
     DBG("Referenzkurve geladen: " + filename + " (" + juce::String(referenceBands.size()) + " Bänder)");
-}
\ No newline at end of file
+}
+
+//==============================================================================
+// Referenzkurve geändert -> p10/median/p90 an den Bandfrequenzen für den
+// adaptiven Modus bereitstellen (Audio-Thread holt sie per TryLock ab)
+void AudioPluginAudioProcessor::referenceBandsChanged()
+{
+    AdaptiveReference ref;
+
+    if (referenceBands.size() >= 2)
+    {
+        for (int i = 0; i < numBands; ++i)
+        {
+            const auto band = interpolateReferenceBand(referenceBands, filterFrequencies[i]);
+            ref.p10[i] = band.p10;
+            ref.median[i] = band.median;
+            ref.p90[i] = band.p90;
+        }
+
+        ref.valid = true;
+    }
+
+    ++referenceBandsVersion;
+
+    const juce::SpinLock::ScopedLockType lock(adaptiveReferenceLock);
+    pendingAdaptiveReference = ref;
+    adaptiveReferenceChanged = true;
+}
+
+//==============================================================================
+// Zielkurve: Editor, Auto-EQ und State-Laden schreiben, Editor und State-Speichern
+// lesen - jeweils als Ganzes unter targetLock, damit nie halbe Kurven sichtbar werden
+AudioPluginAudioProcessor::TargetCurve AudioPluginAudioProcessor::getTargetCurve() const
+{
+    const juce::SpinLock::ScopedLockType lock(targetLock);
+    return targetCurve;
+}
+
+void AudioPluginAudioProcessor::setTargetCorrections(const std::array<float, 31>& correctionsDb)
+{
+    const juce::SpinLock::ScopedLockType lock(targetLock);
+    targetCurve.correctionsDb = correctionsDb;
+    targetCurve.hasCorrections = true;
+}
+
+void AudioPluginAudioProcessor::setTargetResiduals(const std::array<float, 31>& residualsDb)
+{
+    const juce::SpinLock::ScopedLockType lock(targetLock);
+    targetCurve.residualsDb = residualsDb;
+    targetCurve.hasResiduals = true;
+}
+
+void AudioPluginAudioProcessor::setTargetPoint(int band, float db)
+{
+    if (!juce::isPositiveAndBelow(band, numBands))
+        return;
+
+    const juce::SpinLock::ScopedLockType lock(targetLock);
+
+    if (targetCurve.hasResiduals)
+        targetCurve.residualsDb[(size_t)band] = db;
+    else if (targetCurve.hasCorrections)
+        targetCurve.correctionsDb[(size_t)band] = db;
+}
+
+void AudioPluginAudioProcessor::clearTargetCorrections()
+{
+    const juce::SpinLock::ScopedLockType lock(targetLock);
+    targetCurve.hasCorrections = false;
+}
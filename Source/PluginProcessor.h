@@ -3,6 +3,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include <atomic>
+#include "PerformanceCounters.h"
+#include "TraceRecorder.h"
 
 namespace DisplayScale
 {
@@ -14,7 +16,8 @@ namespace DisplayScale
 // Hauptklasse des Plugins
 // Enthlt EQ-Filter (31-Band), FFT-basiertes Spektrum und Parameterverwaltung
 class AudioPluginAudioProcessor final : public juce::AudioProcessor,
-    private juce::AudioProcessorValueTreeState::Listener
+    private juce::AudioProcessorValueTreeState::Listener,
+    private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -62,9 +65,15 @@ public:
 
     //==============================================================================
     // State Management (Speichern / Laden von Parametern)
+    // Kompaktes, versioniertes Binrformat: Parameter, Genre, Referenzkurve,
+    // Zielkurven und Mess-Akkumulator (siehe PluginProcessor.cpp)
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    // Wird erhht, sobald der Message-Thread einen geladenen State bernommen hat
+    // (Editor synchronisiert daran)
+    juce::uint32 getStateVersion() const noexcept { return stateVersion.load(std::memory_order_acquire); }
+
     //==============================================================================
     // Zugriff auf Spektrum-Daten (Post-EQ fr Anzeige)
     void getNextScopeData(float* destBuffer, int numPoints);
@@ -104,18 +113,38 @@ public:
     //==============================================================================
     // Persistente Daten fr Referenz- und Differenzkurve
     std::vector<ReferenceBand> referenceBands;           // Referenzkurve
-    std::array<float, 31> targetCorrections;             // Berechnete Korrekturen
-    std::atomic<bool> hasTargetCorrections{ false };
     int selectedGenreId = 0;                             // Ausgewhltes Genre im Dropdown
 
     // ==== Target-Visualisierung (31 Punkte) ====
-    // Das ist die "Zielkurve" als 31 Residual-Punkte (ohne Filter-Response / ohne Ripple)
-    std::array<float, 31> targetResidualsDb{};
-    bool hasTargetResiduals = false;
+    struct TargetCurve
+    {
+        std::array<float, 31> correctionsDb{};  // Berechnete Korrekturen (gefittete Slider-Gains)
+        std::array<float, 31> residualsDb{};    // "Zielkurve" als Residual-Punkte (ohne Filter-Response / ohne Ripple)
+        bool hasCorrections = false;
+        bool hasResiduals = false;
+
+        // Angezeigt werden die Residuen, falls vorhanden, sonst die Korrekturen
+        bool isVisible() const noexcept { return hasResiduals || hasCorrections; }
+        const std::array<float, 31>& shownDb() const noexcept { return hasResiduals ? residualsDb : correctionsDb; }
+    };
+
+    // Zugriff auf die Zielkurve nur ber diese Funktionen (beliebiger Thread, unter targetLock)
+    TargetCurve getTargetCurve() const;
+    void setTargetCorrections(const std::array<float, 31>& correctionsDb);
+    void setTargetResiduals(const std::array<float, 31>& residualsDb);
+    void setTargetPoint(int band, float db);             // verschiebt einen Punkt der angezeigten Kurve
+    void clearTargetCorrections();
 
     // Referenzkurve laden
     void loadReferenceCurve(const juce::String& filename);
 
+    // Muss nach jeder nderung von referenceBands aufgerufen werden
+    // (bergibt das p10/p90-Fenster an den adaptiven Modus im Audio-Thread)
+    void referenceBandsChanged();
+
+    // Wird bei jedem referenceBandsChanged() erhht (Editor cached daran seine Pfade)
+    juce::uint32 getReferenceBandsVersion() const noexcept { return referenceBandsVersion; }
+
     //==============================================================================
     // Parameterverwaltung
     juce::AudioProcessorValueTreeState apvts;
@@ -123,6 +152,9 @@ public:
 
     void resetAllBandsToDefault();
 
+    // Mittenfrequenzen der 31 Bnder (fr Auto-EQ auerhalb des Editors)
+    const std::array<float, 31>& getFilterFrequencies() const noexcept { return filterFrequencies; }
+
     //==============================================================================
     // Messung / Spektrum-Aufnahme
     void startMeasurement();
@@ -130,12 +162,39 @@ public:
     void addMeasurementSnapshot();
     bool isMeasuring() const { return measuring.load(); }
 
-    // Gespeicherte Spektrum-Daten abrufen
-    const std::vector<std::vector<SpectrumPoint>>& getMeasurementBuffer() const { return measurementBuffer; }
+    // Gemitteltes Spektrum der bisherigen Messung abrufen
     std::vector<SpectrumPoint> getAveragedSpectrum() const;
+    int getMeasurementSnapshotCount() const noexcept { return measurementSnapshotCount; }
     void clearMeasurement();
 
+    //==============================================================================
+    // EQ-Snapshots (A/B-Vergleich und Morphing)
+    // Jeder Slot hlt Gains/Qs und fertige Koeffizienten fr die aktuelle Samplerate.
+    // Umschalten ist im Audio-Thread ein Zeigertausch, Morphen interpoliert die
+    // Koeffizienten im Sub-Block-Raster. Ein- und Ausschalten des Vergleichs wird
+    // von den Parametern aus bergeblendet. Die Parameter bleiben dabei unverndert,
+    // erst applySnapshotToParameters() bernimmt einen Slot.
+    static constexpr int numSnapshots = 4;
+
+    void storeSnapshot(int slot);                                 // aktuelle Parameter
+    void storeSnapshot(int slot, const std::array<float, 31>& gainsDb, const std::array<float, 31>& qs);
+    bool hasSnapshot(int slot) const;
+    void setSnapshotCompare(int slotA, int slotB, float morph);  // slotA < 0 -> live Parameter
+    int getSnapshotCompareSlot() const noexcept { return snapshotCompareA.load(std::memory_order_relaxed); }
+    float getSnapshotMorph() const noexcept { return snapshotMorphTarget.load(std::memory_order_relaxed); }
+    void applySnapshotToParameters(int slot);
+
+    //==============================================================================
+    // Lock-freie Laufzeitzhler (Performance-HUD)
+    PerformanceCounters& getPerformanceCounters() noexcept { return performanceCounters; }
+
+    // Nummer dieser Instanz in Trace-Events (TraceRecorder)
+    int getTraceId() const noexcept { return traceId; }
+
 private:
+    PerformanceCounters performanceCounters;
+    const int traceId = TraceRecorder::createInstanceId();
+
     //==============================================================================
     // Parameter-Layout erstellen (31-Band EQ)
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -148,9 +207,37 @@ private:
 
     //==============================================================================
     // Messungs-Speicher
-    std::vector<std::vector<SpectrumPoint>> measurementBuffer;  // Alle Snapshots whrend Messung
+    // Statt aller Snapshots wird nur die Leistungssumme je Bin gehalten: konstanter
+    // Speicher, O(Bins) pro Snapshot und direkt im Plugin-State speicherbar.
+    std::vector<float> measurementFrequencies;                  // Frequenz je Bin (Hz)
+    std::vector<double> measurementPowerSum;                    // Summe der Leistungen je Bin
+    int measurementSnapshotCount = 0;                           // Anzahl aufsummierter Snapshots
     std::atomic<bool> measuring{ false };                       // Flag ob Messung aktiv ist
 
+    void resetMeasurementAccumulator();
+
+    std::atomic<juce::uint32> stateVersion{ 0 };
+
+    // Von setStateInformation() geladen (beliebiger Thread), vom Message-Thread
+    // in handleAsyncUpdate() bernommen: Referenzkurve, Messung und Genre
+    struct LoadedState
+    {
+        std::vector<ReferenceBand> referenceBands;
+        std::vector<float> measurementFrequencies;
+        std::vector<double> measurementPowerSum;
+        int measurementSnapshotCount = 0;
+        int selectedGenreId = 0;
+        bool hasGenre = false;
+        bool hasReference = false;
+        bool hasMeasurement = false;
+    };
+
+    LoadedState pendingLoadedState;                             // geschtzt durch loadedStateLock
+    juce::SpinLock loadedStateLock;
+    bool loadedStateChanged = false;                            // geschtzt durch loadedStateLock
+
+    void handleAsyncUpdate() override;
+
     // Festgelegte Filterfrequenzen fr 31 Bnder
     const std::array<float, numBands> filterFrequencies = {
         20.0f, 25.0f, 31.5f, 40.0f, 50.0f, 63.0f, 80.0f, 100.0f,
@@ -164,6 +251,64 @@ private:
 
     std::atomic<bool> filtersNeedUpdate{ true };
 
+    //==============================================================================
+    // Filter-Koeffizienten (werden im Audio-Thread ohne Allokation aktualisiert)
+    using Coefficients = juce::dsp::IIR::Coefficients<float>;
+    std::array<Coefficients::Ptr, numBands> bandCoefficients;  // geteilt von L/R-Filtern
+    std::array<float, numBands> bandSinW0{};                   // sin(w0) pro Band (je Samplerate)
+    std::array<float, numBands> bandCosW0{};                   // cos(w0) pro Band (je Samplerate)
+    double currentSampleRate = 0.0;
+
+    void prepareBandCoefficients(double sampleRate);
+    void setBandCoefficients(int band, float gainDb, float Q) noexcept;
+    void processEQ(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    // Direkte Parameter-Zeiger (kein String-Lookup im Audio-Thread)
+    std::array<std::atomic<float>*, numBands> bandGainParams{};
+    std::array<std::atomic<float>*, numBands> bandQParams{};
+    std::atomic<float>* inputGainParam = nullptr;
+    std::atomic<float>* adaptiveModeParam = nullptr;
+
+    // Zuletzt angewendete Parameterwerte (Basis fr die adaptiven Rampen)
+    std::array<float, numBands> appliedGainDb{};
+    std::array<float, numBands> appliedQ{};
+
+    //==============================================================================
+    // EQ-Snapshots
+    struct EQSnapshot
+    {
+        std::array<float, numBands> gainDb{};
+        std::array<float, numBands> q{};
+        std::array<float, numBands * 5> coefficients{};  // b0, b1, b2, a1, a2 je Band
+        bool valid = false;
+    };
+
+    TargetCurve targetCurve;                                // geschtzt durch targetLock
+    mutable juce::SpinLock targetLock;
+
+    std::array<EQSnapshot, numSnapshots> pendingSnapshots;  // Message-Thread, Koeffizienten unter snapshotLock
+    juce::SpinLock snapshotLock;
+    bool snapshotsChanged = false;                          // geschtzt durch snapshotLock
+
+    // Kopie fr den Audio-Thread: eigene Koeffizienten-Objekte je Slot und Band
+    std::array<std::array<Coefficients::Ptr, numBands>, numSnapshots> snapshotCoefficients;
+    std::array<bool, numSnapshots> snapshotValid{};
+
+    std::atomic<int> snapshotCompareA{ -1 };
+    std::atomic<int> snapshotCompareB{ -1 };
+    std::atomic<float> snapshotMorphTarget{ 0.0f };
+    float snapshotMorph = 0.0f;                             // Audio-Thread (gerampt)
+    float snapshotBlend = 0.0f;                             // Audio-Thread: 0 = Parameter, 1 = Snapshots (gerampt)
+    bool comparingSnapshots = false;                        // Audio-Thread: Vergleich gewnscht
+    int activeCompareA = -1;                                // Audio-Thread: Slots, gelten auch beim Ausblenden
+    int activeCompareB = -1;
+    int filterCoefficientSource = -1;                       // -1 = bandCoefficients, sonst Slot
+
+    void computeSnapshotCoefficients(EQSnapshot& snapshot) const noexcept;
+    bool updateSnapshotRouting() noexcept;
+    void stepSnapshotMorph(int numSamples) noexcept;
+    void pointFiltersAt(int source) noexcept;
+
     //==============================================================================
     // FFT / Spectrum Analyzer (Post-EQ fr Anzeige)
     enum {
@@ -189,5 +334,41 @@ private:
     int preEQFifoIndex = 0;                           // Index fr Pre-EQ FIFO
     std::atomic<bool> nextPreEQFFTBlockReady{ false };
 
+    //==============================================================================
+    // Adaptiver Referenz-Tracking-Modus
+    // Hlt den Kurzzeitpegel jedes Bands (Post-EQ) im p10..p90-Fenster der Referenz,
+    // indem zustzliche Band-Gains langsam und ratenbegrenzt nachgefhrt werden.
+    struct AdaptiveReference
+    {
+        std::array<float, numBands> p10{};
+        std::array<float, numBands> median{};
+        std::array<float, numBands> p90{};
+        bool valid = false;
+    };
+
+    AdaptiveReference pendingAdaptiveReference;       // vom Message-Thread geschrieben
+    AdaptiveReference adaptiveReference;              // Kopie fr den Audio-Thread
+    juce::SpinLock adaptiveReferenceLock;
+    bool adaptiveReferenceChanged = false;            // geschtzt durch adaptiveReferenceLock
+    juce::uint32 referenceBandsVersion = 0;           // nur Message-Thread
+
+    juce::dsp::FFT adaptiveFFT;                       // Bandpegel-Analyse (Audio-Thread)
+    juce::dsp::WindowingFunction<float> adaptiveWindow;
+    float adaptiveFifo[fftSize];                      // Post-EQ Mono, 50% Overlap
+    float adaptiveFftData[2 * fftSize];
+    int adaptiveFifoIndex = 0;
+    std::array<int, numBands> adaptiveBinLo{};        // FFT-Bins je Band (je Samplerate)
+    std::array<int, numBands> adaptiveBinHi{};
+
+    std::array<float, numBands> adaptiveLevelDb{};    // Kurzzeitpegel je Band
+    bool adaptiveLevelsPrimed = false;
+    std::array<float, numBands> adaptiveTargetDb{};   // Sollwert des Reglers
+    std::array<float, numBands> adaptiveGainDb{};     // aktuell angewendet (gerampt)
+
+    void pushNextSampleIntoAdaptiveFifo(float sample) noexcept;
+    void runAdaptiveAnalysis() noexcept;
+    bool rampAdaptiveGains(int numSamples) noexcept;
+    bool isAdaptiveIdle() const noexcept;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
 };
\ No newline at end of file
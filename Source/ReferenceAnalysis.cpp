@@ -0,0 +1,376 @@
+﻿#include "ReferenceAnalysis.h"
+#include "CurveMath.h"
+#include "FastMath.h"
+#include "TraceRecorder.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
+#include <cstring>
+
+namespace ReferenceAnalysis
+{
+    using CurveMath::smoothMovingAverage;
+
+    void postProcessReferenceBands(std::vector<AudioPluginAudioProcessor::ReferenceBand>& bands)
+    {
+        if (bands.size() < 3) return;
+
+        std::vector<float> p10, med, p90;
+        p10.reserve(bands.size());
+        med.reserve(bands.size());
+        p90.reserve(bands.size());
+
+        for (auto& b : bands)
+        {
+            p10.push_back(b.p10);
+            med.push_back(b.median);
+            p90.push_back(b.p90);
+        }
+
+        p10 = smoothMovingAverage(p10, 5, 2);
+        med = smoothMovingAverage(med, 5, 2);
+        p90 = smoothMovingAverage(p90, 5, 2);
+
+        constexpr float kSpreadShrink = 0.55f;
+        constexpr float kMaxBandWidthDb = 6.0f;
+        constexpr float kMinBandWidthDb = 1.0f;
+
+        for (size_t i = 0; i < bands.size(); ++i)
+        {
+            const float m = med[i];
+
+            float lo = m - kSpreadShrink * (m - p10[i]);
+            float hi = m + kSpreadShrink * (p90[i] - m);
+
+            float w = hi - lo;
+            if (w > kMaxBandWidthDb)
+            {
+                lo = m - 0.5f * kMaxBandWidthDb;
+                hi = m + 0.5f * kMaxBandWidthDb;
+            }
+            else if (w < kMinBandWidthDb)
+            {
+                lo = m - 0.5f * kMinBandWidthDb;
+                hi = m + 0.5f * kMinBandWidthDb;
+            }
+
+            if (lo > m) lo = m;
+            if (hi < m) hi = m;
+
+            bands[i].p10 = lo;
+            bands[i].median = m;
+            bands[i].p90 = hi;
+        }
+    }
+
+    /**
+     * @brief Analysiert einen Referenztrack offline.
+     *
+     * Mono-Summe, 4096er FFT mit 50% Overlap; pro Terzband werden die
+     * dB-Werte aller Frames gesammelt und daraus Perzentile gebildet.
+     *
+     * @param f     Audiodatei
+     * @param stats Optional: Zeiten je Stufe und Speicherbedarf (nullptr = keine Messung)
+     * @param shouldCancel Optional: true bricht die Analyse ab (vor jedem Block geprüft)
+     * @return Referenzbänder (leer wenn die Datei nicht lesbar ist oder abgebrochen wurde)
+     */
+    std::vector<AudioPluginAudioProcessor::ReferenceBand> analyseFile(const juce::File& f, AnalysisStats* stats,
+        const ShouldCancel& shouldCancel)
+    {
+        const TraceRecorder::Scope traceScope("analyseFile", "reference");
+
+        std::vector<AudioPluginAudioProcessor::ReferenceBand> out;
+
+        juce::AudioFormatManager fm;
+        fm.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(fm.createReaderFor(f));
+        if (!reader)
+            return out;
+
+        const double sr = reader->sampleRate > 0.0 ? reader->sampleRate : 48000.0;
+        const juce::int64 totalSamples = reader->lengthInSamples;
+        const int numCh = (int)reader->numChannels;
+
+        // Stufen-Zeitmessung nur mit stats (sonst kein Timer-Aufruf)
+        juce::int64 stageTicks = 0;
+        auto startStage = [&]
+            {
+                if (stats != nullptr)
+                    stageTicks = juce::Time::getHighResolutionTicks();
+            };
+
+        auto endStage = [&](double AnalysisStats::* seconds)
+            {
+                if (stats == nullptr)
+                    return;
+
+                const auto now = juce::Time::getHighResolutionTicks();
+                stats->*seconds += juce::Time::highResolutionTicksToSeconds(now - stageTicks);
+                stageTicks = now;
+            };
+
+        startStage();
+
+        // FFT-Settings (offline)
+        constexpr int fftOrder = 12;               // 4096
+        constexpr int fftSize = 1 << fftOrder;
+        constexpr int hopSize = fftSize / 2;      // 50% overlap
+
+        juce::dsp::FFT fft(fftOrder);
+        juce::dsp::WindowingFunction<float> win(fftSize, juce::dsp::WindowingFunction<float>::hann);
+
+        std::vector<float> mono((size_t)fftSize, 0.0f);
+        std::vector<float> fftData((size_t)2 * fftSize, 0.0f);
+
+        // Wir sammeln pro EQ-Band viele dB-Werte -> später P10/Median/P90
+        constexpr float bandFreqs[31] =
+        {
+            20, 25, 31.5f, 40, 50, 63, 80, 100, 125, 160,
+            200, 250, 315, 400, 500, 630, 800, 1000, 1250, 1600,
+            2000, 2500, 3150, 4000, 5000, 6300, 8000, 10000, 12500, 16000, 20000
+        };
+
+        std::array<std::vector<float>, 31> bandDbValues;
+        for (auto& v : bandDbValues) v.reserve(4096);
+
+        auto percentile = [](std::vector<float>& v, float p)
+            {
+                if (v.empty()) return DisplayScale::minDb;
+                std::sort(v.begin(), v.end());
+                const float pos = p * (float)(v.size() - 1);
+                const int i0 = (int)std::floor(pos);
+                const int i1 = (int)std::ceil(pos);
+                if (i0 == i1) return v[(size_t)i0];
+                const float t = pos - (float)i0;
+                return v[(size_t)i0] + t * (v[(size_t)i1] - v[(size_t)i0]);
+            };
+
+        auto hzToBin = [&](float hz)
+            {
+                const int bin = (int)std::round(hz * (float)fftSize / (float)sr);
+                return juce::jlimit(0, fftSize / 2, bin);
+            };
+
+        // Bandbreite 1/3 Okt: Grenzen = f * 2^(±1/6)
+        const float bandEdge = std::pow(2.0f, 1.0f / 6.0f);
+
+        juce::AudioBuffer<float> temp(numCh, (int)juce::jmin<juce::int64>(totalSamples, fftSize));
+
+        juce::int64 readPos = 0;
+        std::vector<float> overlap((size_t)fftSize, 0.0f);
+        bool haveOverlap = false;
+
+        while (readPos < totalSamples)
+        {
+            if (shouldCancel && shouldCancel())
+                return {};
+
+            const int toRead = (int)juce::jmin<juce::int64>((juce::int64)hopSize, totalSamples - readPos);
+            temp.setSize(numCh, toRead, false, false, true);
+            startStage();
+
+            reader->read(&temp, 0, toRead, readPos, true, true);
+            endStage(&AnalysisStats::decodeSeconds);
+
+            // frame bauen (overlap-add)
+            if (!haveOverlap)
+            {
+                std::fill(overlap.begin(), overlap.end(), 0.0f);
+                haveOverlap = true;
+            }
+
+            // shift left um hopSize
+            std::memmove(overlap.data(), overlap.data() + hopSize, sizeof(float) * (fftSize - hopSize));
+
+            // hinten neue Samples rein (mono)
+            for (int i = 0; i < hopSize; ++i)
+            {
+                float s = 0.0f;
+                if (i < toRead)
+                {
+                    for (int ch = 0; ch < numCh; ++ch)
+                        s += temp.getSample(ch, i);
+                    s /= (float)juce::jmax(1, numCh);
+                }
+                overlap[(size_t)(fftSize - hopSize + i)] = s;
+            }
+            endStage(&AnalysisStats::monoSumSeconds);
+
+            // window + FFT input
+            std::copy(overlap.begin(), overlap.end(), mono.begin());
+            win.multiplyWithWindowingTable(mono.data(), fftSize);
+
+            std::fill(fftData.begin(), fftData.end(), 0.0f);
+            std::copy(mono.begin(), mono.end(), fftData.begin());
+            endStage(&AnalysisStats::windowSeconds);
+
+            fft.performFrequencyOnlyForwardTransform(fftData.data());
+            endStage(&AnalysisStats::fftSeconds);
+
+            // pro Band: mags im Bandbereich mitteln -> dB speichern
+            for (int b = 0; b < 31; ++b)
+            {
+                const float f0 = bandFreqs[b];
+                const float fLo = juce::jmax(20.0f, f0 / bandEdge);
+                const float fHi = juce::jmin(20000.0f, f0 * bandEdge);
+
+                const int binLo = hzToBin(fLo);
+                const int binHi = hzToBin(fHi);
+
+                float sum = 0.0f;
+                int cnt = 0;
+
+                for (int k = binLo; k <= binHi; ++k)
+                {
+                    sum += fftData[(size_t)k];
+                    ++cnt;
+                }
+
+                const float magRaw = (cnt > 0) ? (sum / (float)cnt) : 0.0f;
+
+                // Normalisierung: JUCE FFT Magnitude ist größenabhängig.
+                // Sehr brauchbarer Start: auf fftSize skalieren (single-sided grob: *2/fftSize)
+                const float mag = magRaw * (2.0f / (float)fftSize);
+
+                const float db = FastMath::gainToDb(mag, DisplayScale::minDb);
+                bandDbValues[b].push_back(juce::jlimit(DisplayScale::minDb, 0.0f, db));
+            }
+            endStage(&AnalysisStats::bandSeconds);
+
+            readPos += toRead;
+        }
+
+        if (stats != nullptr)
+        {
+            stats->numSamples = totalSamples;
+            stats->numChannels = numCh;
+            stats->sampleRate = sr;
+            stats->numFrames = bandDbValues[0].empty() ? 0 : (int)bandDbValues[0].size();
+            stats->bandValueBytes = 0;
+
+            for (const auto& v : bandDbValues)
+                stats->bandValueBytes += v.capacity() * sizeof(float);
+        }
+
+        out.reserve(31);
+        for (int b = 0; b < 31; ++b)
+        {
+            auto v = std::move(bandDbValues[b]);
+
+            AudioPluginAudioProcessor::ReferenceBand band;
+            band.freq = bandFreqs[b];
+            band.p10 = percentile(v, 0.20f);
+            band.median = percentile(v, 0.50f);
+            band.p90 = percentile(v, 0.80f);
+            out.push_back(band);
+        }
+        {
+            const int windowSize = 5;
+            const int passes = 2;
+
+            std::vector<float> med;
+            med.reserve(out.size());
+            for (const auto& b : out)
+                med.push_back(b.median);
+
+            auto smooth = [&](std::vector<float> v)
+                {
+                    if ((int)v.size() < 3 || windowSize < 3) return v;
+
+                    std::vector<float> cur = v;
+                    std::vector<float> tmp(v.size());
+                    const int half = windowSize / 2;
+
+                    for (int pass = 0; pass < passes; ++pass)
+                    {
+                        for (int i = 0; i < (int)cur.size(); ++i)
+                        {
+                            double sum = 0.0;
+                            int cnt = 0;
+                            for (int j = -half; j <= half; ++j)
+                            {
+                                const int idx = i + j;
+                                if (idx >= 0 && idx < (int)cur.size())
+                                {
+                                    sum += cur[(size_t)idx];
+                                    ++cnt;
+                                }
+                            }
+                            tmp[(size_t)i] = (cnt > 0) ? (float)(sum / (double)cnt) : cur[(size_t)i];
+                        }
+                        cur.swap(tmp);
+                    }
+                    return cur;
+                };
+
+            auto medSmoothed = smooth(med);
+
+            for (size_t i = 0; i < out.size(); ++i)
+                out[i].median = medSmoothed[i];
+        }
+
+        {
+            constexpr float targetMidMedianDb = -60.0f;
+
+            std::vector<float> mids;
+            mids.reserve(out.size());
+
+            for (const auto& b : out)
+                if (b.freq >= 50.0f && b.freq <= 10000.0f)
+                    mids.push_back(b.median);
+
+            if (!mids.empty())
+            {
+                std::sort(mids.begin(), mids.end());
+                const float midMedian = mids[mids.size() / 2];
+
+                const float shift = targetMidMedianDb - midMedian;
+
+                for (auto& b : out)
+                {
+                    b.p10 += shift;
+                    b.median += shift;
+                    b.p90 += shift;
+                }
+            }
+        }
+        postProcessReferenceBands(out);
+        endStage(&AnalysisStats::percentileSeconds);
+
+        return out;
+    }
+
+    const std::array<Genre, 8>& getGenres()
+    {
+        static const std::array<Genre, 8> genres = { {
+            { 1, "Pop",     "Pop_Referenz.json" },
+            { 2, "HipHop",  "HipHop_Referenz.json" },
+            { 3, "Jazz",    "Jazz_Referenz.json" },
+            { 4, "Klassik", "Klassik_Referenz.json" },
+            { 5, "Metal",   "Metal_Referenz.json" },
+            { 6, "RnB",     "RnB_Referenz.json" },
+            { 7, "Rock",    "Rock_Referenz.json" },
+            { 8, "EDM",     "TechHouse_Referenz.json" }
+        } };
+
+        return genres;
+    }
+
+    const Genre* findGenre(const juce::String& name)
+    {
+        for (const auto& genre : getGenres())
+            if (name.equalsIgnoreCase(genre.name))
+                return &genre;
+
+        return nullptr;
+    }
+
+    const Genre* findGenre(int id)
+    {
+        for (const auto& genre : getGenres())
+            if (genre.id == id)
+                return &genre;
+
+        return nullptr;
+    }
+}
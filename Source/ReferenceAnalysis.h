@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include "PluginProcessor.h"
+#include <array>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+// Referenzkurven aus Audiodateien und Genre-Vorlagen
+//
+// Wird vom Editor (Referenz laden / Genre-Auswahl) und von den Offline-Tools
+// genutzt, damit beide exakt die gleiche Kurve erzeugen.
+namespace ReferenceAnalysis
+{
+    // Optionale Laufzeit-Aufschlüsselung von analyseFile() (für Benchmarks).
+    // Zeiten in Sekunden, summiert über alle Frames.
+    struct AnalysisStats
+    {
+        double decodeSeconds = 0.0;
+        double monoSumSeconds = 0.0;
+        double windowSeconds = 0.0;
+        double fftSeconds = 0.0;
+        double bandSeconds = 0.0;        // Bins -> Terzband-dB
+        double percentileSeconds = 0.0;  // Sortieren, Glätten, Normieren
+
+        juce::int64 numSamples = 0;
+        int numChannels = 0;
+        double sampleRate = 0.0;
+        int numFrames = 0;
+        size_t bandValueBytes = 0;       // Spitzenbedarf der gesammelten Band-dB-Werte
+    };
+
+    // Abbruch-Abfrage für Hintergrund-Jobs, wird zwischen den Dekodier-Blöcken aufgerufen
+    using ShouldCancel = std::function<bool()>;
+
+    // Analysiert einen Referenztrack: pro Terzband p10/Median/p90 über alle Frames,
+    // auf -60 dB Mitten-Median normiert und geglättet. Leer bei Lesefehler oder Abbruch.
+    std::vector<AudioPluginAudioProcessor::ReferenceBand> analyseFile(const juce::File& file,
+        AnalysisStats* stats = nullptr, const ShouldCancel& shouldCancel = {});
+
+    // Glättet die Kurve und begrenzt die p10/p90-Spreizung (für Genre-JSONs und Tracks)
+    void postProcessReferenceBands(std::vector<AudioPluginAudioProcessor::ReferenceBand>& bands);
+
+    // Genre-Vorlagen (IDs wie im Genre-Dropdown)
+    struct Genre
+    {
+        int id;
+        const char* name;
+        const char* fileName;
+    };
+
+    const std::array<Genre, 8>& getGenres();
+
+    // Genre per Name suchen (ohne Groß-/Kleinschreibung); nullptr wenn unbekannt
+    const Genre* findGenre(const juce::String& name);
+    const Genre* findGenre(int id);
+}
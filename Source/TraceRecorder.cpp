@@ -0,0 +1,260 @@
+﻿#include "TraceRecorder.h"
+#include <juce_events/juce_events.h>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+    // Seqlock je Event: 0 = wird gerade geschrieben, sonst Schreibindex + 1
+    struct Event
+    {
+        std::atomic<juce::uint64> sequence{ 0 };
+        const char* name = nullptr;
+        const char* category = nullptr;
+        juce::int64 startTicks = 0;
+        juce::int64 endTicks = 0;
+        int instance = -1;
+    };
+
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Event[]> events;
+        std::atomic<juce::uint64> writeIndex{ 0 };
+        std::atomic<bool> claimed{ false };
+        char label[48] = {};     // vom Besitzer-Thread beim Belegen geschrieben
+    };
+
+    std::atomic<bool> recording{ false };
+    std::atomic<int> activeWriters{ 0 };         // Threads gerade in record(), start() wartet darauf
+    std::atomic<juce::uint32> generation{ 0 };   // je start() neu, Threads belegen dann neu
+    std::atomic<int> numClaimed{ 0 };
+    std::atomic<juce::uint64> droppedEvents{ 0 };
+    std::atomic<int> nextInstanceId{ 1 };
+
+    ThreadBuffer buffers[TraceRecorder::maxThreads];
+    int eventsPerBuffer = 0;                     // nur in start() gesetzt
+    juce::int64 recordingStartTicks = 0;
+    std::mutex controlMutex;                     // start/stop/Export untereinander
+
+    thread_local int threadSlot = -1;
+    thread_local juce::uint32 threadGeneration = 0;
+
+    // Name für die Thread-Spur: JUCE-Threadname, Message-Thread oder die
+    // Kategorie des ersten Events (z.B. "audio" für den Host-Audio-Thread).
+    // Ohne String-Temporaries, das erste Event kann vom Audio-Thread kommen.
+    void writeThreadLabel(ThreadBuffer& buffer, const char* category)
+    {
+        auto& label = buffer.label;
+
+        if (auto* mm = juce::MessageManager::getInstanceWithoutCreating(); mm != nullptr && mm->isThisTheMessageThread())
+            std::strncpy(label, "Message Thread", sizeof(label) - 1);
+        else if (auto* thread = juce::Thread::getCurrentThread())
+            thread->getThreadName().copyToUTF8(label, sizeof(label));
+        else
+            std::strncpy(label, category, sizeof(label) - 1);
+    }
+
+    int claimSlot(const char* category) noexcept
+    {
+        const int slot = numClaimed.fetch_add(1, std::memory_order_relaxed);
+        if (slot >= TraceRecorder::maxThreads)
+            return TraceRecorder::maxThreads;
+
+        auto& buffer = buffers[slot];
+        writeThreadLabel(buffer, category);
+        buffer.claimed.store(true, std::memory_order_release);
+        return slot;
+    }
+
+    juce::String escapeJson(const juce::String& text)
+    {
+        return text.replace("\\", "\\\\").replace("\"", "\\\"");
+    }
+}
+
+namespace TraceRecorder
+{
+    //==============================================================================
+    void start(int eventsPerThread)
+    {
+        const std::lock_guard<std::mutex> lock(controlMutex);
+
+        // Aufnahme sperren und Schreiber abwarten, die recording noch als true
+        // gesehen haben: erst dann gehört kein Puffer mehr einem alten Thread.
+        // seq_cst paart sich mit record(): entweder sieht start() den Zähler
+        // oder der Schreiber sieht recording == false.
+        recording.store(false, std::memory_order_seq_cst);
+
+        while (activeWriters.load(std::memory_order_seq_cst) != 0)
+            juce::Thread::yield();
+
+        if (eventsPerBuffer == 0)
+        {
+            eventsPerBuffer = juce::jmax(1024, eventsPerThread);
+
+            for (auto& buffer : buffers)
+                buffer.events = std::make_unique<Event[]>((size_t)eventsPerBuffer);
+        }
+
+        for (auto& buffer : buffers)
+        {
+            buffer.claimed.store(false, std::memory_order_relaxed);
+            buffer.writeIndex.store(0, std::memory_order_relaxed);
+
+            for (int i = 0; i < eventsPerBuffer; ++i)
+                buffer.events[(size_t)i].sequence.store(0, std::memory_order_relaxed);
+        }
+
+        numClaimed.store(0, std::memory_order_relaxed);
+        droppedEvents.store(0, std::memory_order_relaxed);
+        recordingStartTicks = juce::Time::getHighResolutionTicks();
+
+        generation.fetch_add(1, std::memory_order_release);
+        recording.store(true, std::memory_order_release);
+    }
+
+    void stop() noexcept
+    {
+        recording.store(false, std::memory_order_release);
+    }
+
+    bool isRecording() noexcept
+    {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    juce::uint64 getNumDroppedEvents() noexcept
+    {
+        return droppedEvents.load(std::memory_order_relaxed);
+    }
+
+    int createInstanceId() noexcept
+    {
+        return nextInstanceId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    void record(const char* name, const char* category, juce::int64 startTicks, juce::int64 endTicks,
+        int instance) noexcept
+    {
+        if (!recording.load(std::memory_order_relaxed))
+            return;
+
+        // Als Schreiber anmelden und erneut prüfen (Gegenstück in start())
+        struct WriterGuard
+        {
+            WriterGuard() noexcept { activeWriters.fetch_add(1, std::memory_order_seq_cst); }
+            ~WriterGuard() { activeWriters.fetch_sub(1, std::memory_order_release); }
+        } writerGuard;
+
+        if (!recording.load(std::memory_order_seq_cst))
+            return;
+
+        // Erstes Event dieses Threads seit start(): eigenen Puffer belegen
+        const auto currentGeneration = generation.load(std::memory_order_acquire);
+        if (threadGeneration != currentGeneration)
+        {
+            threadSlot = claimSlot(category);
+            threadGeneration = currentGeneration;
+        }
+
+        if (threadSlot >= maxThreads)
+        {
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto& buffer = buffers[threadSlot];
+        const auto index = buffer.writeIndex.load(std::memory_order_relaxed);
+        auto& e = buffer.events[(size_t)(index % (juce::uint64)eventsPerBuffer)];
+
+        e.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        e.name = name;
+        e.category = category;
+        e.startTicks = startTicks;
+        e.endTicks = endTicks;
+        e.instance = instance;
+
+        e.sequence.store(index + 1, std::memory_order_release);
+        buffer.writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    //==============================================================================
+    bool writeChromeTrace(const juce::File& file)
+    {
+        const std::lock_guard<std::mutex> lock(controlMutex);
+
+        if (eventsPerBuffer == 0)
+            return false;
+
+        file.deleteFile();
+        juce::FileOutputStream out(file);
+        if (!out.openedOk())
+            return false;
+
+        const double ticksPerUs = (double)juce::Time::getHighResolutionTicksPerSecond() * 1.0e-6;
+        const int numThreads = juce::jmin(maxThreads, numClaimed.load(std::memory_order_acquire));
+        bool first = true;
+
+        auto beginEntry = [&]
+            {
+                out << (first ? "\n" : ",\n");
+                first = false;
+            };
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        for (int slot = 0; slot < numThreads; ++slot)
+        {
+            auto& buffer = buffers[slot];
+            if (!buffer.claimed.load(std::memory_order_acquire))
+                continue;
+
+            // tid = Pufferindex, Name als Metadaten-Event
+            beginEntry();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (slot + 1)
+                << ",\"args\":{\"name\":\"" << escapeJson(juce::String::fromUTF8(buffer.label)) << "\"}}";
+
+            const auto end = buffer.writeIndex.load(std::memory_order_acquire);
+            const auto begin = end > (juce::uint64)eventsPerBuffer ? end - (juce::uint64)eventsPerBuffer : 0;
+
+            for (auto index = begin; index < end; ++index)
+            {
+                auto& e = buffer.events[(size_t)(index % (juce::uint64)eventsPerBuffer)];
+
+                if (e.sequence.load(std::memory_order_acquire) != index + 1)
+                    continue;
+
+                const char* name = e.name;
+                const char* category = e.category;
+                const auto startTicks = e.startTicks;
+                const auto endTicks = e.endTicks;
+                const int instance = e.instance;
+
+                // Während des Lesens überschrieben -> verwerfen
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (e.sequence.load(std::memory_order_relaxed) != index + 1 || startTicks < recordingStartTicks)
+                    continue;
+
+                beginEntry();
+                out << "{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                    << (slot + 1)
+                    << ",\"ts\":" << juce::String((double)(startTicks - recordingStartTicks) / ticksPerUs, 3)
+                    << ",\"dur\":" << juce::String((double)(endTicks - startTicks) / ticksPerUs, 3);
+
+                if (instance >= 0)
+                    out << ",\"args\":{\"instance\":" << instance << "}";
+
+                out << "}";
+            }
+        }
+
+        out << "\n]}\n";
+        out.flush();
+        return out.getStatus().wasOk();
+    }
+}
@@ -0,0 +1,71 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+// Prozessweite Trace-Events im Chrome/Perfetto-Format
+//
+// Zeigt, wie sich Audio-, Analyzer-, Referenz-, Solver- und GUI-Threads aller
+// Instanzen überlagern. Jeder Thread schreibt in einen eigenen Ringpuffer
+// (ein Schreiber, lock-frei, keine Allokationen); der Export liest die Puffer
+// per Sequenznummer und darf auch während der Aufnahme laufen.
+//
+// Ohne laufende Aufnahme kostet ein Scope eine relaxed-Load, während der
+// Aufnahme zusätzlich einen geteilten Schreiber-Zähler: start() wartet damit
+// laufende record()-Aufrufe ab, bevor es die Puffer zurücksetzt, und darf so
+// auch während einer Aufnahme neu starten. Start/Stop und Export nur vom
+// Message-Thread (oder einem Tool-Main).
+//
+//   const TraceRecorder::Scope traceScope("processBlock", "audio", traceId);
+//
+// Die JSON-Datei lässt sich in chrome://tracing oder ui.perfetto.dev öffnen.
+namespace TraceRecorder
+{
+    constexpr int maxThreads = 32;                  // weitere Threads werden verworfen
+    constexpr int defaultEventsPerThread = 1 << 13; // ~0.4 MB je Thread, erst ab start() belegt
+
+    // Puffer werden beim ersten Start angelegt (und nie freigegeben, damit
+    // späte Scopes nicht ins Leere schreiben); eventsPerThread zählt nur dort
+    void start(int eventsPerThread = defaultEventsPerThread);
+    void stop() noexcept;
+    bool isRecording() noexcept;
+
+    // Events, die wegen zu vieler Threads nicht aufgenommen wurden
+    juce::uint64 getNumDroppedEvents() noexcept;
+
+    // Alle noch im Ringpuffer liegenden Events seit start() als Trace-JSON
+    bool writeChromeTrace(const juce::File& file);
+
+    // Fortlaufende Nummer je Processor (Event-Argument "instance")
+    int createInstanceId() noexcept;
+
+    // Fertiges Event eintragen (Zeiten in High-Resolution-Ticks).
+    // name/category müssen String-Literale sein.
+    void record(const char* name, const char* category, juce::int64 startTicks, juce::int64 endTicks,
+        int instance) noexcept;
+
+    //==============================================================================
+    class Scope
+    {
+    public:
+        Scope(const char* nameToUse, const char* categoryToUse, int instanceToUse = -1) noexcept
+            : name(nameToUse), category(categoryToUse), instance(instanceToUse),
+              startTicks(isRecording() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (startTicks != 0)
+                record(name, category, startTicks, juce::Time::getHighResolutionTicks(), instance);
+        }
+
+    private:
+        const char* name;
+        const char* category;
+        int instance;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+}
@@ -0,0 +1,127 @@
+﻿#include "MatchPipeline.h"
+#include "../../Source/ReferenceAnalysis.h"
+#include <iostream>
+
+//==============================================================================
+// MasteringEQMatch: Mischung messen, Auto-EQ lösen, Ergebnis rendern
+//
+//   MasteringEQMatch --genre=Pop --out=mix_eq.wav --state-out=mix.state mix.wav
+//   MasteringEQMatch --reference=vorbild.flac --out=mix_eq.wav mix.wav
+//
+// Der geschriebene State lässt sich im Plugin/Standalone laden oder mit
+// MasteringEQBatch auf weitere Dateien anwenden.
+namespace
+{
+    void printUsage()
+    {
+        std::cout
+            << "Usage: MasteringEQMatch [options] <mix file>\n"
+            << "\n"
+            << "  --genre=<name>      Genre-Referenz (";
+
+        bool first = true;
+        for (const auto& genre : ReferenceAnalysis::getGenres())
+        {
+            std::cout << (first ? "" : ", ") << genre.name;
+            first = false;
+        }
+
+        std::cout
+            << ")\n"
+            << "  --reference=<file>  Referenztrack statt Genre\n"
+            << "  --out=<file>        gerenderte Datei (Format aus der Endung)\n"
+            << "  --state-out=<file>  Plugin-State mit dem Ergebnis\n"
+            << "  --state=<file>      Startzustand (Qs, Input-Gain)\n"
+            << "  --bits=<n>          Bittiefe (Standard: wie Eingabe)\n"
+            << "  --block=<n>         Blockgröße in Samples (Standard: 2048)\n";
+    }
+
+    juce::File resolve(const juce::ArgumentList& args, const juce::String& option)
+    {
+        return juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption(option).unquoted());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit; // Processor braucht einen MessageManager
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    MatchPipeline::Settings settings;
+
+    if (args.containsOption("--genre") == args.containsOption("--reference"))
+    {
+        std::cerr << "Genau eine Referenz angeben: --genre oder --reference\n";
+        return 1;
+    }
+
+    if (args.containsOption("--genre"))
+        settings.genre = args.getValueForOption("--genre").unquoted();
+    else
+        settings.referenceTrack = resolve(args, "--reference");
+
+    if (args.containsOption("--out"))
+        settings.output = resolve(args, "--out");
+
+    if (args.containsOption("--state-out"))
+        settings.stateOutput = resolve(args, "--state-out");
+
+    if (args.containsOption("--state"))
+    {
+        const auto stateFile = resolve(args, "--state");
+
+        if (!stateFile.loadFileAsData(settings.initialState))
+        {
+            std::cerr << "State nicht lesbar: " << stateFile.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    settings.bitDepth = args.getValueForOption("--bits").getIntValue();
+
+    if (args.containsOption("--block"))
+        settings.blockSize = args.getValueForOption("--block").getIntValue();
+
+    for (const auto& arg : args.arguments)
+        if (!arg.isOption())
+            settings.mix = arg.resolveAsFile();
+
+    if (settings.mix == juce::File())
+    {
+        printUsage();
+        return 1;
+    }
+
+    MatchPipeline pipeline(std::move(settings));
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const auto result = pipeline.run();
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - startTicks);
+
+    if (!result.ok)
+    {
+        std::cerr << result.error << "\n";
+        return 1;
+    }
+
+    for (size_t i = 0; i < result.gainsDb.size(); ++i)
+        std::cout << "Band " << juce::String((int)i + 1).paddedLeft(' ', 2) << ": "
+                  << juce::String(result.gainsDb[i], 2).paddedLeft(' ', 6) << " dB  Q "
+                  << juce::String(result.qs[i], 2) << "\n";
+
+    std::cout << "Makeup (nicht angewendet): " << juce::String(result.makeupDb, 2) << " dB\n"
+              << "Messen " << juce::String(result.measureSeconds, 2) << " s, Lösen "
+              << juce::String(result.solveSeconds, 2) << " s, Rendern "
+              << juce::String(result.renderSeconds, 2) << " s -> "
+              << juce::String(wallSeconds, 2) << " s gesamt ("
+              << juce::String(result.audioSeconds / juce::jmax(1.0e-9, wallSeconds), 1) << "x Echtzeit)\n";
+
+    return 0;
+}
@@ -0,0 +1,350 @@
+﻿#include "MatchPipeline.h"
+#include "../../Source/AutoEqSolver.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/ReferenceAnalysis.h"
+#include <future>
+
+namespace
+{
+    // Vorlauf des Decoders und Puffer des Encoders (in Samples)
+    constexpr int kReadAheadSamples = 1 << 16;
+    constexpr int kWriteBufferSamples = 1 << 16;
+
+    // Messblock: höchstens ein fertiger Pre-EQ-Frame pro Block, damit jeder
+    // Frame genau einmal gemittelt wird (FFT-Größe 4096)
+    constexpr int kMeasureBlockSize = 2048;
+
+    double secondsSince(juce::int64 startTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+    //==============================================================================
+    // Bittiefe wählen, die das Zielformat auch schreiben kann
+    int chooseBitDepth(juce::AudioFormat& format, int wanted)
+    {
+        const auto possible = format.getPossibleBitDepths();
+
+        if (possible.contains(wanted))
+            return wanted;
+
+        for (const int bits : possible)
+            if (bits > wanted)
+                return bits;
+
+        return possible.isEmpty() ? 16 : possible.getLast();
+    }
+}
+
+//==============================================================================
+MatchPipeline::MatchPipeline(Settings settingsToUse)
+    : settings(std::move(settingsToUse))
+{
+    formatManager.registerBasicFormats();
+}
+
+//==============================================================================
+/**
+ * @brief Findet Ausgabedateien, die die Mischung oder einander überschreiben würden.
+ *
+ * Die Ausgabe wird vor dem Schreiben gelöscht; zeigt --out auf die Mischung,
+ * wäre die Eingabe weg, bevor der Render-Durchlauf sie liest.
+ *
+ * @return eine Meldung je Konflikt, leer wenn alle Ausgaben eindeutig sind
+ */
+juce::StringArray MatchPipeline::findOutputConflicts() const
+{
+    juce::StringArray conflicts;
+
+    if (settings.output != juce::File() && settings.output == settings.mix)
+        conflicts.add("Ausgabe " + settings.output.getFullPathName() + " würde die Mischung überschreiben");
+
+    if (settings.stateOutput != juce::File() && settings.stateOutput == settings.mix)
+        conflicts.add("State " + settings.stateOutput.getFullPathName() + " würde die Mischung überschreiben");
+
+    if (settings.output != juce::File() && settings.stateOutput == settings.output)
+        conflicts.add("Ausgabe und State zeigen auf dieselbe Datei: " + settings.output.getFullPathName());
+
+    if (settings.referenceTrack != juce::File()
+        && (settings.output == settings.referenceTrack || settings.stateOutput == settings.referenceTrack))
+        conflicts.add("Ausgabe würde den Referenztrack " + settings.referenceTrack.getFullPathName() + " überschreiben");
+
+    return conflicts;
+}
+
+//==============================================================================
+/**
+ * @brief Misst die Mischung, löst den Auto-EQ und rendert das Ergebnis.
+ *
+ * Ablauf wie im Plugin (Messung über den Pre-EQ-Pfad des Processors,
+ * gleicher Löser, gleiche Übernahme in die Parameter). Die Mischung wird
+ * zweimal blockweise gelesen (Messen, Rendern), nie als Ganzes gehalten:
+ *  - ein Referenztrack wird parallel zur Mischung analysiert,
+ *  - Dekodieren und Kodieren laufen auf eigenen Threads neben processBlock().
+ *
+ * Der vom Löser berechnete Makeup-Gain wird wie im Plugin nur gemeldet,
+ * nicht auf den Input-Gain angewendet.
+ *
+ * @return Ergebnis mit Gains/Qs und Zeiten je Stufe
+ */
+MatchPipeline::Result MatchPipeline::run()
+{
+    Result result;
+
+    const auto conflicts = findOutputConflicts();
+    if (!conflicts.isEmpty())
+    {
+        result.error = conflicts.joinIntoString("\n");
+        return result;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> source(formatManager.createReaderFor(settings.mix));
+    if (source == nullptr)
+    {
+        result.error = "Mischung nicht lesbar: " + settings.mix.getFullPathName();
+        return result;
+    }
+
+    const int numChannels = (int)source->numChannels;
+    const double sampleRate = source->sampleRate;
+    const juce::int64 length = source->lengthInSamples;
+    const int sourceBits = (int)source->bitsPerSample;
+
+    if (numChannels < 1 || numChannels > 2)
+    {
+        result.error = "Nur Mono und Stereo werden unterstützt";
+        return result;
+    }
+
+    if (length <= 0)
+    {
+        result.error = "Ungültige Dateilänge";
+        return result;
+    }
+
+    const auto* genre = ReferenceAnalysis::findGenre(settings.genre);
+    if (genre == nullptr && settings.referenceTrack == juce::File())
+    {
+        result.error = "Unbekanntes Genre: " + settings.genre;
+        return result;
+    }
+
+    // Referenztrack parallel zur Mischung analysieren (eigener Reader, eigener Thread)
+    std::future<std::vector<AudioPluginAudioProcessor::ReferenceBand>> referenceJob;
+    if (genre == nullptr)
+        referenceJob = std::async(std::launch::async,
+            [file = settings.referenceTrack] { return ReferenceAnalysis::analyseFile(file); });
+
+    auto processor = std::make_unique<AudioPluginAudioProcessor>();
+
+    if (settings.initialState.getSize() > 0)
+        processor->setStateInformation(settings.initialState.getData(), (int)settings.initialState.getSize());
+
+    const int blockSize = juce::jmax(32, settings.blockSize);
+
+    processor->setNonRealtime(true);
+    processor->setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+
+    //==============================================================================
+    // 1) Dekodieren + Messen (erster Durchlauf, ein Block im Speicher)
+    auto stageTicks = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::TimeSliceThread decodeThread("Match Decode");
+        decodeThread.startThread();
+
+        juce::BufferingAudioReader reader(source.release(), decodeThread, kReadAheadSamples);
+        reader.setReadTimeout(-1); // blockieren statt Stille liefern
+
+        float inputGainDb = 0.0f;
+        if (auto* v = processor->apvts.getRawParameterValue("inputGain"))
+            inputGainDb = v->load();
+
+        const float inputGainLinear = juce::Decibels::decibelsToGain(inputGainDb);
+
+        juce::AudioBuffer<float> block(numChannels, kMeasureBlockSize);
+
+        processor->startMeasurement();
+
+        for (juce::int64 pos = 0; pos < length; pos += kMeasureBlockSize)
+        {
+            const int numSamples = (int)juce::jmin<juce::int64>(kMeasureBlockSize, length - pos);
+            reader.read(&block, 0, numSamples, pos, true, true);
+
+            // Gleiche Mono-Summe wie processBlock() (vor dem EQ, nach Input-Gain)
+            const float* left = block.getReadPointer(0);
+            const float* right = block.getReadPointer(numChannels > 1 ? 1 : 0);
+            const float monoScale = numChannels > 1 ? 0.5f : 1.0f;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float mono = numChannels > 1 ? (left[i] + right[i]) : left[i];
+                processor->pushNextSampleIntoPreEQFifo(mono * monoScale * inputGainLinear);
+            }
+
+            // Fertigen Frame wie der Editor-Timer übernehmen
+            if (processor->getNextPreEQFFTBlockReady())
+            {
+                processor->updatePreEQSpectrumArray(sampleRate);
+                processor->addMeasurementSnapshot();
+                processor->setNextPreEQFFTBlockReady(false);
+            }
+        }
+
+        processor->stopMeasurement();
+    }
+
+    if (processor->getMeasurementSnapshotCount() == 0)
+    {
+        result.error = "Mischung zu kurz für eine Messung";
+        return result;
+    }
+
+    // Referenz bereitstellen (Track-Analyse ist meist schon fertig)
+    if (genre != nullptr)
+    {
+        processor->selectedGenreId = genre->id;
+        processor->loadReferenceCurve(genre->fileName);
+        ReferenceAnalysis::postProcessReferenceBands(processor->referenceBands);
+    }
+    else
+    {
+        processor->selectedGenreId = 0;
+        processor->referenceBands = referenceJob.get();
+    }
+
+    processor->referenceBandsChanged();
+
+    if (processor->referenceBands.empty())
+    {
+        result.error = genre != nullptr ? juce::String("Genre-Referenz nicht gefunden: ") + genre->fileName
+                                        : "Referenz nicht lesbar: " + settings.referenceTrack.getFullPathName();
+        return result;
+    }
+
+    result.measureSeconds = secondsSince(stageTicks);
+
+    //==============================================================================
+    // 2) Auto-EQ lösen und wie im Editor übernehmen
+    stageTicks = juce::Time::getHighResolutionTicks();
+
+    std::array<float, 31> qFixed{};
+    for (int i = 0; i < 31; ++i)
+        if (auto* v = processor->apvts.getRawParameterValue("bandQ" + juce::String(i)))
+            qFixed[(size_t)i] = v->load();
+
+    const auto solved = AutoEqSolver::solve(processor->getAveragedSpectrum(), processor->referenceBands,
+        qFixed, processor->getFilterFrequencies(), (float)sampleRate);
+
+    processor->setTargetResiduals(solved.residualsDb);
+
+    std::array<float, 31> corrections{};
+    for (int i = 0; i < 31; ++i)
+        corrections[(size_t)i] = juce::jlimit(-12.0f, 12.0f, solved.gainsDb[(size_t)i]);
+
+    processor->setTargetCorrections(corrections);
+
+    // Vorher/Nachher als A/B ablegen, Ergebnis in die Parameter übernehmen
+    processor->storeSnapshot(0);
+    processor->storeSnapshot(1, solved.gainsDb, solved.qs);
+    processor->applySnapshotToParameters(1);
+
+    result.gainsDb = solved.gainsDb;
+    result.qs = solved.qs;
+    result.makeupDb = solved.makeupDb;
+    result.solveSeconds = secondsSince(stageTicks);
+
+    //==============================================================================
+    // 3) Rendern (zweiter Durchlauf), Dekodieren und Kodieren im Hintergrund
+    if (settings.output != juce::File())
+    {
+        stageTicks = juce::Time::getHighResolutionTicks();
+
+        std::unique_ptr<juce::AudioFormatReader> renderSource(formatManager.createReaderFor(settings.mix));
+        if (renderSource == nullptr)
+        {
+            result.error = "Mischung nicht lesbar: " + settings.mix.getFullPathName();
+            return result;
+        }
+
+        auto* format = formatManager.findFormatForFileExtension(settings.output.getFileExtension());
+        if (format == nullptr)
+        {
+            result.error = "Unbekanntes Ausgabeformat " + settings.output.getFileExtension();
+            return result;
+        }
+
+        const int bitDepth = chooseBitDepth(*format, settings.bitDepth > 0 ? settings.bitDepth : sourceBits);
+
+        settings.output.deleteFile();
+        auto stream = settings.output.createOutputStream();
+        if (stream == nullptr)
+        {
+            result.error = "Ausgabedatei nicht schreibbar";
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+            (unsigned int)numChannels, bitDepth, {}, 0));
+        if (writer == nullptr)
+        {
+            result.error = "Writer konnte nicht erzeugt werden";
+            return result;
+        }
+
+        stream.release(); // gehört jetzt dem Writer
+
+        juce::TimeSliceThread decodeThread("Match Decode");
+        juce::TimeSliceThread encodeThread("Match Encode");
+        decodeThread.startThread();
+        encodeThread.startThread();
+
+        juce::BufferingAudioReader reader(renderSource.release(), decodeThread, kReadAheadSamples);
+        reader.setReadTimeout(-1); // blockieren statt Stille liefern
+
+        {
+            juce::AudioFormatWriter::ThreadedWriter threadedWriter(writer.release(), encodeThread, kWriteBufferSamples);
+            juce::AudioBuffer<float> block(numChannels, blockSize);
+            juce::MidiBuffer midi;
+
+            // Filterzustände der (ungenutzten) Messphase verwerfen
+            processor->prepareToPlay(sampleRate, blockSize);
+
+            for (juce::int64 pos = 0; pos < length; pos += blockSize)
+            {
+                const int numSamples = (int)juce::jmin<juce::int64>(blockSize, length - pos);
+                block.setSize(numChannels, numSamples, false, false, true);
+
+                reader.read(&block, 0, numSamples, pos, true, true);
+                processor->processBlock(block, midi);
+
+                // Encoder-Puffer voll -> kurz warten, bis der Hintergrund-Thread nachkommt
+                while (!threadedWriter.write(block.getArrayOfReadPointers(), numSamples))
+                    juce::Thread::sleep(1);
+            }
+        } // ThreadedWriter schreibt beim Zerstören den Rest und schließt die Datei
+
+        result.renderSeconds = secondsSince(stageTicks);
+    }
+
+    processor->releaseResources();
+
+    //==============================================================================
+    // 4) Plugin-State mit Referenz, Messung, Zielkurve und Snapshots schreiben
+    if (settings.stateOutput != juce::File())
+    {
+        juce::MemoryBlock state;
+        processor->getStateInformation(state);
+
+        if (!settings.stateOutput.replaceWithData(state.getData(), state.getSize()))
+        {
+            result.error = "State nicht schreibbar: " + settings.stateOutput.getFullPathName();
+            return result;
+        }
+    }
+
+    result.ok = true;
+    result.audioSeconds = sampleRate > 0.0 ? (double)length / sampleRate : 0.0;
+    return result;
+}
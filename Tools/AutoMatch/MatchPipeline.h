@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <array>
+
+//==============================================================================
+// Offline-Kette Messen -> Auto-EQ lösen -> Rendern -> State schreiben
+//
+// Messen und Rendern lesen die Mischung blockweise in je einem eigenen
+// Durchlauf, der Speicherbedarf hängt also nicht von der Dateilänge ab.
+// Eine Referenz-Analyse (Track statt Genre) läuft parallel zum Messen,
+// Dekodieren und Kodieren laufen auf eigenen Threads neben der Verarbeitung.
+class MatchPipeline
+{
+public:
+    struct Settings
+    {
+        juce::File mix;                 // zu bearbeitende Mischung
+        juce::String genre;             // Genre-Vorlage (Name wie im Dropdown) ...
+        juce::File referenceTrack;      // ... oder ein Referenztrack
+        juce::File output;              // gerenderte Datei (leer = nicht rendern)
+        juce::File stateOutput;         // Plugin-State mit dem Ergebnis (leer = nicht schreiben)
+        juce::MemoryBlock initialState; // Startzustand (Qs, Input-Gain), leer = Defaults
+        int bitDepth = 0;               // 0 = wie Eingabe
+        int blockSize = 2048;           // Blockgröße für processBlock()
+    };
+
+    struct Result
+    {
+        bool ok = false;
+        juce::String error;
+
+        std::array<float, 31> gainsDb{};
+        std::array<float, 31> qs{};
+        float makeupDb = 0.0f;
+
+        double measureSeconds = 0.0;    // Dekodieren + Messen (inkl. Warten auf die Referenz)
+        double solveSeconds = 0.0;
+        double renderSeconds = 0.0;     // Verarbeiten + Kodieren
+        double audioSeconds = 0.0;
+    };
+
+    explicit MatchPipeline(Settings settingsToUse);
+
+    // Ausgaben, die die Mischung oder einander überschreiben würden
+    // (wie BatchRenderer::findOutputConflicts). Leer = alles ok.
+    juce::StringArray findOutputConflicts() const;
+
+    // Muss auf dem Message-Thread laufen (Processor-Erzeugung)
+    Result run();
+
+private:
+    Settings settings;
+    juce::AudioFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MatchPipeline)
+};
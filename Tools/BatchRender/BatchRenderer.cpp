@@ -0,0 +1,259 @@
+﻿#include "BatchRenderer.h"
+#include "../../Source/PluginProcessor.h"
+#include <atomic>
+
+namespace
+{
+    // Vorlauf des Decoders und Puffer des Encoders (in Samples)
+    constexpr int kReadAheadSamples = 1 << 16;
+    constexpr int kWriteBufferSamples = 1 << 16;
+
+    //==============================================================================
+    // Bittiefe wählen, die das Zielformat auch schreiben kann
+    int chooseBitDepth(juce::AudioFormat& format, int wanted)
+    {
+        const auto possible = format.getPossibleBitDepths();
+
+        if (possible.contains(wanted))
+            return wanted;
+
+        // Nächstgrößere, sonst die größte verfügbare
+        for (const int bits : possible)
+            if (bits > wanted)
+                return bits;
+
+        return possible.isEmpty() ? 16 : possible.getLast();
+    }
+
+    //==============================================================================
+    // Eine Datei durch den (bereits mit State versehenen) Processor rendern
+    BatchRenderer::Result renderFile(AudioPluginAudioProcessor& processor,
+        juce::AudioFormatManager& formats,
+        const BatchRenderer::Settings& settings,
+        const juce::File& input, const juce::File& output)
+    {
+        BatchRenderer::Result result;
+        result.input = input;
+        result.output = output;
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        std::unique_ptr<juce::AudioFormatReader> source(formats.createReaderFor(input));
+        if (source == nullptr)
+        {
+            result.error = "Format nicht lesbar";
+            return result;
+        }
+
+        const int numChannels = (int)source->numChannels;
+        const double sampleRate = source->sampleRate;
+        const juce::int64 length = source->lengthInSamples;
+
+        if (numChannels < 1 || numChannels > 2)
+        {
+            result.error = "Nur Mono und Stereo werden unterstützt";
+            return result;
+        }
+
+        auto* format = formats.findFormatForFileExtension(output.getFileExtension());
+        if (format == nullptr)
+        {
+            result.error = "Unbekanntes Ausgabeformat " + output.getFileExtension();
+            return result;
+        }
+
+        const int bitDepth = chooseBitDepth(*format,
+            settings.bitDepth > 0 ? settings.bitDepth : (int)source->bitsPerSample);
+
+        // Dekodieren und Kodieren laufen auf eigenen Threads vor bzw. hinter der Verarbeitung
+        juce::TimeSliceThread decodeThread("Batch Decode");
+        juce::TimeSliceThread encodeThread("Batch Encode");
+        decodeThread.startThread();
+        encodeThread.startThread();
+
+        juce::BufferingAudioReader reader(source.release(), decodeThread, kReadAheadSamples);
+        reader.setReadTimeout(-1); // blockieren statt Stille liefern
+
+        // Letzte Absicherung, findOutputConflicts() fängt das schon vorher ab
+        if (output == input)
+        {
+            result.error = "Ausgabe wäre die Eingabedatei selbst";
+            return result;
+        }
+
+        output.deleteFile();
+        auto stream = output.createOutputStream();
+        if (stream == nullptr)
+        {
+            result.error = "Ausgabedatei nicht schreibbar";
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+            (unsigned int)numChannels, bitDepth, {}, 0));
+        if (writer == nullptr)
+        {
+            result.error = "Writer konnte nicht erzeugt werden";
+            return result;
+        }
+
+        stream.release(); // gehört jetzt dem Writer
+
+        {
+            juce::AudioFormatWriter::ThreadedWriter threadedWriter(writer.release(), encodeThread, kWriteBufferSamples);
+
+            const int blockSize = juce::jmax(32, settings.blockSize);
+
+            processor.setNonRealtime(true);
+            processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+            processor.getPerformanceCounters().resetAll(); // Zähler je Datei, der Processor rendert mehrere
+
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            juce::MidiBuffer midi;
+
+            for (juce::int64 pos = 0; pos < length; pos += blockSize)
+            {
+                const int numSamples = (int)juce::jmin<juce::int64>(blockSize, length - pos);
+                buffer.setSize(numChannels, numSamples, false, false, true);
+
+                reader.read(&buffer, 0, numSamples, pos, true, true);
+                processor.processBlock(buffer, midi);
+
+                // Encoder-Puffer voll -> kurz warten, bis der Hintergrund-Thread nachkommt
+                while (!threadedWriter.write(buffer.getArrayOfReadPointers(), numSamples))
+                    juce::Thread::sleep(1);
+            }
+
+            processor.releaseResources();
+        } // ThreadedWriter schreibt beim Zerstören den Rest und schließt die Datei
+
+        if (settings.writeHealthCsv)
+        {
+            const auto csvFile = output.withFileExtension(output.getFileExtension() + ".health.csv");
+            if (!processor.getPerformanceCounters().writeCsv(csvFile))
+            {
+                result.error = "Health-CSV nicht schreibbar";
+                return result;
+            }
+        }
+
+        result.ok = true;
+        result.audioSeconds = sampleRate > 0.0 ? (double)length / sampleRate : 0.0;
+        result.renderSeconds = juce::Time::highResolutionTicksToSeconds(
+            juce::Time::getHighResolutionTicks() - startTicks);
+        return result;
+    }
+}
+
+//==============================================================================
+BatchRenderer::BatchRenderer(Settings settingsToUse)
+    : settings(std::move(settingsToUse))
+{
+    formatManager.registerBasicFormats();
+}
+
+//==============================================================================
+/**
+ * @brief Rendert alle Eingabedateien parallel.
+ *
+ * Pro Worker wird eine Processor-Instanz auf dem Message-Thread erzeugt
+ * und mit dem State geladen; die Worker holen sich danach die nächste
+ * Datei über einen gemeinsamen Index.
+ *
+ * @param inputs Eingabedateien
+ * @return Ergebnis je Datei in Eingabereihenfolge
+ */
+std::vector<BatchRenderer::Result> BatchRenderer::renderAll(const juce::Array<juce::File>& inputs)
+{
+    std::vector<Result> results((size_t)inputs.size());
+
+    if (inputs.isEmpty())
+        return results;
+
+    const int numWorkers = juce::jlimit(1, inputs.size(),
+        settings.numThreads > 0 ? settings.numThreads : juce::SystemStats::getNumCpus());
+
+    std::vector<std::unique_ptr<AudioPluginAudioProcessor>> processors;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto processor = std::make_unique<AudioPluginAudioProcessor>();
+
+        if (settings.state.getSize() > 0)
+            processor->setStateInformation(settings.state.getData(), (int)settings.state.getSize());
+
+        processors.push_back(std::move(processor));
+    }
+
+    std::atomic<int> nextInput{ 0 };
+    juce::ThreadPool pool(numWorkers);
+
+    for (int w = 0; w < numWorkers; ++w)
+    {
+        pool.addJob([this, w, &inputs, &results, &processors, &nextInput]
+            {
+                for (int i = nextInput++; i < inputs.size(); i = nextInput++)
+                {
+                    const auto& input = inputs.getReference(i);
+                    results[(size_t)i] = renderFile(*processors[(size_t)w], formatManager, settings,
+                        input, getOutputFileFor(input));
+                }
+            });
+    }
+
+    while (pool.getNumJobs() > 0)
+        juce::Thread::sleep(5);
+
+    return results;
+}
+
+//==============================================================================
+/**
+ * @brief Findet Ausgabedateien, die Eingaben oder einander überschreiben würden.
+ *
+ * Ohne --out und mit leerem Suffix landet die Ausgabe auf der Eingabe; mit
+ * --out kollidieren gleichnamige Dateien aus verschiedenen Ordnern. Beides
+ * muss vor dem Rendern auffallen, nicht erst, wenn Dateien schon ersetzt sind.
+ *
+ * @param inputs Eingabedateien wie für renderAll()
+ * @return eine Meldung je Konflikt, leer wenn alle Ausgaben eindeutig sind
+ */
+juce::StringArray BatchRenderer::findOutputConflicts(const juce::Array<juce::File>& inputs) const
+{
+    juce::StringArray conflicts;
+    juce::Array<juce::File> outputs;
+
+    for (const auto& input : inputs)
+        outputs.add(getOutputFileFor(input));
+
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        const auto& output = outputs.getReference(i);
+
+        if (inputs.contains(output))
+        {
+            conflicts.add(inputs[i].getFullPathName() + ": Ausgabe " + output.getFullPathName()
+                + " würde eine Eingabedatei überschreiben (--suffix oder --out setzen)");
+            continue;
+        }
+
+        const int first = outputs.indexOf(output);
+        if (first < i)
+            conflicts.add(inputs[i].getFullPathName() + ": gleiche Ausgabe " + output.getFullPathName()
+                + " wie " + inputs[first].getFullPathName());
+    }
+
+    return conflicts;
+}
+
+//==============================================================================
+juce::File BatchRenderer::getOutputFileFor(const juce::File& input) const
+{
+    const auto directory = settings.outputDirectory == juce::File() ? input.getParentDirectory()
+                                                                    : settings.outputDirectory;
+    const auto extension = settings.formatExtension.isNotEmpty() ? settings.formatExtension
+                                                                 : input.getFileExtension();
+
+    return directory.getChildFile(input.getFileNameWithoutExtension() + settings.suffix + extension);
+}
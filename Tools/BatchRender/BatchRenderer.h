@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <vector>
+
+//==============================================================================
+// Offline-Rendering von Audiodateien durch den Plugin-Processor
+//
+// Jede Datei bekommt eine eigene Processor-Instanz mit dem gleichen State.
+// Dateien laufen parallel auf einem ThreadPool, innerhalb einer Datei sind
+// Dekodieren (BufferingAudioReader), Verarbeiten und Kodieren (ThreadedWriter)
+// über eigene Threads entkoppelt.
+class BatchRenderer
+{
+public:
+    struct Settings
+    {
+        juce::MemoryBlock state;        // Plugin-State (getStateInformation), leer = Defaults
+        juce::File outputDirectory;     // leer = neben der Eingabedatei
+        juce::String suffix = "_eq";    // an den Dateinamen angehängt
+        juce::String formatExtension;   // z.B. ".wav", leer = wie Eingabe
+        int bitDepth = 0;               // 0 = wie Eingabe
+        int numThreads = 0;             // 0 = alle Kerne
+        int blockSize = 2048;           // Blockgröße für processBlock()
+        bool writeHealthCsv = false;    // Health-Zähler je Datei als <Ausgabe>.health.csv
+    };
+
+    struct Result
+    {
+        juce::File input;
+        juce::File output;
+        bool ok = false;
+        juce::String error;
+        double audioSeconds = 0.0;      // Länge der Datei
+        double renderSeconds = 0.0;     // benötigte Zeit
+    };
+
+    explicit BatchRenderer(Settings settingsToUse);
+
+    // Rendert alle Dateien, Ergebnisse in der Reihenfolge der Eingabe.
+    // Muss auf dem Message-Thread aufgerufen werden (Processor-Erzeugung).
+    std::vector<Result> renderAll(const juce::Array<juce::File>& inputs);
+
+    // Prüft vor dem Rendern, ob eine Ausgabe eine Eingabedatei überschreiben
+    // würde oder mehrere Eingaben auf dieselbe Ausgabe fallen. Leer = alles ok.
+    juce::StringArray findOutputConflicts(const juce::Array<juce::File>& inputs) const;
+
+    juce::AudioFormatManager& getFormatManager() noexcept { return formatManager; }
+
+private:
+    Settings settings;
+    juce::AudioFormatManager formatManager;
+
+    juce::File getOutputFileFor(const juce::File& input) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchRenderer)
+};
@@ -0,0 +1,212 @@
+﻿#include "BatchRenderer.h"
+#include "StreamRenderer.h"
+#include <iostream>
+
+#if JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <io.h>
+#endif
+
+//==============================================================================
+// MasteringEQBatch: Audiodateien ohne DAW durch den EQ rendern
+//
+//   MasteringEQBatch [Optionen] datei1.wav datei2.flac ...
+//   ffmpeg -i in.mp3 -f wav - | MasteringEQBatch --stream | ffmpeg -f wav -i - out.flac
+//
+// Der State ist der rohe Plugin-State, wie ihn z.B. die Standalone-Version
+// über "Save current state..." speichert.
+namespace
+{
+    void printUsage()
+    {
+        std::cout
+            << "Usage: MasteringEQBatch [options] <audio files...>\n"
+            << "\n"
+            << "  --state=<file>    Plugin-State (Standalone: \"Save current state...\")\n"
+            << "  --out=<dir>       Ausgabeordner (Standard: neben der Eingabe)\n"
+            << "  --suffix=<text>   Anhang an den Dateinamen (Standard: _eq)\n"
+            << "  --format=<ext>    wav, aiff oder flac (Standard: wie Eingabe)\n"
+            << "  --bits=<n>        Bittiefe (Standard: wie Eingabe)\n"
+            << "  --threads=<n>     parallele Dateien (Standard: alle Kerne)\n"
+            << "  --block=<n>       Blockgröße in Samples (Standard: 2048)\n"
+            << "  --health          Health-Zähler je Datei als <Ausgabe>.health.csv\n"
+            << "\n"
+            << "Streaming (stdin -> stdout, keine Dateien):\n"
+            << "  --stream          WAV auf stdin, WAV auf stdout\n"
+            << "  --stream=raw      rohes interleaved PCM, dazu:\n"
+            << "  --rate=<hz>       Samplerate (Standard: 48000)\n"
+            << "  --channels=<n>    1 oder 2 (Standard: 2)\n"
+            << "  --pcm=<fmt>       s16, s24, s32 oder f32 (Standard: f32)\n"
+            << "  --health=<file>   Health-Zähler am Ende als CSV\n";
+    }
+
+    //==============================================================================
+    // Streaming-Modus: stdout gehört den Audiodaten, Meldungen gehen nach stderr
+    int runStream(const juce::ArgumentList& args, juce::MemoryBlock state)
+    {
+       #if JUCE_WINDOWS
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+       #endif
+
+        StreamRenderer::Settings settings;
+        settings.state = std::move(state);
+        settings.wav = !args.getValueForOption("--stream").equalsIgnoreCase("raw");
+
+        if (args.containsOption("--rate"))
+            settings.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+
+        if (args.containsOption("--channels"))
+            settings.numChannels = args.getValueForOption("--channels").getIntValue();
+
+        if (args.containsOption("--pcm")
+            && !StreamRenderer::parseSampleFormat(args.getValueForOption("--pcm"), settings.format))
+        {
+            std::cerr << "Unbekanntes PCM-Format: " << args.getValueForOption("--pcm") << "\n";
+            return 1;
+        }
+
+        if (args.containsOption("--block"))
+            settings.blockSize = args.getValueForOption("--block").getIntValue();
+
+        // Ohne Ausgabedateien braucht die CSV einen Namen; vor dem Rendern prüfen,
+        // nicht erst am Ende, wenn der Stream schon verarbeitet ist
+        if (args.containsOption("--health"))
+        {
+            const auto healthPath = args.getValueForOption("--health").unquoted();
+
+            if (healthPath.isEmpty())
+            {
+                std::cerr << "--health braucht im Streaming-Modus eine Datei: --health=<file>\n";
+                return 1;
+            }
+
+            settings.healthFile = juce::File::getCurrentWorkingDirectory().getChildFile(healthPath);
+
+            if (settings.healthFile.isDirectory())
+            {
+                std::cerr << "Health-CSV ist ein Ordner: " << settings.healthFile.getFullPathName() << "\n";
+                return 1;
+            }
+        }
+
+        StreamRenderer renderer(std::move(settings));
+        const auto result = renderer.run(stdin, stdout);
+
+        if (result.failed())
+        {
+            std::cerr << result.getErrorMessage() << "\n";
+            return 1;
+        }
+
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit; // Processor braucht einen MessageManager
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    BatchRenderer::Settings settings;
+
+    if (args.containsOption("--state"))
+    {
+        const juce::File stateFile = juce::File::getCurrentWorkingDirectory()
+            .getChildFile(args.getValueForOption("--state").unquoted());
+
+        if (!stateFile.loadFileAsData(settings.state))
+        {
+            std::cerr << "State nicht lesbar: " << stateFile.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    if (args.containsOption("--stream"))
+        return runStream(args, std::move(settings.state));
+
+    if (args.containsOption("--out"))
+    {
+        settings.outputDirectory = juce::File::getCurrentWorkingDirectory()
+            .getChildFile(args.getValueForOption("--out").unquoted());
+
+        if (!settings.outputDirectory.createDirectory())
+        {
+            std::cerr << "Ausgabeordner nicht anlegbar: " << settings.outputDirectory.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    if (args.containsOption("--suffix"))
+        settings.suffix = args.getValueForOption("--suffix").unquoted();
+
+    if (args.containsOption("--format"))
+        settings.formatExtension = "." + args.getValueForOption("--format").trimCharactersAtStart(".");
+
+    settings.bitDepth = args.getValueForOption("--bits").getIntValue();
+    settings.numThreads = args.getValueForOption("--threads").getIntValue();
+
+    if (args.containsOption("--block"))
+        settings.blockSize = args.getValueForOption("--block").getIntValue();
+
+    settings.writeHealthCsv = args.containsOption("--health");
+
+    juce::Array<juce::File> inputs;
+
+    for (const auto& arg : args.arguments)
+        if (!arg.isOption())
+            inputs.add(arg.resolveAsFile());
+
+    if (inputs.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    BatchRenderer renderer(std::move(settings));
+
+    // Nichts rendern, wenn eine Datei eine Eingabe oder eine andere Ausgabe ersetzen würde
+    const auto conflicts = renderer.findOutputConflicts(inputs);
+    if (!conflicts.isEmpty())
+    {
+        for (const auto& conflict : conflicts)
+            std::cerr << conflict << "\n";
+
+        return 1;
+    }
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const auto results = renderer.renderAll(inputs);
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - startTicks);
+
+    int failed = 0;
+    double audioSeconds = 0.0;
+
+    for (const auto& r : results)
+    {
+        if (r.ok)
+        {
+            audioSeconds += r.audioSeconds;
+            std::cout << r.output.getFullPathName() << "  ("
+                      << juce::String(r.audioSeconds / juce::jmax(1.0e-9, r.renderSeconds), 1) << "x Echtzeit)\n";
+        }
+        else
+        {
+            ++failed;
+            std::cerr << r.input.getFullPathName() << ": " << r.error << "\n";
+        }
+    }
+
+    std::cout << results.size() - (size_t)failed << " von " << results.size() << " Dateien in "
+              << juce::String(wallSeconds, 2) << " s gerendert ("
+              << juce::String(audioSeconds / juce::jmax(1.0e-9, wallSeconds), 1) << "x Echtzeit gesamt)\n";
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,347 @@
+﻿#include "StreamRenderer.h"
+#include "../../Source/PluginProcessor.h"
+#include <cstring>
+
+namespace
+{
+    // WAV-Größenfeld für "Länge unbekannt" (wie ffmpeg beim Pipen)
+    constexpr juce::uint32 kUnknownWavSize = 0xffffffffu;
+
+    int getBytesPerSample(StreamRenderer::SampleFormat format)
+    {
+        switch (format)
+        {
+            case StreamRenderer::SampleFormat::int16:   return 2;
+            case StreamRenderer::SampleFormat::int24:   return 3;
+            case StreamRenderer::SampleFormat::int32:   return 4;
+            case StreamRenderer::SampleFormat::float32: return 4;
+        }
+
+        return 4;
+    }
+
+    //==============================================================================
+    // fread bis die Anzahl erreicht ist oder EOF (Pipes liefern in Stücken)
+    size_t readFully(std::FILE* in, void* dest, size_t numBytes)
+    {
+        size_t total = 0;
+
+        while (total < numBytes)
+        {
+            const size_t got = std::fread(static_cast<char*>(dest) + total, 1, numBytes - total, in);
+            if (got == 0)
+                break;
+
+            total += got;
+        }
+
+        return total;
+    }
+
+    bool skipBytes(std::FILE* in, juce::uint64 numBytes)
+    {
+        char scratch[4096];
+
+        while (numBytes > 0)
+        {
+            const size_t chunk = (size_t)juce::jmin<juce::uint64>(numBytes, sizeof(scratch));
+            if (readFully(in, scratch, chunk) != chunk)
+                return false;
+
+            numBytes -= chunk;
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    // WAV-Header sequentiell lesen (stdin ist nicht seekbar). Liefert die Anzahl
+    // Audiobytes, oder 0 wenn die Länge unbekannt ist (bis EOF lesen).
+    juce::Result readWavHeader(std::FILE* in, StreamRenderer::Settings& format, juce::uint64& dataBytes)
+    {
+        char riff[12];
+        if (readFully(in, riff, sizeof(riff)) != sizeof(riff))
+            return juce::Result::fail("Kein WAV-Header auf stdin");
+
+        const bool isRf64 = std::memcmp(riff, "RF64", 4) == 0;
+        if ((std::memcmp(riff, "RIFF", 4) != 0 && !isRf64) || std::memcmp(riff + 8, "WAVE", 4) != 0)
+            return juce::Result::fail("Eingabe ist kein RIFF/WAVE");
+
+        bool haveFormat = false;
+
+        for (;;)
+        {
+            char header[8];
+            if (readFully(in, header, sizeof(header)) != sizeof(header))
+                return juce::Result::fail("WAV ohne data-Chunk");
+
+            const auto size = juce::ByteOrder::littleEndianInt(header + 4);
+            const juce::uint64 paddedSize = (juce::uint64)size + (size & 1u);
+
+            if (std::memcmp(header, "fmt ", 4) == 0)
+            {
+                char fmt[40] = {};
+                const size_t toRead = (size_t)juce::jmin<juce::uint32>(size, sizeof(fmt));
+
+                if (size < 16 || readFully(in, fmt, toRead) != toRead || !skipBytes(in, paddedSize - toRead))
+                    return juce::Result::fail("Ungültiger fmt-Chunk");
+
+                auto tag = juce::ByteOrder::littleEndianShort(fmt);
+                const int channels = juce::ByteOrder::littleEndianShort(fmt + 2);
+                const auto rate = juce::ByteOrder::littleEndianInt(fmt + 4);
+                const int bits = juce::ByteOrder::littleEndianShort(fmt + 14);
+
+                if (tag == 0xfffe && size >= 26) // WAVE_FORMAT_EXTENSIBLE: Subformat-GUID
+                    tag = juce::ByteOrder::littleEndianShort(fmt + 24);
+
+                if (tag == 1 && bits == 16)      format.format = StreamRenderer::SampleFormat::int16;
+                else if (tag == 1 && bits == 24) format.format = StreamRenderer::SampleFormat::int24;
+                else if (tag == 1 && bits == 32) format.format = StreamRenderer::SampleFormat::int32;
+                else if (tag == 3 && bits == 32) format.format = StreamRenderer::SampleFormat::float32;
+                else
+                    return juce::Result::fail("Nicht unterstütztes WAV-Format (Tag " + juce::String(tag)
+                                              + ", " + juce::String(bits) + " Bit)");
+
+                format.numChannels = channels;
+                format.sampleRate = (double)rate;
+                haveFormat = true;
+            }
+            else if (std::memcmp(header, "data", 4) == 0)
+            {
+                if (!haveFormat)
+                    return juce::Result::fail("data-Chunk vor fmt-Chunk");
+
+                // Bei RF64 steht die echte Länge im ds64-Chunk -> einfach bis EOF lesen
+                dataBytes = (isRf64 || size == 0 || size == kUnknownWavSize) ? 0 : (juce::uint64)size;
+                return juce::Result::ok();
+            }
+            else if (!skipBytes(in, paddedSize))
+            {
+                return juce::Result::fail("WAV ohne data-Chunk");
+            }
+        }
+    }
+
+    // Kanonischer 44-Byte-Header mit "Länge unbekannt"
+    bool writeWavHeader(std::FILE* out, const StreamRenderer::Settings& format)
+    {
+        const int bytesPerSample = getBytesPerSample(format.format);
+        const auto blockAlign = (juce::uint16)(bytesPerSample * format.numChannels);
+        const auto rate = (juce::uint32)format.sampleRate;
+
+        juce::MemoryOutputStream header(44);
+        header.write("RIFF", 4);
+        header.writeInt((int)kUnknownWavSize);
+        header.write("WAVEfmt ", 8);
+        header.writeInt(16);
+        header.writeShort((short)(format.format == StreamRenderer::SampleFormat::float32 ? 3 : 1));
+        header.writeShort((short)format.numChannels);
+        header.writeInt((int)rate);
+        header.writeInt((int)(rate * blockAlign));
+        header.writeShort((short)blockAlign);
+        header.writeShort((short)(bytesPerSample * 8));
+        header.write("data", 4);
+        header.writeInt((int)kUnknownWavSize);
+
+        return std::fwrite(header.getData(), 1, header.getDataSize(), out) == header.getDataSize();
+    }
+
+    //==============================================================================
+    // Interleaved Little-Endian PCM <-> AudioBuffer
+    void decodeBlock(const char* src, juce::AudioBuffer<float>& dest, StreamRenderer::SampleFormat format)
+    {
+        const int numChannels = dest.getNumChannels();
+        const int bytesPerSample = getBytesPerSample(format);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* d = dest.getWritePointer(ch);
+            const char* s = src + ch * bytesPerSample;
+            const int stride = numChannels * bytesPerSample;
+
+            for (int i = 0; i < dest.getNumSamples(); ++i, s += stride)
+            {
+                switch (format)
+                {
+                    case StreamRenderer::SampleFormat::int16:
+                        d[i] = (float)(juce::int16)juce::ByteOrder::littleEndianShort(s) * (1.0f / 32768.0f);
+                        break;
+                    case StreamRenderer::SampleFormat::int24:
+                        d[i] = (float)juce::ByteOrder::littleEndian24Bit(s) * (1.0f / 8388608.0f);
+                        break;
+                    case StreamRenderer::SampleFormat::int32:
+                        d[i] = (float)((double)(juce::int32)juce::ByteOrder::littleEndianInt(s) * (1.0 / 2147483648.0));
+                        break;
+                    case StreamRenderer::SampleFormat::float32:
+                    {
+                        const auto bits = juce::ByteOrder::littleEndianInt(s);
+                        std::memcpy(&d[i], &bits, sizeof(float));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    void encodeBlock(const juce::AudioBuffer<float>& src, char* dest, StreamRenderer::SampleFormat format)
+    {
+        const int numChannels = src.getNumChannels();
+        const int bytesPerSample = getBytesPerSample(format);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* s = src.getReadPointer(ch);
+            char* d = dest + ch * bytesPerSample;
+            const int stride = numChannels * bytesPerSample;
+
+            for (int i = 0; i < src.getNumSamples(); ++i, d += stride)
+            {
+                const float x = juce::jlimit(-1.0f, 1.0f, s[i]);
+
+                switch (format)
+                {
+                    case StreamRenderer::SampleFormat::int16:
+                    {
+                        const auto v = juce::ByteOrder::swapIfBigEndian((juce::uint16)(juce::int16)juce::roundToInt(x * 32767.0f));
+                        std::memcpy(d, &v, 2);
+                        break;
+                    }
+                    case StreamRenderer::SampleFormat::int24:
+                        juce::ByteOrder::littleEndian24BitToChars(juce::roundToInt(x * 8388607.0f), d);
+                        break;
+                    case StreamRenderer::SampleFormat::int32:
+                    {
+                        const auto v = juce::ByteOrder::swapIfBigEndian((juce::uint32)(juce::int32)juce::roundToInt((double)x * 2147483647.0));
+                        std::memcpy(d, &v, 4);
+                        break;
+                    }
+                    case StreamRenderer::SampleFormat::float32:
+                    {
+                        // Float bleibt unbegrenzt (kein Clipping im Zwischenformat)
+                        juce::uint32 bits;
+                        std::memcpy(&bits, &s[i], sizeof(float));
+                        bits = juce::ByteOrder::swapIfBigEndian(bits);
+                        std::memcpy(d, &bits, 4);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//==============================================================================
+StreamRenderer::StreamRenderer(Settings settingsToUse)
+    : settings(std::move(settingsToUse))
+{
+}
+
+bool StreamRenderer::parseSampleFormat(const juce::String& text, SampleFormat& format)
+{
+    const auto t = text.trim().toLowerCase();
+
+    if (t == "s16")      format = SampleFormat::int16;
+    else if (t == "s24") format = SampleFormat::int24;
+    else if (t == "s32") format = SampleFormat::int32;
+    else if (t == "f32") format = SampleFormat::float32;
+    else return false;
+
+    return true;
+}
+
+//==============================================================================
+/**
+ * @brief Liest PCM bis EOF, verarbeitet es blockweise und schreibt es weiter.
+ *
+ * Alle Puffer werden vor der Schleife für eine Blockgröße angelegt; jeder
+ * Block wird nach processBlock() sofort geschrieben und geflusht, damit
+ * nachgelagerte Prozesse nicht auf stdio-Puffer warten.
+ *
+ * @param input  Quelle (stdin im Binärmodus)
+ * @param output Ziel (stdout im Binärmodus)
+ * @return Fehlerbeschreibung oder ok
+ */
+juce::Result StreamRenderer::run(std::FILE* input, std::FILE* output)
+{
+    framesProcessed = 0;
+
+    juce::uint64 remainingBytes = 0; // 0 = bis EOF
+
+    if (settings.wav)
+    {
+        const auto header = readWavHeader(input, settings, remainingBytes);
+        if (header.failed())
+            return header;
+    }
+
+    const int numChannels = settings.numChannels;
+    if (numChannels < 1 || numChannels > 2)
+        return juce::Result::fail("Nur Mono und Stereo werden unterstützt");
+
+    if (!(settings.sampleRate > 0.0))
+        return juce::Result::fail("Ungültige Samplerate");
+
+    const bool untilEof = remainingBytes == 0;
+    const int blockSize = juce::jmax(32, settings.blockSize);
+    const size_t frameBytes = (size_t)(getBytesPerSample(settings.format) * numChannels);
+
+    AudioPluginAudioProcessor processor;
+
+    if (settings.state.getSize() > 0)
+        processor.setStateInformation(settings.state.getData(), (int)settings.state.getSize());
+
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(numChannels, numChannels, settings.sampleRate, blockSize);
+    processor.prepareToPlay(settings.sampleRate, blockSize);
+
+    if (settings.wav && !writeWavHeader(output, settings))
+        return juce::Result::fail("Schreiben nach stdout fehlgeschlagen");
+
+    // Konstanter Speicher: ein Block Rohdaten hin und zurück
+    juce::HeapBlock<char> inBytes((size_t)blockSize * frameBytes);
+    juce::HeapBlock<char> outBytes((size_t)blockSize * frameBytes);
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    for (;;)
+    {
+        size_t wanted = (size_t)blockSize * frameBytes;
+        if (!untilEof)
+            wanted = (size_t)juce::jmin<juce::uint64>(wanted, remainingBytes);
+
+        const size_t got = readFully(input, inBytes.get(), wanted);
+        const int numFrames = (int)(got / frameBytes); // angebrochener Frame am Ende fällt weg
+
+        if (numFrames > 0)
+        {
+            buffer.setSize(numChannels, numFrames, false, false, true);
+            decodeBlock(inBytes.get(), buffer, settings.format);
+
+            processor.processBlock(buffer, midi);
+
+            encodeBlock(buffer, outBytes.get(), settings.format);
+
+            const size_t bytes = (size_t)numFrames * frameBytes;
+            if (std::fwrite(outBytes.get(), 1, bytes, output) != bytes || std::fflush(output) != 0)
+                return juce::Result::fail("Schreiben nach stdout fehlgeschlagen");
+
+            framesProcessed += numFrames;
+        }
+
+        if (!untilEof)
+            remainingBytes -= got;
+
+        if (got < wanted || (!untilEof && remainingBytes == 0))
+            break;
+    }
+
+    processor.releaseResources();
+
+    if (std::ferror(input))
+        return juce::Result::fail("Lesefehler auf stdin");
+
+    if (settings.healthFile != juce::File() && !processor.getPerformanceCounters().writeCsv(settings.healthFile))
+        return juce::Result::fail("Health-CSV nicht schreibbar: " + settings.healthFile.getFullPathName());
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdio>
+
+//==============================================================================
+// Streaming-Rendering: PCM von stdin durch den EQ nach stdout
+//
+// Für ffmpeg/sox-Pipelines ohne temporäre Dateien. Gelesen wird blockweise
+// (Latenz = eine Blockgröße), der Speicherbedarf ist unabhängig von der
+// Länge des Streams. Die Eingabe ist WAV (Header wird gelesen, Länge darf
+// unbekannt sein) oder rohes PCM; die Ausgabe hat das gleiche Format.
+class StreamRenderer
+{
+public:
+    enum class SampleFormat
+    {
+        int16,
+        int24,
+        int32,
+        float32
+    };
+
+    struct Settings
+    {
+        juce::MemoryBlock state;        // Plugin-State (getStateInformation), leer = Defaults
+        bool wav = true;                // false = rohes, interleaved Little-Endian PCM
+        double sampleRate = 48000.0;    // nur für rohes PCM (bei WAV aus dem Header)
+        int numChannels = 2;            // nur für rohes PCM
+        SampleFormat format = SampleFormat::float32; // nur für rohes PCM
+        int blockSize = 2048;           // Blockgröße für processBlock()
+        juce::File healthFile;          // Health-Zähler am Ende als CSV, leer = keine
+    };
+
+    explicit StreamRenderer(Settings settingsToUse);
+
+    // Verarbeitet bis EOF. Muss auf dem Message-Thread laufen (Processor-Erzeugung).
+    juce::Result run(std::FILE* input, std::FILE* output);
+
+    juce::int64 getFramesProcessed() const noexcept { return framesProcessed; }
+
+    // "s16", "s24", "s32", "f32"
+    static bool parseSampleFormat(const juce::String& text, SampleFormat& format);
+
+private:
+    Settings settings;
+    juce::int64 framesProcessed = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamRenderer)
+};
@@ -0,0 +1,347 @@
+﻿#include "../BenchmarkReport.h"
+#include "../BenchmarkUtils.h"
+#include "../../../Source/AllocationCounter.h"
+#include "../../../Source/PluginProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+//==============================================================================
+// MasteringEQAutomationBench: Worst-Case-Latenz von processBlock() unter
+// dichter Automation aller 62 Band-Parameter plus inputGain
+//
+//   MasteringEQAutomationBench --json=nachher.json --baseline=vorher.json
+//
+// Sample-genaue Automation liefert ein Host, indem er den Block an jedem
+// Automationspunkt teilt und die Parameter davor setzt. Genau das macht die
+// Host-Schleife hier: Jeder Teilblock setzt alle 63 Parameter auf den
+// Rampenwert an seiner Startposition, löst damit filtersNeedUpdate aus und
+// läuft durch updateFilters(). Rampen und Eingangssignal sind
+// deterministisch, die Läufe also reproduzierbar.
+//
+// Allokationen werden nur mit -DMASTERINGEQ_COUNT_ALLOCATIONS=ON gezählt.
+namespace
+{
+    constexpr int kNumBands = 31;
+
+    struct Case
+    {
+        int blockSize = 512;
+        int stepSize = 1;        // Abstand der Automationspunkte in Samples
+        bool automated = true;   // false = gleiche Teilung ohne Parameteränderung
+
+        juce::String getKey() const
+        {
+            return "b" + juce::String(blockSize) + "_step" + juce::String(stepSize)
+                 + (automated ? "_automated" : "_static");
+        }
+    };
+
+    struct Options
+    {
+        juce::Array<int> blockSizes{ 64, 256, 1024 };
+        juce::Array<int> stepSizes{ 1, 8, 32, 128 };
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        double seconds = 5.0;
+        juce::String metric = "p99Us";
+    };
+
+    //==============================================================================
+    // Parameterzeiger einmal holen: in der Host-Schleife keine Strings bauen
+    // (würde die Allokationszählung verfälschen)
+    struct AutomatedParameters
+    {
+        explicit AutomatedParameters(AudioPluginAudioProcessor& processor)
+        {
+            auto get = [&](const juce::String& id)
+                {
+                    auto* p = dynamic_cast<juce::RangedAudioParameter*>(processor.apvts.getParameter(id));
+                    jassert(p != nullptr);
+                    return p;
+                };
+
+            for (int i = 0; i < kNumBands; ++i)
+            {
+                gains[(size_t)i] = get("band" + juce::String(i));
+                qs[(size_t)i] = get("bandQ" + juce::String(i));
+            }
+
+            inputGain = get("inputGain");
+        }
+
+        // Dreieck-Rampen über den (normalisierten) Bereich, je Band eigene
+        // Periode und Phase, damit sich in jedem Teilblock alle Werte ändern
+        void applyAt(juce::int64 samplePosition, double sampleRate)
+        {
+            const double t = (double)samplePosition / sampleRate;
+
+            auto triangle = [](double phase)
+                {
+                    const double x = phase - std::floor(phase);
+                    return (float)(x < 0.5 ? 2.0 * x : 2.0 - 2.0 * x);
+                };
+
+            for (int i = 0; i < kNumBands; ++i)
+            {
+                const double rate = 0.5 + 0.07 * (double)i;   // Rampen je Sekunde
+                gains[(size_t)i]->setValueNotifyingHost(triangle(rate * t + 0.031 * (double)i));
+                qs[(size_t)i]->setValueNotifyingHost(0.2f + 0.6f * triangle(0.8 * rate * t + 0.5));
+            }
+
+            inputGain->setValueNotifyingHost(0.3f + 0.4f * triangle(0.25 * t));
+        }
+
+        std::array<juce::RangedAudioParameter*, kNumBands> gains{};
+        std::array<juce::RangedAudioParameter*, kNumBands> qs{};
+        juce::RangedAudioParameter* inputGain = nullptr;
+    };
+
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        return sorted[juce::jmin(sorted.size() - 1, (size_t)(p * (double)sorted.size()))];
+    }
+
+    double ticksToUs(juce::int64 ticks)
+    {
+        return 1.0e6 * juce::Time::highResolutionTicksToSeconds(ticks);
+    }
+
+    //==============================================================================
+    // Einen Fall messen. Zeiten in µs je Host-Block (alle Teilblöcke inkl.
+    // Parameter setzen), der Worst Case zusätzlich je processBlock()-Aufruf.
+    void runCase(const Case& c, const Options& options, juce::NamedValueSet& values)
+    {
+        AudioPluginAudioProcessor processor;
+        processor.setPlayConfigDetails(options.numChannels, options.numChannels, options.sampleRate, c.blockSize);
+        processor.prepareToPlay(options.sampleRate, c.blockSize);
+
+        AutomatedParameters parameters(processor);
+        parameters.applyAt(0, options.sampleRate);
+
+        // Rauschen bei -12 dBFS, fester Seed
+        const int sourceLength = 1 << 16;
+        juce::AudioBuffer<float> source(options.numChannels, sourceLength);
+        juce::Random random(0x4155544f);
+        for (int ch = 0; ch < options.numChannels; ++ch)
+            for (int i = 0; i < sourceLength; ++i)
+                source.setSample(ch, i, 0.25f * (random.nextFloat() * 2.0f - 1.0f));
+
+        juce::AudioBuffer<float> buffer(options.numChannels, c.blockSize);
+        juce::MidiBuffer midi;
+
+        const int warmupBlocks = juce::jmax(4, 8192 / c.blockSize);
+        const int numBlocks = juce::jmax(16, (int)(options.seconds * options.sampleRate) / c.blockSize);
+        const double deadlineUs = 1.0e6 * c.blockSize / options.sampleRate;
+
+        std::vector<double> blockUs;
+        blockUs.reserve((size_t)numBlocks);
+
+        double worstCallUs = 0.0;
+        juce::int64 numCalls = 0;
+        int overruns = 0;
+        std::uint64_t processAllocations = 0;
+        std::uint64_t parameterAllocations = 0;
+        std::uint64_t worstBlockAllocations = 0;
+        juce::int64 position = 0;
+
+        for (int block = -warmupBlocks; block < numBlocks; ++block)
+        {
+            const int sourcePos = (int)(position % (sourceLength - c.blockSize + 1));
+            for (int ch = 0; ch < options.numChannels; ++ch)
+                buffer.copyFrom(ch, 0, source, ch, sourcePos, c.blockSize);
+
+            std::uint64_t blockAllocations = 0;
+            const auto blockStart = juce::Time::getHighResolutionTicks();
+
+            for (int start = 0; start < c.blockSize; start += c.stepSize)
+            {
+                const int len = juce::jmin(c.stepSize, c.blockSize - start);
+
+                if (c.automated)
+                {
+                    const auto before = AllocationCounter::getCount();
+                    parameters.applyAt(position + start, options.sampleRate);
+                    parameterAllocations += block >= 0 ? AllocationCounter::getCount() - before : 0;
+                }
+
+                // Teilblock als Sicht auf den Host-Puffer (keine Kopie)
+                juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(), options.numChannels, start, len);
+
+                const auto allocationsBefore = AllocationCounter::getCount();
+                const auto callStart = juce::Time::getHighResolutionTicks();
+
+                processor.processBlock(view, midi);
+
+                const auto callEnd = juce::Time::getHighResolutionTicks();
+                blockAllocations += AllocationCounter::getCount() - allocationsBefore;
+
+                if (block >= 0)
+                {
+                    worstCallUs = juce::jmax(worstCallUs, ticksToUs(callEnd - callStart));
+                    ++numCalls;
+                }
+            }
+
+            const double us = ticksToUs(juce::Time::getHighResolutionTicks() - blockStart);
+            position += c.blockSize;
+
+            if (block < 0)
+                continue;
+
+            blockUs.push_back(us);
+            overruns += us > deadlineUs ? 1 : 0;
+            processAllocations += blockAllocations;
+            worstBlockAllocations = juce::jmax(worstBlockAllocations, blockAllocations);
+        }
+
+        // updateFilters() allein: Parameter ändern, dann nur die Koeffizienten
+        std::vector<double> updateUs;
+        if (c.automated)
+        {
+            const int numUpdates = 2000;
+            updateUs.reserve((size_t)numUpdates);
+
+            for (int i = 0; i < numUpdates; ++i)
+            {
+                parameters.applyAt(position + i * c.stepSize, options.sampleRate);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                processor.updateFilters();
+                updateUs.push_back(ticksToUs(juce::Time::getHighResolutionTicks() - start));
+            }
+
+            std::sort(updateUs.begin(), updateUs.end());
+        }
+
+        processor.releaseResources();
+
+        std::vector<double> sorted = blockUs;
+        std::sort(sorted.begin(), sorted.end());
+
+        const bool counting = AllocationCounter::isEnabled();
+
+        values.set("blockSize", c.blockSize);
+        values.set("stepSize", c.stepSize);
+        values.set("automation", c.automated ? "automated" : "static");
+        values.set("sampleRate", options.sampleRate);
+        values.set("channels", options.numChannels);
+        values.set("blocks", (int)blockUs.size());
+        values.set("processCalls", numCalls);
+        values.set("deadlineUs", deadlineUs);
+        values.set("medianUs", percentile(sorted, 0.5));
+        values.set("p99Us", percentile(sorted, 0.99));
+        values.set("p999Us", percentile(sorted, 0.999));
+        values.set("worstUs", sorted.back());
+        values.set("worstCallUs", worstCallUs);
+        values.set("overruns", overruns);
+
+        // -1 = nicht gezählt (Build ohne MASTERINGEQ_COUNT_ALLOCATIONS)
+        values.set("allocationsInProcess", counting ? (juce::int64)processAllocations : (juce::int64)-1);
+        values.set("allocationsPerBlockMax", counting ? (juce::int64)worstBlockAllocations : (juce::int64)-1);
+        values.set("allocationsInParameters", counting ? (juce::int64)parameterAllocations : (juce::int64)-1);
+
+        if (!updateUs.empty())
+        {
+            values.set("updateFiltersUs", percentile(updateUs, 0.5));
+            values.set("updateFiltersUsMax", updateUs.back());
+        }
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: MasteringEQAutomationBench [options]\n"
+            << "\n"
+            << "  --blocks=<liste>     Host-Blockgrößen (Standard: 64,256,1024)\n"
+            << "  --steps=<liste>      Abstand der Automationspunkte in Samples (Standard: 1,8,32,128)\n"
+            << "  --rate=<hz>          Samplerate (Standard: 48000)\n"
+            << "  --channels=<n>       1 oder 2 (Standard: 2)\n"
+            << "  --seconds=<s>        gemessene Audiodauer je Fall (Standard: 5)\n"
+            << "  --json=<file>        Ergebnisse als JSON schreiben\n"
+            << "  --baseline=<file>    mit früherem JSON vergleichen\n"
+            << "  --metric=<name>      Vergleichswert: medianUs, p99Us, p999Us, worstUs (Standard: p99Us)\n"
+            << "  --tolerance=<pct>    Rauschgrenze für den Vergleich (Standard: 5)\n"
+            << "\n"
+            << "Allokationen nur mit -DMASTERINGEQ_COUNT_ALLOCATIONS=ON, sonst -1.\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit; // Processor braucht einen MessageManager
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Options options;
+
+    if (args.containsOption("--blocks"))
+        options.blockSizes = BenchmarkUtils::parseList<int>(args.getValueForOption("--blocks"));
+
+    if (args.containsOption("--steps"))
+        options.stepSizes = BenchmarkUtils::parseList<int>(args.getValueForOption("--steps"));
+
+    if (args.containsOption("--rate"))
+        options.sampleRate = juce::jmax(8000.0, args.getValueForOption("--rate").getDoubleValue());
+
+    if (args.containsOption("--channels"))
+        options.numChannels = juce::jlimit(1, 2, args.getValueForOption("--channels").getIntValue());
+
+    if (args.containsOption("--seconds"))
+        options.seconds = juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue());
+
+    if (args.containsOption("--metric"))
+        options.metric = args.getValueForOption("--metric");
+
+    if (!AllocationCounter::isEnabled())
+        std::cout << "Hinweis: Allokationszählung nicht einkompiliert (MASTERINGEQ_COUNT_ALLOCATIONS=OFF)\n\n";
+
+    BenchmarkReport report("automationStress");
+    bool allocated = false;
+
+    for (const int blockSize : options.blockSizes)
+        for (const int stepSize : options.stepSizes)
+        {
+            // Schrittweite >= Block = eine Änderung pro Block, größere Werte wären Duplikate
+            if (stepSize > blockSize)
+                continue;
+
+            for (const bool automated : { false, true })
+            {
+                Case c;
+                c.blockSize = juce::jmax(1, blockSize);
+                c.stepSize = juce::jmax(1, stepSize);
+                c.automated = automated;
+
+                juce::NamedValueSet values;
+                runCase(c, options, values);
+
+                std::cout << c.getKey() << ": p99 " << juce::String((double)values["p99Us"], 1)
+                          << " µs, worst " << juce::String((double)values["worstUs"], 1)
+                          << " µs (Deadline " << juce::String((double)values["deadlineUs"], 0)
+                          << " µs, " << (int)values["overruns"] << " Überläufe)";
+
+                if (values.contains("updateFiltersUs"))
+                    std::cout << ", updateFilters " << juce::String((double)values["updateFiltersUs"], 2) << " µs";
+
+                if ((juce::int64)values["allocationsInProcess"] > 0)
+                {
+                    std::cout << ", " << (juce::int64)values["allocationsInProcess"] << " Allokationen!";
+                    allocated = true;
+                }
+
+                std::cout << "\n";
+                report.add(c.getKey(), values);
+            }
+        }
+
+    if (allocated)
+        std::cout << "\nprocessBlock() hat unter Automation allokiert\n";
+
+    return report.finish(args, options.metric, true);
+}
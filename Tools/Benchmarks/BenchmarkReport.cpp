@@ -0,0 +1,178 @@
+﻿#include "BenchmarkReport.h"
+#include <iostream>
+#include <map>
+#include <ostream>
+
+namespace
+{
+    // Format-Version der JSON-Datei (bei inkompatiblen Änderungen erhöhen)
+    constexpr int kReportVersion = 1;
+}
+
+//==============================================================================
+BenchmarkReport::BenchmarkReport(juce::String benchmarkName)
+    : name(std::move(benchmarkName))
+{
+}
+
+void BenchmarkReport::add(const juce::String& key, const juce::NamedValueSet& values)
+{
+    auto* entry = new juce::DynamicObject();
+    entry->setProperty("key", key);
+
+    for (const auto& value : values)
+        entry->setProperty(value.name, value.value);
+
+    results.add(juce::var(entry));
+}
+
+//==============================================================================
+// Ergebnisse plus Umgebung (CPU, Build), damit Baselines nachvollziehbar bleiben
+juce::String BenchmarkReport::toJson() const
+{
+    auto* environment = new juce::DynamicObject();
+    environment->setProperty("cpu", juce::SystemStats::getCpuModel());
+    environment->setProperty("cores", juce::SystemStats::getNumPhysicalCpus());
+    environment->setProperty("threads", juce::SystemStats::getNumCpus());
+    environment->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    environment->setProperty("buildDate", juce::String(__DATE__) + " " + __TIME__);
+   #if JUCE_DEBUG
+    environment->setProperty("buildType", "Debug");
+   #else
+    environment->setProperty("buildType", "Release");
+   #endif
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("benchmark", name);
+    root->setProperty("version", kReportVersion);
+    root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("environment", juce::var(environment));
+    root->setProperty("results", results);
+
+    return juce::JSON::toString(juce::var(root));
+}
+
+bool BenchmarkReport::writeTo(const juce::File& file) const
+{
+    return file.replaceWithText(toJson());
+}
+
+//==============================================================================
+/**
+ * @brief Vergleicht eine Kennzahl mit einer gespeicherten Baseline.
+ *
+ * Abweichungen werden relativ zur Baseline in Prozent ausgegeben
+ * (positiv = besser). Einträge, die nur in einem der Reports vorkommen,
+ * werden übersprungen.
+ *
+ * @param baseline         Früher mit writeTo() geschriebene Datei
+ * @param metric           Name der Kennzahl (z.B. "nsPerSample")
+ * @param higherIsBetter   Richtung der Kennzahl
+ * @param tolerancePercent Rauschgrenze, ab der eine Abweichung zählt
+ * @param out              Ausgabe der Vergleichstabelle
+ */
+BenchmarkReport::Comparison BenchmarkReport::compareWith(const juce::File& baseline, const juce::String& metric,
+    bool higherIsBetter, double tolerancePercent, std::ostream& out) const
+{
+    Comparison comparison;
+
+    const auto parsed = juce::JSON::parse(baseline);
+    if (!parsed.isObject())
+    {
+        comparison.error = "Baseline nicht lesbar: " + baseline.getFullPathName();
+        return comparison;
+    }
+
+    if (parsed["benchmark"].toString() != name)
+    {
+        comparison.error = "Baseline stammt von \"" + parsed["benchmark"].toString() + "\", nicht von \"" + name + "\"";
+        return comparison;
+    }
+
+    std::map<juce::String, double> baselineValues;
+    if (const auto* baselineResults = parsed["results"].getArray())
+        for (const auto& entry : *baselineResults)
+            if (entry.hasProperty(juce::Identifier(metric)))
+                baselineValues[entry["key"].toString()] = (double)entry[juce::Identifier(metric)];
+
+    for (const auto& entry : results)
+    {
+        const auto key = entry["key"].toString();
+        const auto it = baselineValues.find(key);
+
+        if (it == baselineValues.end() || !(it->second > 0.0))
+            continue;
+
+        const double current = (double)entry[juce::Identifier(metric)];
+        const double changePercent = 100.0 * (current - it->second) / it->second;
+        const double gainPercent = higherIsBetter ? changePercent : -changePercent;
+
+        const char* verdict = "";
+        if (gainPercent < -tolerancePercent)
+        {
+            verdict = "  REGRESSION";
+            ++comparison.regressions;
+        }
+        else if (gainPercent > tolerancePercent)
+        {
+            verdict = "  besser";
+            ++comparison.improvements;
+        }
+
+        ++comparison.matched;
+
+        out << key << ": " << juce::String(it->second, 3) << " -> " << juce::String(current, 3)
+            << " (" << (gainPercent >= 0.0 ? "+" : "") << juce::String(gainPercent, 1) << " %)"
+            << verdict << "\n";
+    }
+
+    return comparison;
+}
+
+//==============================================================================
+/**
+ * @brief Schreibt den Report und vergleicht ihn optional mit einer Baseline.
+ *
+ * Pfade sind relativ zum Arbeitsverzeichnis. Ohne --baseline wird nur
+ * geschrieben (falls --json gesetzt ist).
+ *
+ * @param args          Kommandozeile des Benchmarks
+ * @param metricKey     Kennzahl für den Vergleich (z.B. "nsPerSample")
+ * @param lowerIsBetter true für Zeiten und Last, false für Durchsatz
+ * @return 0 ok, 1 JSON nicht schreibbar oder Baseline unbrauchbar, 2 Regressionen (für CI)
+ */
+int BenchmarkReport::finish(const juce::ArgumentList& args, const juce::String& metricKey, bool lowerIsBetter) const
+{
+    if (args.containsOption("--json"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--json").unquoted());
+
+        if (!writeTo(file))
+        {
+            std::cerr << "JSON nicht schreibbar: " << file.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    if (!args.containsOption("--baseline"))
+        return 0;
+
+    const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--baseline").unquoted());
+    const double tolerance = args.containsOption("--tolerance") ? args.getValueForOption("--tolerance").getDoubleValue() : 5.0;
+
+    std::cout << "\nVergleich mit " << file.getFullPathName() << " (" << metricKey << ", Toleranz "
+              << juce::String(tolerance, 1) << " %)\n";
+
+    const auto comparison = compareWith(file, metricKey, !lowerIsBetter, tolerance, std::cout);
+
+    if (comparison.error.isNotEmpty())
+    {
+        std::cerr << comparison.error << "\n";
+        return 1;
+    }
+
+    std::cout << comparison.matched << " verglichen, " << comparison.improvements << " besser, "
+              << comparison.regressions << " Regressionen\n";
+
+    return comparison.regressions > 0 ? 2 : 0;
+}
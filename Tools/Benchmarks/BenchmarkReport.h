@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+#include <iosfwd>
+
+//==============================================================================
+// Gemeinsames Ergebnisformat der Benchmarks
+//
+// Jede Messung ist ein Eintrag mit eindeutigem Schlüssel (z.B. "b64_sr48000_ch2")
+// und beliebigen Zahlen/Texten. Der Report wird als JSON geschrieben und kann
+// später als Baseline für einen Vergleich dienen: Einträge werden über den
+// Schlüssel zugeordnet, verglichen wird eine ausgewählte Kennzahl.
+class BenchmarkReport
+{
+public:
+    explicit BenchmarkReport(juce::String benchmarkName);
+
+    // Neuer Eintrag; die Werte werden unter "results" abgelegt
+    void add(const juce::String& key, const juce::NamedValueSet& values);
+
+    int size() const noexcept { return results.size(); }
+
+    juce::String toJson() const;
+    bool writeTo(const juce::File& file) const;
+
+    struct Comparison
+    {
+        int matched = 0;        // in beiden Reports vorhanden
+        int regressions = 0;    // schlechter als die Toleranz erlaubt
+        int improvements = 0;   // besser als die Toleranz
+        juce::String error;     // Baseline nicht lesbar / falscher Benchmark
+    };
+
+    // Vergleicht "metric" mit der Baseline und druckt je Eintrag die Abweichung.
+    // higherIsBetter: true für Durchsatz, false für Zeiten.
+    Comparison compareWith(const juce::File& baseline, const juce::String& metric,
+        bool higherIsBetter, double tolerancePercent, std::ostream& out) const;
+
+    // Gemeinsamer Abschluss aller Benchmarks: --json schreiben, bei --baseline
+    // (mit --tolerance, Standard 5 %) "metricKey" vergleichen. Liefert den
+    // Exit-Code: 0 ok, 1 JSON/Baseline nicht nutzbar, 2 Regressionen.
+    int finish(const juce::ArgumentList& args, const juce::String& metricKey, bool lowerIsBetter) const;
+
+private:
+    juce::String name;
+    juce::Array<juce::var> results;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BenchmarkReport)
+};
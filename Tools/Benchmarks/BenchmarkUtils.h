@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+//==============================================================================
+// Kleine Helfer, die mehrere Benchmarks teilen
+namespace BenchmarkUtils
+{
+    // Kommagetrennte Zahlenliste ("64,256,1024"); leere Einträge werden übersprungen
+    template <typename T>
+    juce::Array<T> parseList(const juce::String& text)
+    {
+        juce::Array<T> list;
+        for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            if (token.trim().isNotEmpty())
+                list.add((T)token.trim().getDoubleValue());
+
+        return list;
+    }
+
+    // Parameter über den Host-Weg setzen (wie Automation aus der DAW)
+    inline void setParameter(juce::RangedAudioParameter& p, float value)
+    {
+        p.setValueNotifyingHost(p.convertTo0to1(p.getNormalisableRange().snapToLegalValue(value)));
+    }
+
+    inline void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float value)
+    {
+        if (auto* p = dynamic_cast<juce::RangedAudioParameter*>(apvts.getParameter(id)))
+            setParameter(*p, value);
+    }
+}
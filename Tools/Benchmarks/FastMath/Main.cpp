@@ -0,0 +1,279 @@
+﻿#include "../BenchmarkReport.h"
+#include "../../../Source/EQResponseCache.h"
+#include "../../../Source/FastMath.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+//==============================================================================
+// MasteringEQMathBench: Genauigkeit und Tempo der FastMath-Kerne
+//
+//   MasteringEQMathBench --json=nachher.json --baseline=vorher.json
+//
+// Je Kern: ns/Wert schnell und exakt (std::log10/std::pow), maximaler
+// Fehler gegen double über +-100 dB und ob er in der dokumentierten Schranke
+// liegt. Dazu der EQ-Frequenzgang-Cache als Ende-zu-Ende-Pfad. Exit-Code 1,
+// wenn eine Schranke verletzt ist.
+namespace
+{
+    using ArrayKernel = void (*)(float*, const float*, int);
+
+    struct Kernel
+    {
+        const char* name;
+        ArrayKernel kernel;
+        double (*reference)(double);
+        double inputMin;            // Eingabebereich; bei logInput als Zehnerexponent
+        double inputMax;
+        bool logInput;              // Eingabe log. verteilt (Leistung/Amplitude)
+        bool relativeError;         // Fehler relativ statt absolut in dB
+        double bound;               // Schranke aus FastMath.h
+    };
+
+    const Kernel kKernels[] = {
+        { "powerToDb",
+          [](float* d, const float* s, int n) { FastMath::powerToDb(d, s, n, -400.0f); },
+          [](double x) { return 10.0 * std::log10(x); }, -10.0, 10.0, true, false, 1.1e-5 },
+        { "gainToDb",
+          [](float* d, const float* s, int n) { FastMath::gainToDb(d, s, n, -400.0f); },
+          [](double x) { return 20.0 * std::log10(x); }, -5.0, 5.0, true, false, 1.1e-5 },
+        { "dbToPower",
+          [](float* d, const float* s, int n) { FastMath::dbToPower(d, s, n); },
+          [](double db) { return std::pow(10.0, db / 10.0); }, -100.0, 100.0, false, true, 2.0e-6 },
+        { "dbToGain",
+          [](float* d, const float* s, int n) { FastMath::dbToGain(d, s, n); },
+          [](double db) { return std::pow(10.0, db / 20.0); }, -100.0, 100.0, false, true, 2.0e-6 },
+    };
+
+    struct Options
+    {
+        int size = 2048;                // Werte je Aufruf (~ EQ-Cache-Raster)
+        int callsPerRound = 2000;
+        int rounds = 5;                 // schnellste Runde zählt
+        int errorSamples = 1 << 20;     // Stützstellen für den Fehler
+    };
+
+    template <typename Function>
+    double bestSecondsOf(int rounds, Function&& function)
+    {
+        double best = 0.0;
+
+        for (int r = 0; r < rounds; ++r)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            function();
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            if (r == 0 || seconds < best)
+                best = seconds;
+        }
+
+        return best;
+    }
+
+    std::vector<float> makeInput(const Kernel& k, int size)
+    {
+        std::vector<float> input((size_t)size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            const double u = k.inputMin + (k.inputMax - k.inputMin) * (double)i / (double)juce::jmax(1, size - 1);
+            input[(size_t)i] = (float)(k.logInput ? std::pow(10.0, u) : u);
+        }
+
+        return input;
+    }
+
+    //==============================================================================
+    void runKernel(const Kernel& k, const Options& options, juce::NamedValueSet& values)
+    {
+        // Fehler über ein feines Raster
+        const auto samples = makeInput(k, options.errorSamples);
+        std::vector<float> output(samples.size());
+
+        FastMath::setExact(false);
+        k.kernel(output.data(), samples.data(), (int)samples.size());
+
+        double maxError = 0.0;
+
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            const double expected = k.reference((double)samples[i]);
+            const double error = k.relativeError ? std::abs((double)output[i] / expected - 1.0)
+                                                 : std::abs((double)output[i] - expected);
+            maxError = std::max(maxError, error);
+        }
+
+        // Tempo: gleicher Puffer immer wieder (bleibt im Cache)
+        const auto input = makeInput(k, options.size);
+        std::vector<float> dest(input.size());
+        float sink = 0.0f;
+
+        auto timeMode = [&](bool exact)
+            {
+                FastMath::setExact(exact);
+
+                const double seconds = bestSecondsOf(options.rounds, [&]
+                    {
+                        for (int c = 0; c < options.callsPerRound; ++c)
+                        {
+                            k.kernel(dest.data(), input.data(), options.size);
+                            sink += dest[(size_t)c % dest.size()];
+                        }
+                    });
+
+                return 1.0e9 * seconds / ((double)options.callsPerRound * (double)options.size);
+            };
+
+        const double fastNs = timeMode(false);
+        const double exactNs = timeMode(true);
+        FastMath::setExact(false);
+
+        values.set("fastNsPerValue", fastNs);
+        values.set("exactNsPerValue", exactNs);
+        values.set("speedup", fastNs > 0.0 ? exactNs / fastNs : 0.0);
+        values.set(k.relativeError ? "maxRelativeError" : "maxErrorDb", maxError);
+        values.set("bound", k.bound);
+        values.set("withinBound", maxError <= k.bound);
+        values.set("sink", (double)sink);   // verhindert, dass die Schleife wegoptimiert wird
+    }
+
+    //==============================================================================
+    // Ende-zu-Ende: alle 31 Bänder des Anzeige-Caches neu berechnen
+    void runResponseCache(const Options& options, juce::NamedValueSet& values)
+    {
+        std::array<float, EQResponseCache::numBands> bandFreqs{};
+        for (int i = 0; i < EQResponseCache::numBands; ++i)
+            bandFreqs[(size_t)i] = 20.0f * std::pow(2.0f, (float)i / 3.0f);
+
+        auto runSweep = [&](EQResponseCache& cache, int pass)
+            {
+                for (int b = 0; b < EQResponseCache::numBands; ++b)
+                {
+                    const float gain = -12.0f + 24.0f * (float)((b * 7 + pass) % 25) / 24.0f;
+                    cache.setBand(b, gain, 1.0f + 0.25f * (float)((b + pass) % 16));
+                }
+            };
+
+        auto timeMode = [&](bool exact, std::vector<float>& lastTotal)
+            {
+                FastMath::setExact(exact);
+
+                EQResponseCache cache;
+                cache.prepare(bandFreqs, 48000.0, 20.0f, 20000.0f);
+
+                const int sweeps = juce::jmax(1, options.callsPerRound / 20);
+                int pass = 0;
+
+                const double seconds = bestSecondsOf(options.rounds, [&]
+                    {
+                        for (int s = 0; s < sweeps; ++s)
+                            runSweep(cache, ++pass);
+                    });
+
+                // Gleicher Endzustand für den Vergleich schnell/exakt
+                runSweep(cache, 0);
+                lastTotal = cache.getTotalDb();
+
+                return 1.0e9 * seconds / ((double)sweeps * EQResponseCache::numBands);
+            };
+
+        std::vector<float> fastTotal, exactTotal;
+        const double fastNs = timeMode(false, fastTotal);
+        const double exactNs = timeMode(true, exactTotal);
+        FastMath::setExact(false);
+
+        double maxDiff = 0.0;
+        for (size_t i = 0; i < fastTotal.size() && i < exactTotal.size(); ++i)
+            maxDiff = std::max(maxDiff, (double)std::abs(fastTotal[i] - exactTotal[i]));
+
+        // 31 Bänder summiert, Schranke je Band aufaddiert (plus float-Summe)
+        constexpr double bound = 1.0e-3;
+
+        values.set("fastNsPerValue", fastNs);
+        values.set("exactNsPerValue", exactNs);
+        values.set("speedup", fastNs > 0.0 ? exactNs / fastNs : 0.0);
+        values.set("maxErrorDb", maxDiff);
+        values.set("bound", bound);
+        values.set("withinBound", maxDiff <= bound);
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: MasteringEQMathBench [options]\n"
+            << "\n"
+            << "  --size=<n>           Werte je Aufruf (Standard: 2048)\n"
+            << "  --calls=<n>          Aufrufe je Runde (Standard: 2000)\n"
+            << "  --reps=<n>           Runden, schnellste zählt (Standard: 5)\n"
+            << "  --json=<file>        Ergebnisse als JSON schreiben\n"
+            << "  --baseline=<file>    mit früherem JSON vergleichen (ns/Wert schnell)\n"
+            << "  --tolerance=<pct>    Rauschgrenze für den Vergleich (Standard: 5)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Options options;
+
+    if (args.containsOption("--size"))
+        options.size = juce::jmax(16, args.getValueForOption("--size").getIntValue());
+
+    if (args.containsOption("--calls"))
+        options.callsPerRound = juce::jmax(1, args.getValueForOption("--calls").getIntValue());
+
+    if (args.containsOption("--reps"))
+        options.rounds = juce::jmax(1, args.getValueForOption("--reps").getIntValue());
+
+    BenchmarkReport report("fastMath");
+    int violations = 0;
+
+    auto addResult = [&](const juce::String& key, const juce::NamedValueSet& values)
+        {
+            const bool within = values["withinBound"];
+            const auto errorKey = values.contains("maxRelativeError") ? "maxRelativeError" : "maxErrorDb";
+
+            std::cout << key << ": " << juce::String((double)values["fastNsPerValue"], 3) << " ns/Wert schnell, "
+                      << juce::String((double)values["exactNsPerValue"], 3) << " ns/Wert exakt ("
+                      << juce::String((double)values["speedup"], 1) << "x), Fehler "
+                      << juce::String((double)values[errorKey], 10) << (within ? "" : "  SCHRANKE VERLETZT") << "\n";
+
+            if (!within)
+                ++violations;
+
+            report.add(key, values);
+        };
+
+    for (const auto& kernel : kKernels)
+    {
+        juce::NamedValueSet values;
+        runKernel(kernel, options, values);
+        addResult(kernel.name, values);
+    }
+
+    {
+        juce::NamedValueSet values;
+        runResponseCache(options, values);
+        addResult("eqResponseCache", values);
+    }
+
+    const int result = report.finish(args, "fastNsPerValue", true);
+
+    if (violations > 0)
+    {
+        std::cerr << violations << " Fehlerschranke(n) verletzt\n";
+        return 1;
+    }
+
+    return result;
+}
@@ -0,0 +1,238 @@
+﻿#include "../BenchmarkReport.h"
+#include "../BenchmarkUtils.h"
+#include "../../../Source/PluginEditor.h"
+#include "../../../Source/PluginProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+
+//==============================================================================
+// MasteringEQGuiBench: paint() des Editors offscreen in ein juce::Image
+//
+// Der Editor wird ohne Fenster erzeugt; pro Frame läuft wie im Plugin ein
+// Block Audio durch den Processor, der Analyzer wird übernommen
+// (pullDisplayData) und das ganze Fenster inkl. Kinder gerendert. Die
+// Zeiten je draw*-Funktion kommen aus dem PaintProfiler des Editors.
+namespace
+{
+    constexpr double kSampleRate = 48000.0;
+    constexpr int kBlockSize = 2048;   // ~ ein Analyzer-Frame pro gerendertem Frame
+
+    struct State
+    {
+        const char* name;
+        bool eqView;
+        bool reference;
+        bool target;
+        bool movingGains;   // Gains ändern sich jeden Frame (Drag/Automation)
+    };
+
+    constexpr State kStates[] = {
+        { "spectrum",          false, false, false, false },
+        { "spectrumReference", false, true,  false, false },
+        { "eqCurve",           true,  false, false, false },
+        { "eqCurveMoving",     true,  false, false, true },
+        { "eqTarget",          true,  true,  true,  false },
+    };
+
+    //==============================================================================
+    void setBandGains(AudioPluginAudioProcessor& processor, int frame)
+    {
+        for (int i = 0; i < 31; ++i)
+            BenchmarkUtils::setParameter(processor.apvts, "band" + juce::String(i),
+                4.0f * std::sin(0.3f * (float)i + 0.1f * (float)frame));
+    }
+
+    // Referenz mit typischer Neigung (-3 dB/Oktave) und ±3 dB Streuung
+    void setSyntheticReference(AudioPluginAudioProcessor& processor)
+    {
+        const auto& freqs = processor.getFilterFrequencies();
+        processor.referenceBands.clear();
+
+        for (const float f : freqs)
+        {
+            AudioPluginAudioProcessor::ReferenceBand band;
+            band.freq = f;
+            band.median = -60.0f - 3.0f * std::log2(f / 1000.0f);
+            band.p10 = band.median - 3.0f;
+            band.p90 = band.median + 3.0f;
+            processor.referenceBands.push_back(band);
+        }
+
+        processor.referenceBandsChanged();
+    }
+
+    void setTarget(AudioPluginAudioProcessor& processor)
+    {
+        std::array<float, 31> target{};
+        for (int i = 0; i < 31; ++i)
+            target[(size_t)i] = 3.0f * std::cos(0.25f * (float)i);
+
+        processor.setTargetResiduals(target);
+        processor.setTargetCorrections(target);
+    }
+
+    struct Options
+    {
+        int frames = 300;
+        int warmupFrames = 20;
+        int width = 0;      // 0 = Standardgröße des Editors
+        int height = 0;
+    };
+
+    //==============================================================================
+    // Einen Zustand rendern; relayout = statische Ebenen jeden Frame neu
+    void runState(const State& state, bool relayout, const Options& options, BenchmarkReport& report)
+    {
+        AudioPluginAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, kSampleRate, kBlockSize);
+        processor.prepareToPlay(kSampleRate, kBlockSize);
+
+        if (state.reference)
+            setSyntheticReference(processor);
+
+        if (state.target)
+            setTarget(processor);
+
+        if (state.eqView)
+            setBandGains(processor, 0);
+
+        AudioPluginAudioProcessorEditor editor(processor);
+
+        if (options.width > 0 && options.height > 0)
+            editor.setSize(options.width, options.height);
+
+        editor.setEQCurveView(state.eqView);
+
+        PaintProfiler profiler;
+        juce::Image image(juce::Image::ARGB, editor.getWidth(), editor.getHeight(), true);
+
+        juce::AudioBuffer<float> buffer(2, kBlockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(0x47554921);
+
+        std::vector<double> frameMs;
+        frameMs.reserve((size_t)options.frames);
+
+        for (int frame = -options.warmupFrames; frame < options.frames; ++frame)
+        {
+            // Neues Audio -> neuer Analyzer-Frame (leicht schwankender Pegel)
+            const float level = 0.1f + 0.05f * std::sin(0.05f * (float)frame);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < kBlockSize; ++i)
+                    buffer.setSample(ch, i, level * (random.nextFloat() * 2.0f - 1.0f));
+
+            processor.processBlock(buffer, midi);
+
+            if (state.movingGains)
+                setBandGains(processor, frame);
+
+            if (relayout)
+                editor.invalidateStaticLayers();
+
+            // Messung erst nach dem Aufwärmen
+            if (frame == 0)
+            {
+                profiler.reset();
+                editor.setPaintProfiler(&profiler);
+            }
+
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            editor.pullDisplayData();
+            {
+                juce::Graphics g(image);
+                editor.paintEntireComponent(g, true);
+            }
+
+            if (frame >= 0)
+                frameMs.push_back(1000.0 * juce::Time::highResolutionTicksToSeconds(
+                    juce::Time::getHighResolutionTicks() - start));
+        }
+
+        editor.setPaintProfiler(nullptr);
+        processor.releaseResources();
+
+        std::vector<double> sorted = frameMs;
+        std::sort(sorted.begin(), sorted.end());
+
+        const double median = sorted[sorted.size() / 2];
+        const double p95 = sorted[juce::jmin(sorted.size() - 1, (size_t)(0.95 * (double)sorted.size()))];
+
+        const juce::String key = juce::String(state.name) + (relayout ? "_relayout" : "_cached");
+
+        juce::NamedValueSet values;
+        values.set("state", state.name);
+        values.set("staticLayers", relayout ? "relayout" : "cached");
+        values.set("width", editor.getWidth());
+        values.set("height", editor.getHeight());
+        values.set("frames", (int)frameMs.size());
+        values.set("msPerFrame", median);
+        values.set("msPerFrameP95", p95);
+        values.set("msPerFrameMax", sorted.back());
+
+        std::cout << key << ": " << juce::String(median, 3) << " ms/Frame (p95 "
+                  << juce::String(p95, 3) << " ms)\n";
+
+        // Zeit je draw*-Funktion pro Frame (inklusive verschachtelter Aufrufe)
+        std::map<juce::String, double> perFunction;
+        for (int i = 0; i < profiler.getNumEntries(); ++i)
+        {
+            const auto& entry = profiler.getEntry(i);
+            perFunction[entry.name] = entry.totalMs / (double)frameMs.size();
+        }
+
+        for (const auto& [name, ms] : perFunction)
+        {
+            values.set(juce::Identifier("ms." + name), ms);
+            std::cout << "    " << name.paddedRight(' ', 26) << juce::String(ms, 4) << " ms\n";
+        }
+
+        report.add(key, values);
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: MasteringEQGuiBench [options]\n"
+            << "\n"
+            << "  --frames=<n>         gemessene Frames je Zustand (Standard: 300)\n"
+            << "  --size=<w>x<h>       Editorgröße (Standard: Startgröße)\n"
+            << "  --json=<file>        Ergebnisse als JSON schreiben\n"
+            << "  --baseline=<file>    mit früherem JSON vergleichen (ms/Frame)\n"
+            << "  --tolerance=<pct>    Rauschgrenze für den Vergleich (Standard: 5)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit; // Editor braucht MessageManager und Desktop
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Options options;
+
+    if (args.containsOption("--frames"))
+        options.frames = juce::jmax(1, args.getValueForOption("--frames").getIntValue());
+
+    if (args.containsOption("--size"))
+    {
+        const auto size = args.getValueForOption("--size");
+        options.width = size.upToFirstOccurrenceOf("x", false, true).getIntValue();
+        options.height = size.fromFirstOccurrenceOf("x", false, true).getIntValue();
+    }
+
+    BenchmarkReport report("guiRender");
+
+    for (const auto& state : kStates)
+        for (const bool relayout : { false, true })
+            runState(state, relayout, options, report);
+
+    return report.finish(args, "msPerFrame", true);
+}
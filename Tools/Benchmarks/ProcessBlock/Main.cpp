@@ -0,0 +1,245 @@
+﻿#include "../BenchmarkReport.h"
+#include "../BenchmarkUtils.h"
+#include "../../../Source/PluginProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+//==============================================================================
+// MasteringEQProcessBench: ns/Sample von processBlock() über ein Raster aus
+// Blockgröße, Samplerate, Kanälen, Band-Einstellung und Automation.
+//
+//   MasteringEQProcessBench --json=nachher.json --baseline=vorher.json
+//
+// Gemessen wird die ganze Host-Schleife pro Block: Eingang kopieren,
+// (bei Automation) Parameter setzen, processBlock(). ns/Sample bezieht sich
+// auf Sample-Frames, also unabhängig von der Kanalzahl.
+namespace
+{
+    struct Case
+    {
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        bool activeBands = false;   // false = alle Bänder 0 dB
+        bool automated = false;     // true = Gains und Qs ändern sich jeden Block
+
+        juce::String getKey() const
+        {
+            return "b" + juce::String(blockSize) + "_sr" + juce::String((int)sampleRate)
+                 + "_ch" + juce::String(numChannels) + (activeBands ? "_active" : "_unity")
+                 + (automated ? "_automated" : "_static");
+        }
+    };
+
+    struct Options
+    {
+        juce::Array<int> blockSizes{ 1, 16, 64, 256, 1024, 4096 };
+        juce::Array<double> sampleRates{ 44100.0, 48000.0, 96000.0, 192000.0 };
+        juce::Array<int> channelCounts{ 1, 2, 6 };
+        int repetitions = 5;
+        int samplesPerRepetition = 1 << 16;
+    };
+
+    //==============================================================================
+    // Band-Parameter, einmal vor der Messung nachgeschlagen: im gemessenen Teil
+    // soll nur der Host-Weg (setValueNotifyingHost) kosten, keine String-Suche
+    struct BandParameters
+    {
+        explicit BandParameters(AudioPluginAudioProcessor& processor)
+        {
+            auto get = [&](const juce::String& id)
+                {
+                    auto* p = dynamic_cast<juce::RangedAudioParameter*>(processor.apvts.getParameter(id));
+                    jassert(p != nullptr);
+                    return p;
+                };
+
+            for (int i = 0; i < 31; ++i)
+            {
+                gains[(size_t)i] = get("band" + juce::String(i));
+                qs[(size_t)i] = get("bandQ" + juce::String(i));
+                defaultQs[(size_t)i] = qs[(size_t)i]->convertFrom0to1(qs[(size_t)i]->getDefaultValue());
+            }
+        }
+
+        // Aktiv: abwechselnd +-6 dB; Automation moduliert Gain und Q je Block
+        void apply(const Case& c, int blockIndex)
+        {
+            for (int i = 0; i < 31; ++i)
+            {
+                float gain = c.activeBands ? ((i % 2 == 0) ? 6.0f : -6.0f) : 0.0f;
+                float q = defaultQs[(size_t)i];
+
+                if (c.automated)
+                {
+                    const float phase = 0.05f * (float)blockIndex + 0.2f * (float)i;
+                    gain += 3.0f * std::sin(phase);
+                    q *= 1.0f + 0.3f * std::cos(phase);
+                }
+
+                BenchmarkUtils::setParameter(*gains[(size_t)i], gain);
+                BenchmarkUtils::setParameter(*qs[(size_t)i], q);
+            }
+        }
+
+        std::array<juce::RangedAudioParameter*, 31> gains{};
+        std::array<juce::RangedAudioParameter*, 31> qs{};
+        std::array<float, 31> defaultQs{};
+    };
+
+    //==============================================================================
+    // Eine Konfiguration messen: Median über die Wiederholungen
+    bool runCase(const Case& c, const Options& options, juce::NamedValueSet& values)
+    {
+        AudioPluginAudioProcessor processor;
+
+        // Nicht unterstützte Layouts (z.B. Surround) lehnt das Plugin ab
+        const auto channelSet = juce::AudioChannelSet::canonicalChannelSet(c.numChannels);
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+
+        if (channelSet.isDisabled() || !processor.checkBusesLayoutSupported(layout) || !processor.setBusesLayout(layout))
+            return false;
+
+        processor.setRateAndBufferSizeDetails(c.sampleRate, c.blockSize);
+        processor.prepareToPlay(c.sampleRate, c.blockSize);
+
+        BandParameters parameters(processor);
+        parameters.apply(c, 0);
+
+        // Weißes Rauschen bei -12 dBFS (IIR-Kosten sind signalunabhängig)
+        juce::AudioBuffer<float> source(c.numChannels, options.samplesPerRepetition);
+        juce::Random random(0x4d45);
+        for (int ch = 0; ch < c.numChannels; ++ch)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample(ch, i, 0.25f * (random.nextFloat() * 2.0f - 1.0f));
+
+        juce::AudioBuffer<float> buffer(c.numChannels, c.blockSize);
+        juce::MidiBuffer midi;
+        int blockIndex = 0;
+
+        auto runSamples = [&](int numSamples)
+        {
+            for (int pos = 0; pos < numSamples; pos += c.blockSize)
+            {
+                const int n = juce::jmin(c.blockSize, numSamples - pos);
+                buffer.setSize(c.numChannels, n, false, false, true);
+
+                for (int ch = 0; ch < c.numChannels; ++ch)
+                    buffer.copyFrom(ch, 0, source, ch, pos % (source.getNumSamples() - n + 1), n);
+
+                if (c.automated)
+                    parameters.apply(c, ++blockIndex);
+
+                processor.processBlock(buffer, midi);
+            }
+        };
+
+        // Aufwärmen: Caches, Filterzustände, erste Koeffizienten-Updates
+        runSamples(juce::jmin(options.samplesPerRepetition, 8192));
+
+        std::vector<double> nsPerSample;
+        for (int r = 0; r < options.repetitions; ++r)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            runSamples(options.samplesPerRepetition);
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            nsPerSample.push_back(1.0e9 * seconds / options.samplesPerRepetition);
+        }
+
+        processor.releaseResources();
+
+        std::sort(nsPerSample.begin(), nsPerSample.end());
+        const double median = nsPerSample[nsPerSample.size() / 2];
+
+        values.set("blockSize", c.blockSize);
+        values.set("sampleRate", c.sampleRate);
+        values.set("channels", c.numChannels);
+        values.set("bands", c.activeBands ? "active" : "unity");
+        values.set("automation", c.automated ? "automated" : "static");
+        values.set("nsPerSample", median);
+        values.set("nsPerSampleMin", nsPerSample.front());
+        values.set("nsPerSampleMax", nsPerSample.back());
+        values.set("realtimeFactor", 1.0e9 / (median * c.sampleRate));
+        return true;
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: MasteringEQProcessBench [options]\n"
+            << "\n"
+            << "  --blocks=<liste>     Blockgrößen (Standard: 1,16,64,256,1024,4096)\n"
+            << "  --rates=<liste>      Sampleraten (Standard: 44100,48000,96000,192000)\n"
+            << "  --channels=<liste>   Kanalzahlen (Standard: 1,2,6)\n"
+            << "  --reps=<n>           Wiederholungen je Fall (Standard: 5, Median zählt)\n"
+            << "  --samples=<n>        Samples je Wiederholung (Standard: 65536)\n"
+            << "  --json=<file>        Ergebnisse als JSON schreiben\n"
+            << "  --baseline=<file>    mit früherem JSON vergleichen\n"
+            << "  --tolerance=<pct>    Rauschgrenze für den Vergleich (Standard: 5)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit; // Processor braucht einen MessageManager
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Options options;
+
+    if (args.containsOption("--blocks"))
+        options.blockSizes = BenchmarkUtils::parseList<int>(args.getValueForOption("--blocks"));
+
+    if (args.containsOption("--rates"))
+        options.sampleRates = BenchmarkUtils::parseList<double>(args.getValueForOption("--rates"));
+
+    if (args.containsOption("--channels"))
+        options.channelCounts = BenchmarkUtils::parseList<int>(args.getValueForOption("--channels"));
+
+    if (args.containsOption("--reps"))
+        options.repetitions = juce::jmax(1, args.getValueForOption("--reps").getIntValue());
+
+    if (args.containsOption("--samples"))
+        options.samplesPerRepetition = juce::jmax(4096, args.getValueForOption("--samples").getIntValue());
+
+    BenchmarkReport report("processBlock");
+
+    for (const int blockSize : options.blockSizes)
+        for (const double sampleRate : options.sampleRates)
+            for (const int numChannels : options.channelCounts)
+                for (const bool activeBands : { false, true })
+                    for (const bool automated : { false, true })
+                    {
+                        Case c;
+                        c.blockSize = juce::jlimit(1, options.samplesPerRepetition, blockSize);
+                        c.sampleRate = sampleRate;
+                        c.numChannels = numChannels;
+                        c.activeBands = activeBands;
+                        c.automated = automated;
+
+                        juce::NamedValueSet values;
+                        if (!runCase(c, options, values))
+                        {
+                            std::cout << c.getKey() << ": Layout nicht unterstützt, übersprungen\n";
+                            continue;
+                        }
+
+                        std::cout << c.getKey() << ": " << juce::String((double)values["nsPerSample"], 2)
+                                  << " ns/Sample (" << juce::String((double)values["realtimeFactor"], 0) << "x Echtzeit)\n";
+
+                        report.add(c.getKey(), values);
+                    }
+
+    // Exit-Code für CI: Regression = 2
+    return report.finish(args, "nsPerSample", true);
+}
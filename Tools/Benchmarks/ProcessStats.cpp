@@ -0,0 +1,119 @@
+﻿#include "ProcessStats.h"
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+ #include <psapi.h>
+ #include <tlhelp32.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+ #include <sys/resource.h>
+#else
+ #include <sys/resource.h>
+ #include <unistd.h>
+#endif
+
+namespace ProcessStats
+{
+   #if JUCE_LINUX || JUCE_BSD
+    namespace
+    {
+        // "Threads:" aus /proc/self/status
+        juce::String readProcStatusField(const char* field)
+        {
+            const auto lines = juce::StringArray::fromLines(juce::File("/proc/self/status").loadFileAsString());
+
+            for (const auto& line : lines)
+                if (line.startsWith(field))
+                    return line.fromFirstOccurrenceOf(":", false, false).trim();
+
+            return {};
+        }
+    }
+   #endif
+
+    //==============================================================================
+    juce::int64 getResidentBytes()
+    {
+       #if JUCE_WINDOWS
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return (juce::int64)counters.WorkingSetSize;
+        return -1;
+       #elif JUCE_MAC
+        mach_task_basic_info info{};
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+            return (juce::int64)info.resident_size;
+        return -1;
+       #elif JUCE_LINUX || JUCE_BSD
+        // statm: Gesamt- und Resident-Seiten
+        const auto fields = juce::StringArray::fromTokens(juce::File("/proc/self/statm").loadFileAsString(), false);
+        if (fields.size() < 2)
+            return -1;
+
+        return fields[1].getLargeIntValue() * (juce::int64)sysconf(_SC_PAGESIZE);
+       #else
+        return -1;
+       #endif
+    }
+
+    int getThreadCount()
+    {
+       #if JUCE_WINDOWS
+        const DWORD pid = GetCurrentProcessId();
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot == INVALID_HANDLE_VALUE)
+            return -1;
+
+        int count = 0;
+        THREADENTRY32 entry{};
+        entry.dwSize = sizeof(entry);
+
+        for (BOOL ok = Thread32First(snapshot, &entry); ok; ok = Thread32Next(snapshot, &entry))
+            if (entry.th32OwnerProcessID == pid)
+                ++count;
+
+        CloseHandle(snapshot);
+        return count;
+       #elif JUCE_MAC
+        thread_act_array_t threads = nullptr;
+        mach_msg_type_number_t count = 0;
+        if (task_threads(mach_task_self(), &threads, &count) != KERN_SUCCESS)
+            return -1;
+
+        for (mach_msg_type_number_t i = 0; i < count; ++i)
+            mach_port_deallocate(mach_task_self(), threads[i]);
+
+        vm_deallocate(mach_task_self(), (vm_address_t)threads, count * sizeof(thread_act_t));
+        return (int)count;
+       #elif JUCE_LINUX || JUCE_BSD
+        const auto value = readProcStatusField("Threads:");
+        return value.isNotEmpty() ? value.getIntValue() : -1;
+       #else
+        return -1;
+       #endif
+    }
+
+    double getCpuSeconds()
+    {
+       #if JUCE_WINDOWS
+        FILETIME created, exited, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user))
+            return -1.0;
+
+        auto toSeconds = [](const FILETIME& t)
+            {
+                return (double)(((juce::uint64)t.dwHighDateTime << 32) | t.dwLowDateTime) * 1.0e-7;
+            };
+
+        return toSeconds(kernel) + toSeconds(user);
+       #else
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return -1.0;
+
+        auto toSeconds = [](const timeval& t) { return (double)t.tv_sec + 1.0e-6 * (double)t.tv_usec; };
+        return toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime);
+       #endif
+    }
+}
@@ -0,0 +1,19 @@
+﻿#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+// Prozessweite Kennzahlen des Betriebssystems (für Last-Benchmarks)
+//
+// Jede Funktion liefert -1, wenn die Plattform den Wert nicht hergibt.
+namespace ProcessStats
+{
+    // Aktuell belegter physischer Speicher (Resident Set) in Bytes
+    juce::int64 getResidentBytes();
+
+    // Anzahl Threads des Prozesses
+    int getThreadCount();
+
+    // Verbrauchte CPU-Zeit (User + System, alle Threads) in Sekunden
+    double getCpuSeconds();
+}
@@ -0,0 +1,242 @@
+﻿#include "../BenchmarkReport.h"
+#include "../../../Source/ReferenceAnalysis.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <iostream>
+
+//==============================================================================
+// MasteringEQAnalysisBench: Durchsatz der Referenz-Analyse (Track laden)
+//
+//   MasteringEQAnalysisBench                       synthetische Dateien
+//   MasteringEQAnalysisBench --json=a.json track1.flac track2.wav ...
+//
+// Ohne Dateien werden Testsignale in mehreren Formaten, Längen und
+// Kanalzahlen erzeugt (und im Cache-Ordner wiederverwendet).
+namespace
+{
+    struct SyntheticFile
+    {
+        const char* extension;
+        int bitDepth;
+        int numChannels;
+        int seconds;
+    };
+
+    // Formate x Kanäle x Längen, jeweils bei 48 kHz
+    constexpr SyntheticFile kSyntheticFiles[] = {
+        { ".wav",  16, 2, 10 },
+        { ".wav",  16, 2, 60 },
+        { ".wav",  16, 2, 300 },
+        { ".wav",  24, 1, 60 },
+        { ".wav",  24, 2, 60 },
+        { ".aiff", 16, 2, 60 },
+        { ".flac", 16, 2, 60 },
+        { ".flac", 24, 2, 300 },
+    };
+
+    constexpr double kSyntheticSampleRate = 48000.0;
+
+    //==============================================================================
+    // Musikähnliches Testsignal: rosa-artiges Rauschen (gestaffelte Tiefpässe)
+    // plus langsam wandernder Sinus, damit die Bandpegel über die Zeit streuen
+    bool writeSyntheticFile(juce::AudioFormatManager& formats, const juce::File& file, const SyntheticFile& spec)
+    {
+        auto* format = formats.findFormatForFileExtension(spec.extension);
+        if (format == nullptr)
+            return false;
+
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+        if (stream == nullptr)
+            return false;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), kSyntheticSampleRate,
+            (unsigned int)spec.numChannels, spec.bitDepth, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // gehört jetzt dem Writer
+
+        constexpr int blockSize = 4096;
+        juce::AudioBuffer<float> buffer(spec.numChannels, blockSize);
+        juce::Random random(0x52454641);
+
+        std::array<float, 4> lowpass{};
+        constexpr std::array<float, 4> coeffs{ 0.002f, 0.02f, 0.15f, 0.6f };
+        double phase = 0.0;
+
+        const juce::int64 total = (juce::int64)(spec.seconds * kSyntheticSampleRate);
+
+        for (juce::int64 pos = 0; pos < total; pos += blockSize)
+        {
+            const int n = (int)juce::jmin<juce::int64>(blockSize, total - pos);
+            buffer.setSize(spec.numChannels, n, false, false, true);
+
+            for (int i = 0; i < n; ++i)
+            {
+                const float white = random.nextFloat() * 2.0f - 1.0f;
+                float noise = 0.0f;
+
+                for (size_t k = 0; k < lowpass.size(); ++k)
+                {
+                    lowpass[k] += coeffs[k] * (white - lowpass[k]);
+                    noise += lowpass[k];
+                }
+
+                const double t = (double)(pos + i) / kSyntheticSampleRate;
+                const double freq = 200.0 * std::pow(2.0, 3.0 * (0.5 + 0.5 * std::sin(0.1 * t)));
+                phase += juce::MathConstants<double>::twoPi * freq / kSyntheticSampleRate;
+
+                const float s = 0.2f * noise + 0.1f * (float)std::sin(phase);
+
+                for (int ch = 0; ch < spec.numChannels; ++ch)
+                    buffer.setSample(ch, i, ch == 0 ? s : 0.9f * s);
+            }
+
+            if (!writer->writeFromAudioSampleBuffer(buffer, 0, n))
+                return false;
+        }
+
+        return true;
+    }
+
+    juce::Array<juce::File> prepareSyntheticFiles(const juce::File& directory)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        juce::Array<juce::File> files;
+        directory.createDirectory();
+
+        for (const auto& spec : kSyntheticFiles)
+        {
+            const auto file = directory.getChildFile("synthetic_" + juce::String(spec.seconds) + "s_"
+                + juce::String(spec.numChannels) + "ch_" + juce::String(spec.bitDepth) + "bit" + spec.extension);
+
+            if (!file.existsAsFile())
+            {
+                std::cout << "Erzeuge " << file.getFileName() << "\n";
+
+                if (!writeSyntheticFile(formats, file, spec))
+                {
+                    std::cerr << "Konnte " << file.getFullPathName() << " nicht schreiben\n";
+                    file.deleteFile();
+                    continue;
+                }
+            }
+
+            files.add(file);
+        }
+
+        return files;
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: MasteringEQAnalysisBench [options] [audio files...]\n"
+            << "\n"
+            << "  --cache=<dir>        Ordner für synthetische Dateien (Standard: Temp)\n"
+            << "  --reps=<n>           Wiederholungen je Datei (Standard: 3, schnellste zählt)\n"
+            << "  --json=<file>        Ergebnisse als JSON schreiben\n"
+            << "  --baseline=<file>    mit früherem JSON vergleichen (Echtzeitfaktor)\n"
+            << "  --tolerance=<pct>    Rauschgrenze für den Vergleich (Standard: 5)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    juce::Array<juce::File> files;
+    for (const auto& arg : args.arguments)
+        if (!arg.isOption())
+            files.add(arg.resolveAsFile());
+
+    if (files.isEmpty())
+    {
+        const auto cache = args.containsOption("--cache")
+            ? juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--cache").unquoted())
+            : juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("MasteringEQAnalysisBench");
+
+        files = prepareSyntheticFiles(cache);
+    }
+
+    const int repetitions = args.containsOption("--reps") ? juce::jmax(1, args.getValueForOption("--reps").getIntValue()) : 3;
+
+    BenchmarkReport report("referenceAnalysis");
+    int failed = 0;
+
+    for (const auto& file : files)
+    {
+        // Schnellster Lauf zählt (Dateicache warm, wenig Störung)
+        ReferenceAnalysis::AnalysisStats best;
+        double bestSeconds = 0.0;
+        bool ok = true;
+
+        for (int r = 0; r < repetitions && ok; ++r)
+        {
+            ReferenceAnalysis::AnalysisStats stats;
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            ok = !ReferenceAnalysis::analyseFile(file, &stats).empty();
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            if (ok && (r == 0 || seconds < bestSeconds))
+            {
+                best = stats;
+                bestSeconds = seconds;
+            }
+        }
+
+        if (!ok || bestSeconds <= 0.0)
+        {
+            std::cerr << file.getFullPathName() << ": nicht lesbar\n";
+            ++failed;
+            continue;
+        }
+
+        const double audioSeconds = best.sampleRate > 0.0 ? (double)best.numSamples / best.sampleRate : 0.0;
+        const double megabytes = (double)file.getSize() / (1024.0 * 1024.0);
+
+        juce::NamedValueSet values;
+        values.set("file", file.getFileName());
+        values.set("format", file.getFileExtension().trimCharactersAtStart(".").toLowerCase());
+        values.set("channels", best.numChannels);
+        values.set("sampleRate", best.sampleRate);
+        values.set("audioSeconds", audioSeconds);
+        values.set("fileMB", megabytes);
+        values.set("frames", best.numFrames);
+        values.set("totalSeconds", bestSeconds);
+        values.set("realtimeFactor", audioSeconds / bestSeconds);
+        values.set("mbPerSecond", megabytes / bestSeconds);
+        values.set("decodeSeconds", best.decodeSeconds);
+        values.set("monoSumSeconds", best.monoSumSeconds);
+        values.set("windowSeconds", best.windowSeconds);
+        values.set("fftSeconds", best.fftSeconds);
+        values.set("bandSeconds", best.bandSeconds);
+        values.set("percentileSeconds", best.percentileSeconds);
+        values.set("bandValueBytes", (juce::int64)best.bandValueBytes);
+
+        std::cout << file.getFileName() << ": " << juce::String(audioSeconds / bestSeconds, 1) << "x Echtzeit, "
+                  << juce::String(megabytes / bestSeconds, 1) << " MB/s, Band-Werte "
+                  << juce::String((double)best.bandValueBytes / 1024.0, 0) << " KiB\n"
+                  << "    Dekodieren " << juce::String(1000.0 * best.decodeSeconds, 1)
+                  << " ms, Mono " << juce::String(1000.0 * best.monoSumSeconds, 1)
+                  << " ms, Fenster " << juce::String(1000.0 * best.windowSeconds, 1)
+                  << " ms, FFT " << juce::String(1000.0 * best.fftSeconds, 1)
+                  << " ms, Bänder " << juce::String(1000.0 * best.bandSeconds, 1)
+                  << " ms, Perzentile " << juce::String(1000.0 * best.percentileSeconds, 1) << " ms\n";
+
+        report.add(file.getFileName(), values);
+    }
+
+    const int result = report.finish(args, "realtimeFactor", false);
+    return result != 0 ? result : (failed == 0 ? 0 : 1);
+}
@@ -0,0 +1,338 @@
+﻿#include "../BenchmarkReport.h"
+#include "../ProcessStats.h"
+#include "../../../Source/PluginProcessor.h"
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+//==============================================================================
+// MasteringEQSessionBench: viele Instanzen wie in einer Mastering-Session
+//
+//   MasteringEQSessionBench --instances=16,64,256 --block=256 --threads=4 --editors
+//
+// Pro Lauf werden N Processor (optional mit Editor) erzeugt und wie von
+// einem Host im Callback-Takt verarbeitet: jeder Zyklus verteilt alle
+// Instanzen auf die Audio-Threads und wartet, bis alle fertig sind.
+// Speicher wird als Differenz des Resident Set gemessen; am genauesten
+// mit einer Instanzzahl pro Prozessaufruf (der Allocator hält Speicher).
+namespace
+{
+    struct Options
+    {
+        juce::Array<int> instanceCounts{ 16, 64, 256 };
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        int numThreads = 1;
+        double audioSeconds = 10.0;
+        bool editors = false;
+        bool realtime = false;      // Zyklen im Echtzeittakt statt so schnell wie möglich
+    };
+
+    //==============================================================================
+    // Wiederverwendbare Barriere für Host-Zyklen (C++17 hat kein std::barrier)
+    class CycleBarrier
+    {
+    public:
+        explicit CycleBarrier(int numParties) : parties(numParties) {}
+
+        void arriveAndWait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const auto currentGeneration = generation;
+
+            if (++waiting == parties)
+            {
+                waiting = 0;
+                ++generation;
+                condition.notify_all();
+                return;
+            }
+
+            condition.wait(lock, [&] { return generation != currentGeneration; });
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        const int parties;
+        int waiting = 0;
+        juce::uint64 generation = 0;
+    };
+
+    struct Track
+    {
+        std::unique_ptr<AudioPluginAudioProcessor> processor;
+        std::unique_ptr<juce::AudioProcessorEditor> editor;
+        juce::AudioBuffer<float> buffer;
+    };
+
+    double msSince(juce::int64 startTicks)
+    {
+        return 1000.0 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+    //==============================================================================
+    void runSession(int numInstances, const Options& options, BenchmarkReport& report)
+    {
+        const auto rssBefore = ProcessStats::getResidentBytes();
+        const int threadsBefore = ProcessStats::getThreadCount();
+
+        std::vector<Track> tracks((size_t)numInstances);
+        std::vector<double> processorMs, editorMs;
+
+        // Erzeugen auf dem Message-Thread, wie im Host
+        for (auto& track : tracks)
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+            track.processor = std::make_unique<AudioPluginAudioProcessor>();
+            processorMs.push_back(msSince(start));
+
+            if (options.editors)
+            {
+                start = juce::Time::getHighResolutionTicks();
+                track.editor.reset(track.processor->createEditor());
+                editorMs.push_back(msSince(start));
+            }
+        }
+
+        const auto rssConstructed = ProcessStats::getResidentBytes();
+
+        for (auto& track : tracks)
+        {
+            track.processor->setPlayConfigDetails(2, 2, options.sampleRate, options.blockSize);
+            track.processor->prepareToPlay(options.sampleRate, options.blockSize);
+            track.buffer.setSize(2, options.blockSize);
+        }
+
+        const auto rssPrepared = ProcessStats::getResidentBytes();
+        const int threadsIdle = ProcessStats::getThreadCount();
+
+        // Gemeinsames Eingangssignal, jede Spur kopiert es in ihren eigenen Puffer
+        juce::AudioBuffer<float> source(2, options.blockSize * 64);
+        juce::Random random(0x53455353);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample(ch, i, 0.2f * (random.nextFloat() * 2.0f - 1.0f));
+
+        const int numThreads = juce::jlimit(1, numInstances, options.numThreads);
+        const int numCycles = juce::jmax(1, (int)(options.audioSeconds * options.sampleRate / options.blockSize));
+        const double deadlineMs = 1000.0 * options.blockSize / options.sampleRate;
+
+        CycleBarrier startBarrier(numThreads + 1), endBarrier(numThreads + 1);
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < numThreads; ++t)
+        {
+            workers.emplace_back([&, t]
+                {
+                    juce::MidiBuffer midi;
+
+                    for (int cycle = 0; cycle < numCycles; ++cycle)
+                    {
+                        startBarrier.arriveAndWait();
+
+                        const int offset = (cycle % 64) * options.blockSize;
+
+                        for (int i = t; i < numInstances; i += numThreads)
+                        {
+                            auto& track = tracks[(size_t)i];
+
+                            for (int ch = 0; ch < 2; ++ch)
+                                track.buffer.copyFrom(ch, 0, source, ch, offset, options.blockSize);
+
+                            track.processor->processBlock(track.buffer, midi);
+                        }
+
+                        endBarrier.arriveAndWait();
+                    }
+                });
+        }
+
+        std::vector<double> cycleMs;
+        cycleMs.reserve((size_t)numCycles);
+        int overruns = 0;
+
+        const double cpuStart = ProcessStats::getCpuSeconds();
+        const auto wallStart = juce::Time::getHighResolutionTicks();
+        int threadsRunning = -1;
+
+        for (int cycle = 0; cycle < numCycles; ++cycle)
+        {
+            if (options.realtime)
+            {
+                const double dueMs = cycle * deadlineMs;
+                const double waitMs = dueMs - msSince(wallStart);
+                if (waitMs > 1.0)
+                    juce::Thread::sleep((int)waitMs);
+            }
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            startBarrier.arriveAndWait();
+            endBarrier.arriveAndWait();
+
+            const double ms = msSince(start);
+            cycleMs.push_back(ms);
+
+            if (ms > deadlineMs)
+                ++overruns;
+
+            if (cycle == numCycles / 2)
+                threadsRunning = ProcessStats::getThreadCount();
+        }
+
+        const double wallSeconds = 0.001 * msSince(wallStart);
+        const double cpuSeconds = ProcessStats::getCpuSeconds() - cpuStart;
+
+        for (auto& worker : workers)
+            worker.join();
+
+        for (auto& track : tracks)
+            track.processor->releaseResources();
+
+        tracks.clear();
+
+        //==============================================================================
+        auto mean = [](const std::vector<double>& v)
+            {
+                return v.empty() ? 0.0 : std::accumulate(v.begin(), v.end(), 0.0) / (double)v.size();
+            };
+
+        auto maxOf = [](const std::vector<double>& v)
+            {
+                return v.empty() ? 0.0 : *std::max_element(v.begin(), v.end());
+            };
+
+        std::vector<double> sorted = cycleMs;
+        std::sort(sorted.begin(), sorted.end());
+        const double medianCycle = sorted[sorted.size() / 2];
+        const double p99Cycle = sorted[juce::jmin(sorted.size() - 1, (size_t)(0.99 * (double)sorted.size()))];
+
+        auto perInstanceKiB = [&](juce::int64 after)
+            {
+                return (rssBefore < 0 || after < 0) ? -1.0 : (double)(after - rssBefore) / 1024.0 / numInstances;
+            };
+
+        const juce::String key = "n" + juce::String(numInstances) + "_b" + juce::String(options.blockSize)
+            + "_t" + juce::String(numThreads) + (options.editors ? "_editors" : "");
+
+        juce::NamedValueSet values;
+        values.set("instances", numInstances);
+        values.set("editors", options.editors);
+        values.set("blockSize", options.blockSize);
+        values.set("sampleRate", options.sampleRate);
+        values.set("audioThreads", numThreads);
+        values.set("processorConstructMsMean", mean(processorMs));
+        values.set("processorConstructMsMax", maxOf(processorMs));
+        values.set("editorConstructMsMean", mean(editorMs));
+        values.set("editorConstructMsMax", maxOf(editorMs));
+        values.set("kibPerInstanceConstructed", perInstanceKiB(rssConstructed));
+        values.set("kibPerInstancePrepared", perInstanceKiB(rssPrepared));
+        values.set("threadsBefore", threadsBefore);
+        values.set("threadsIdle", threadsIdle);
+        values.set("threadsRunning", threadsRunning);
+        values.set("cycleMsMedian", medianCycle);
+        values.set("cycleMsP99", p99Cycle);
+        values.set("deadlineMs", deadlineMs);
+        values.set("dspLoad", medianCycle / deadlineMs);
+        values.set("overruns", overruns);
+        values.set("cpuCores", wallSeconds > 0.0 ? cpuSeconds / wallSeconds : 0.0);
+        values.set("cpuSecondsPerAudioSecondPerInstance",
+            cpuSeconds / (numCycles * options.blockSize / options.sampleRate) / numInstances);
+
+        std::cout << key << ":\n"
+                  << "    Erzeugen  " << juce::String(mean(processorMs), 3) << " ms/Processor"
+                  << (options.editors ? " + " + juce::String(mean(editorMs), 3) + " ms/Editor" : juce::String()) << "\n"
+                  << "    Speicher  " << juce::String(perInstanceKiB(rssPrepared), 0) << " KiB/Instanz (nach prepareToPlay)\n"
+                  << "    Threads   " << threadsBefore << " vorher, " << threadsIdle << " mit Instanzen, "
+                  << threadsRunning << " beim Abspielen\n"
+                  << "    Zyklus    " << juce::String(medianCycle, 3) << " ms (p99 " << juce::String(p99Cycle, 3)
+                  << " ms) von " << juce::String(deadlineMs, 3) << " ms, " << overruns << " Überläufe\n"
+                  << "    CPU       " << juce::String(cpuSeconds / wallSeconds, 2) << " Kerne\n";
+
+        report.add(key, values);
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: MasteringEQSessionBench [options]\n"
+            << "\n"
+            << "  --instances=<liste>  Instanzzahlen (Standard: 16,64,256)\n"
+            << "  --editors            zu jeder Instanz einen Editor erzeugen\n"
+            << "  --block=<n>          Puffergröße (Standard: 512)\n"
+            << "  --rate=<hz>          Samplerate (Standard: 48000)\n"
+            << "  --threads=<n>        Audio-Threads (Standard: 1)\n"
+            << "  --seconds=<s>        Audiolänge je Lauf (Standard: 10)\n"
+            << "  --realtime           Zyklen im Echtzeittakt statt so schnell wie möglich\n"
+            << "  --trace=<file>       Trace-Events aller Threads als Chrome-JSON schreiben\n"
+            << "  --json=<file>        Ergebnisse als JSON schreiben\n"
+            << "  --baseline=<file>    mit früherem JSON vergleichen (DSP-Last)\n"
+            << "  --tolerance=<pct>    Rauschgrenze für den Vergleich (Standard: 5)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit; // Processor/Editor brauchen einen MessageManager
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Options options;
+
+    if (args.containsOption("--instances"))
+    {
+        options.instanceCounts.clear();
+        for (const auto& token : juce::StringArray::fromTokens(args.getValueForOption("--instances"), ",", {}))
+            if (token.getIntValue() > 0)
+                options.instanceCounts.add(token.getIntValue());
+    }
+
+    options.editors = args.containsOption("--editors");
+    options.realtime = args.containsOption("--realtime");
+
+    if (args.containsOption("--block"))
+        options.blockSize = juce::jmax(16, args.getValueForOption("--block").getIntValue());
+
+    if (args.containsOption("--rate"))
+        options.sampleRate = juce::jmax(8000.0, args.getValueForOption("--rate").getDoubleValue());
+
+    if (args.containsOption("--threads"))
+        options.numThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+
+    if (args.containsOption("--seconds"))
+        options.audioSeconds = juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue());
+
+    BenchmarkReport report("sessionLoad");
+
+    // Ringpuffer je Thread: bei langen Läufen bleibt das Ende erhalten
+    if (args.containsOption("--trace"))
+        TraceRecorder::start(1 << 16);
+
+    for (const int numInstances : options.instanceCounts)
+        runSession(numInstances, options, report);
+
+    if (args.containsOption("--trace"))
+    {
+        TraceRecorder::stop();
+
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--trace").unquoted());
+
+        if (!TraceRecorder::writeChromeTrace(file))
+        {
+            std::cerr << "Trace nicht schreibbar: " << file.getFullPathName() << "\n";
+            return 1;
+        }
+
+        std::cout << "Trace: " << file.getFullPathName() << "\n";
+    }
+
+    return report.finish(args, "dspLoad", true);
+}